@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <climits>
 #include <iostream>
+#include <vector>
+#include "StoreStatistics.h"
+#include "MemoryAccounting.h"
+#include "InventoryStorage.h"
 
 using namespace std;
 
@@ -46,9 +52,61 @@ public:
 	}
 };
 
+// the failures of a stock change: "changeMediaStock" returns the slot of the movie changed, or one of them
+enum StockChangeFailure {
+
+	// the movie is not in the BST
+	StockMovieNotFound = -1,
+
+	// a decrement found no copy in stock
+	StockNoneLeft = -2,
+
+	// an increment found the stock at its starting stock
+	StockAtMaximum = -3
+};
+
+// a range of sort keys: the keys from {firstNumber, textPrefix} to {lastNumber, textPrefix followed
+// by any text}, compared as the keys are ordered (leading number, then first text, case sensitive).
+// comedies and dramas have no leading number (it is 0), so their ranges (from and to number 0) are
+// the titles (comedies) or directors (dramas) starting with the prefix; classics lead with their release date, so their
+// ranges are years. the default range holds every key.
+struct SortKeyRange {
+
+	int firstNumber = 0;
+	int lastNumber = INT_MAX;
+	string textPrefix;
+
+	/**
+	 * Evaluates whether a sort key precedes the range.
+	 *
+	 * @param key - The sort key
+	 *
+	 * @return Whether the key is below the range's first key
+	 */
+	bool isBelow(const MovieSortKey &key) const {
+
+		return key.leadingNumber < firstNumber || (key.leadingNumber == firstNumber && key.firstText.view() < textPrefix);
+	}
+
+	/**
+	 * Evaluates whether a sort key follows the range.
+	 *
+	 * @param key - The sort key
+	 *
+	 * @return Whether the key is above the range's last key
+	 */
+	bool isAbove(const MovieSortKey &key) const {
+
+		string_view text = key.firstText.view();
+		return key.leadingNumber > lastNumber || (key.leadingNumber == lastNumber && text > textPrefix
+			&& text.substr(0, textPrefix.size()) != textPrefix);
+	}
+};
+
 // a binary search tree with an array based implementation as underlying data structure
-// using implementation of 0-(n-1) range for array indices
-template <typename MovieType>
+// using implementation of 0-(n-1) range for array indices. the layout of the array is set by
+// the storage policy (see InventoryStorage.h): whole movie objects, or hot/cold columns.
+template <typename MovieType, typename Storage = ObjectStorage<MovieType>>
 class ArrayBasedBSTree {
 
 private:
@@ -56,8 +114,15 @@ private:
 	// default maximum size for the movie inventory (may be expanded)
 	int originalSize = 100;
 
+	// the largest supported size of the movie inventory array
+	static const int maxInventorySize = 1000;
+
 	// BST array of movies
-	MovieType *movies;
+	Storage movies;
+
+	// stock of every slot in each media format, and the codes of the formats (in stock order)
+	FormatStockTable stock;
+	string formatCodes = "D";
 
 	// maximum size of movie inventory
 	int movieInventoryMax;
@@ -65,6 +130,15 @@ private:
 	// number of movies stored in inventory
 	int currentSize = 0;
 
+	// statistics counters updated by searches and stock changes (nullptr while statistics are disabled)
+	InventoryCounters *counters = nullptr;
+
+	// availability index: the number of titles with a copy in stock in the subtree of every slot,
+	// kept as stock crosses zero (unless tracking is turned off), so "what is in stock" queries
+	// skip the subtrees holding none
+	vector<int> inStockCounts;
+	bool trackAvailability = true;
+
 	/**
  	 * Searches tree for movie argument starting from root, unless specified otherwise
  	 * 
@@ -75,16 +149,21 @@ private:
  	 * the tree as well as at what index if found or what index ought to be inserted 
  	 * into if not found.
  	 */
-	E searchTree(MovieType& movie, int index = 0) {
+	E searchTree(typename Storage::Probe& movie, int index = 0) {
+
+		if(counters != nullptr) {
 
-		if(movies[index] == movie) {
+			counters->searches += (index == 0);
+			counters->probes++;
+		}
+		if(movies.matches(index, movie)) {
 
 			E e(true, index);
  			return e;
  		}
- 		else if(movies[index] > movie) {
+ 		else if(movies.greaterThan(index, movie)) {
 
-			if(!movies[2 * index + 1].isEmpty()) {
+			if(2 * index + 1 < movieInventoryMax && !movies.isEmpty(2 * index + 1)) {
 
 				return searchTree(movie, 2 * index + 1);
 			}
@@ -96,7 +175,7 @@ private:
 		}
 		else {
 
-			if(!movies[2 * index + 2].isEmpty()) {
+			if(2 * index + 2 < movieInventoryMax && !movies.isEmpty(2 * index + 2)) {
 
 				return searchTree(movie, 2 * index + 2);
 			}
@@ -117,10 +196,24 @@ private:
  	 */
 	bool searchMediaInventory(MovieType& movie) {
 
-		E e = searchTree(movie);
+		typename Storage::Probe probe = movies.makeProbe(movie);
+		E e = searchTree(probe);
 		return e.isFound();
 	}
 
+	/**
+ 	 * Gets the slot of a movie.
+ 	 *
+ 	 * @param movie The movie to be searched
+ 	 * @return The index of the movie's slot, -1 if it is not in the BST
+ 	 */
+	int findSlot(MovieType& movie) {
+
+		typename Storage::Probe probe = movies.makeProbe(movie);
+		E e = movies.isEmpty(0) ? E(false, 0) : searchTree(probe);
+		return e.isFound() ? e.getIndex() : -1;
+	}
+
  	//bool searchAnother(MovieType &movie) {
 
  	//if() {
@@ -136,19 +229,15 @@ private:
 	bool increaseInventorySize(int additionalSpace) {
 
 		int newSize = movieInventoryMax + additionalSpace;
-		if(newSize > 1000) {
+		if(newSize > maxInventorySize) {
 
 			cout << "The requested new inventory size is above 1000. This is above the supported size: expansion failed." << endl;
 			return false;
 		}
-		MovieType *expandedInventory = new MovieType[newSize];
-		for(int i = 0; i < movieInventoryMax; i++) {
-
-			expandedInventory[i] = movies[i];
-		}
-		delete[] movies;
-		movies = expandedInventory;
-		expandedInventory = nullptr;
+		movies.resize(movieInventoryMax, newSize);
+		stock.resize(movieInventoryMax, newSize);
+		inStockCounts.resize(newSize);
+		MemoryAccounting::recordResize(MemorySubsystem::Inventory, movieInventoryMax * getSlotBytes(), newSize * getSlotBytes());
 		movieInventoryMax = newSize;
 		return true;
 	}
@@ -159,36 +248,291 @@ private:
 	 * needed for insertion was too high AND array expansion failed.
 	 * 
 	 * @param movie - Movie to be inserted
+	 * @param formatStock - The stock of the movie in every format (nullptr for the movie's stock in the first format)
+	 * @param rebalanced - Whether the tree was rebalanced for this insertion already
 	 * @return Number representing particular circumstances surrounding insertion success/failure.
 	 */
-	char InsertHelper(MovieType& movie) {
+	char InsertHelper(MovieType& movie, const int *formatStock, bool rebalanced = false) {
+
+		// a completely filled array is not an error by itself: the search below lands past the
+		// last index and the array is expanded (or fails with 2 when beyond the supported size)
+		typename Storage::Probe probe = movies.makeProbe(movie);
+		E newIndex = searchTree(probe, 0);
+		if(!(newIndex).isFound()) {
+
+			int lastCurrentArrayIndex = movieInventoryMax - 1;
+			if(newIndex.getIndex() > lastCurrentArrayIndex) {
+
+				// a leaf too deep for the supported size: rebalance the tree once and search again,
+				// a complete tree has room for new leaves much nearer the root
+				int additionalSpace = (newIndex.getIndex() - lastCurrentArrayIndex) * 5;
+				if(movieInventoryMax + additionalSpace > maxInventorySize && !rebalanced) {
 
-		if(isFull()) {
+					rebuildSubtree(0, -1);
+					return InsertHelper(movie, formatStock, true);
+				}
+
+				// the leaf fits the supported size, though the growth margin does not: grow to the limit
+				if(movieInventoryMax + additionalSpace > maxInventorySize && newIndex.getIndex() < maxInventorySize) {
 
-			return -1;
+					additionalSpace = maxInventorySize - movieInventoryMax;
+				}
+				bool increasedSize = increaseInventorySize(additionalSpace);
+				if(!increasedSize) {
+
+					return 2;
+				}
+			}
+			storeMovie(newIndex.getIndex(), movie, formatStock);
+			return 1;
 		}
 		else {
 
-			E newIndex = searchTree(movie, 0);
-			if(!(newIndex).isFound()) {
+			return 0;
+		}
+	}
 
-				int lastCurrentArrayIndex = movieInventoryMax - 1;
-				if(newIndex.getIndex() > lastCurrentArrayIndex) {
+	/**
+	 * Stores a movie and its stock in every format at an index.
+	 *
+	 * @param index - The array index
+	 * @param movie - The movie
+	 * @param formatStock - The stock of the movie in every format (nullptr for the movie's stock in the first format)
+	 */
+	void storeMovie(int index, MovieType &movie, const int *formatStock) {
 
-					bool increasedSize = increaseInventorySize((newIndex.getIndex() - lastCurrentArrayIndex) * 5);
-					if(!increasedSize) {
+		movies.store(index, movie);
+		for(int format = 0; format < stock.getFormatCount(); format++) {
 
-						return 2;
-					}
-				}
-				movies[newIndex.getIndex()] = movie;
-				return 1;
+			if(formatStock != nullptr) {
+
+				stock.set(index, format, formatStock[format]);
 			}
 			else {
 
-				return 0;
+				stock.set(index, format, format == 0 ? movie.getStock() : 0);
 			}
 		}
+
+		// a movie is stored as a leaf: its subtree is itself
+		inStockCounts[index] = 0;
+		addInStock(index, stock.inStock(index));
+	}
+
+	/**
+	 * Adds to the count of titles in stock of a slot's subtree and of every subtree holding it.
+	 * Called when a title comes in stock or goes out of stock, with the slot of the title.
+	 *
+	 * @param index - The array index
+	 * @param change - The change of the count (1 or -1, 0 for none)
+	 */
+	void addInStock(int index, int change) {
+
+		if(!trackAvailability || change == 0) {
+
+			return;
+		}
+		while(index > 0) {
+
+			inStockCounts[index] += change;
+			index = (index - 1) / 2;
+		}
+		inStockCounts[0] += change;
+	}
+
+	/**
+	 * Counts the titles in stock of the subtree rooted at a slot again, e.g. once it is rebuilt.
+	 *
+	 * @param index - The root of the subtree
+	 *
+	 * @return The number of titles in stock in the subtree
+	 */
+	int recountInStock(int index) {
+
+		if(index >= movieInventoryMax || movies.isEmpty(index)) {
+
+			return 0;
+		}
+		inStockCounts[index] = stock.inStock(index) + recountInStock(2 * index + 1) + recountInStock(2 * index + 2);
+		return inStockCounts[index];
+	}
+
+	/**
+	 * Visits the titles in stock in a range of the subtree rooted at a slot, in order. Subtrees
+	 * holding no title in stock, and those wholly outside the range, are skipped (with tracking
+	 * turned off, every title is checked, as a traversal of the whole tree).
+	 *
+	 * @param index - The root of the subtree
+	 * @param range - The range of sort keys
+	 * @param visitor - Callable taking a "const MovieType&"
+	 *
+	 * @return The number of titles visited
+	 */
+	template <typename Visitor>
+	int visitInStock(int index, const SortKeyRange &range, Visitor &visitor) {
+
+		if(index >= movieInventoryMax || movies.isEmpty(index) || (trackAvailability && inStockCounts[index] == 0)) {
+
+			return 0;
+		}
+		MovieType movie = movies.getMovie(index);
+		MovieSortKey key = movie.getSortKey();
+		bool below = range.isBelow(key);
+		bool above = range.isAbove(key);
+		int visited = below && trackAvailability ? 0 : visitInStock(2 * index + 1, range, visitor);
+		if(!below && !above && stock.inStock(index)) {
+
+			visitor(movie);
+			visited++;
+		}
+		return visited + (above && trackAvailability ? 0 : visitInStock(2 * index + 2, range, visitor));
+	}
+
+	/**
+	 * Gets the text of the movie at an index. Its stock is the stock of every format, followed by the
+	 * stock of each format when more than one is carried (e.g. "[D:10 B:4]").
+	 *
+	 * @param index - The array index
+	 *
+	 * @return The movie's text
+	 */
+	string describeMovie(int index) {
+
+		MovieType movie = movies.getMovie(index);
+		int totalStock = 0;
+		int totalStartingStock = 0;
+		string formatDetail = " [";
+		for(int format = 0; format < stock.getFormatCount(); format++) {
+
+			totalStock += stock.getStock(index, format);
+			totalStartingStock += stock.getStartingStock(index, format);
+			formatDetail += (format > 0 ? " " : "") + string(1, formatCodes[format]) + ":" + to_string(stock.getStock(index, format));
+		}
+		movie.setStockLevels(totalStock, totalStartingStock);
+		if(stock.getFormatCount() > 1) {
+
+			return movie.toString() + formatDetail + "]";
+		}
+		return movie.toString();
+	}
+
+	/**
+	 * Appends the indexes of the subtree rooted at an index to a list, in order (ascending sorting criteria).
+	 *
+	 * @param index - The root of the subtree
+	 * @param slots - The list of indexes
+	 */
+	void collectSubtree(int index, vector<int> &slots) {
+
+		if(index >= movieInventoryMax || movies.isEmpty(index)) {
+
+			return;
+		}
+		collectSubtree(2 * index + 1, slots);
+		slots.push_back(index);
+		collectSubtree(2 * index + 2, slots);
+	}
+
+	/**
+	 * Gets the size of the left subtree of a complete binary tree (every level full but the last,
+	 * which is filled from the left).
+	 *
+	 * @param count - The number of nodes of the tree
+	 *
+	 * @return The number of nodes of its left subtree
+	 */
+	static int completeLeftSize(int count) {
+
+		int levels = 0;
+		while((1 << levels) <= count) {
+
+			levels++;
+		}
+		if(levels < 2) {
+
+			return 0;
+		}
+		int fullLeftLevels = (1 << (levels - 2)) - 1;
+		int lastLevel = count - ((1 << (levels - 1)) - 1);
+		return fullLeftLevels + min(lastLevel, 1 << (levels - 2));
+	}
+
+	/**
+	 * Places movies, sorted by sorting criteria, as a complete binary tree rooted at an index.
+	 *
+	 * @param sorted - The movies
+	 * @param sortedStock - The stock of every format of each movie, in the same order
+	 * @param first - The position of the first movie of the subtree
+	 * @param count - The number of movies of the subtree
+	 * @param index - The array index of the subtree's root
+	 */
+	void placeComplete(vector<MovieType> &sorted, vector<FormatStockTable::FormatStock> &sortedStock, int first, int count, int index) {
+
+		if(count == 0) {
+
+			return;
+		}
+		int leftSize = completeLeftSize(count);
+		int middle = first + leftSize;
+		movies.store(index, sorted[middle]);
+		stock.restoreSlot(index, sortedStock, middle * stock.getFormatCount());
+		placeComplete(sorted, sortedStock, first, leftSize, 2 * index + 1);
+		placeComplete(sorted, sortedStock, middle + 1, count - leftSize - 1, 2 * index + 2);
+	}
+
+	/**
+	 * Takes the movies of the subtree rooted at an index out of the tree, in order, with their stock.
+	 *
+	 * @param index - The root of the subtree
+	 * @param removed - An index of the subtree whose movie is discarded (-1 for none)
+	 * @param sorted - The movies taken out, appended to
+	 * @param sortedStock - The stock of every format of each movie taken out, appended to
+	 */
+	void takeSubtree(int index, int removed, vector<MovieType> &sorted, vector<FormatStockTable::FormatStock> &sortedStock) {
+
+		vector<int> slots;
+		collectSubtree(index, slots);
+		for(size_t i = 0; i < slots.size(); i++) {
+
+			if(slots[i] != removed) {
+
+				sorted.push_back(movies.getMovie(slots[i]));
+				stock.copySlot(slots[i], sortedStock);
+			}
+			movies.clear(slots[i]);
+			stock.clear(slots[i]);
+		}
+	}
+
+	/**
+	 * Rebuilds the subtree rooted at an index as a complete binary tree. The array cannot relink
+	 * nodes, so this is how a node is removed: the subtree below it is laid out again without it.
+	 * A complete layout of a subtree's movies only uses slots the subtree already reached, so the
+	 * array never needs to grow.
+	 *
+	 * @param index - The root of the subtree
+	 * @param removed - An index of the subtree whose movie is removed (-1 for none)
+	 */
+	void rebuildSubtree(int index, int removed) {
+
+		vector<MovieType> sorted;
+		vector<FormatStockTable::FormatStock> sortedStock;
+		int inStockBefore = trackAvailability ? inStockCounts[index] : 0;
+		takeSubtree(index, removed, sorted, sortedStock);
+		placeComplete(sorted, sortedStock, 0, sorted.size(), index);
+		if(trackAvailability) {
+
+			// the subtree's count changes by the removed title, if it was in stock
+			int change = recountInStock(index) - inStockBefore;
+			addInStock(index, change);
+			inStockCounts[index] -= change;
+		}
+	}
+
+	// gets the bytes of a slot (movie storage, stock of every format and count of titles in stock)
+	long long getSlotBytes() {
+
+		return Storage::getSlotBytes() + stock.getSlotBytes() + sizeof(int);
 	}
 
 	/**
@@ -198,15 +542,15 @@ private:
  	 */
  	void inorderTraversalHelper(int index) {
 
-		if(2 * index + 1 < movieInventoryMax && !movies[2 * index + 1].isEmpty()) {
+		if(2 * index + 1 < movieInventoryMax && !movies.isEmpty(2 * index + 1)) {
 
 			inorderTraversalHelper(2 * index + 1);
 		}
-		if(index < movieInventoryMax && !movies[index].isEmpty()) {
+		if(index < movieInventoryMax && !movies.isEmpty(index)) {
 
-			cout << movies[index] << endl;
+			cout << describeMovie(index) << endl << endl;
 		}
-		if(2 * index + 2 < movieInventoryMax && !movies[2 * index + 2].isEmpty()) {
+		if(2 * index + 2 < movieInventoryMax && !movies.isEmpty(2 * index + 2)) {
 
 			inorderTraversalHelper(2 * index + 2);
 		}
@@ -219,17 +563,19 @@ public:
  	 */
  	ArrayBasedBSTree() {
 
-		movies = new MovieType[originalSize];
+		movies.resize(0, originalSize);
+		stock.resize(0, originalSize);
+		inStockCounts.resize(originalSize);
 		movieInventoryMax = originalSize;
+		MemoryAccounting::recordAllocation(MemorySubsystem::Inventory, originalSize * getSlotBytes());
 	}
 
  	/**
- 	 * Delete BST array and set to nullptr.
+ 	 * Destructor. The BST array is deleted by the storage.
  	 */
  	~ArrayBasedBSTree() {
 
- 		delete[] movies;
- 		movies = nullptr;
+ 		MemoryAccounting::recordFree(MemorySubsystem::Inventory, movieInventoryMax * getSlotBytes());
  	}
 
  	/**
@@ -242,7 +588,7 @@ public:
  		int size = 0;
  		for(int i = 0; i < movieInventoryMax; i++) {
 
- 			if(!movies[i].isEmpty()) {
+ 			if(!movies.isEmpty(i)) {
 
  				size++;
  				continue;
@@ -253,40 +599,59 @@ public:
  	}
 
  	/**
- 	 * Change stock of a given argument movie in BST.
+ 	 * Change stock of a given argument movie in BST. Failures are not printed; the caller reports them.
  	 * 
  	 * @param movie - The movie having its stock altered.
  	 * @param incOrDec - The direction stock ought change (true if decrementing, false if incrementing)
+ 	 * @param format - The index of the media format whose stock changes
  	 *
- 	 * @return The success status of the specified stock change
+ 	 * @return The slot of the movie whose stock changed, or the failure of the stock change (see StockChangeFailure)
  	 */
- 	bool changeMediaStock(MovieType &movie, bool incOrDec) {
+ 	int changeMediaStock(MovieType &movie, bool incOrDec, int format = 0) {
 
-		E e = searchTree(movie, 0);
+		typename Storage::Probe probe = movies.makeProbe(movie);
+		E e = searchTree(probe, 0);
 		if(e.isFound()) {
 
-			MovieType *foundMovie = &movies[e.getIndex()];
  			if(incOrDec) {
 
- 				if(foundMovie->incrementStock()) {
+ 				if(stock.incrementStock(e.getIndex(), format)) {
 
- 					return true;
+ 					// the title comes back in stock when its first copy in any format is returned
+ 					if(stock.getStock(e.getIndex(), format) == 1 && stock.getFormatsInStock(e.getIndex()) == 1) {
+
+ 						addInStock(e.getIndex(), 1);
+ 					}
+ 					return e.getIndex();
  				}
- 				cout << "Return failed: stock for this movie is already at maximum." << endl;
- 				return false;
+ 				if(counters != nullptr) {
+
+ 					counters->stockAtMaximum++;
+ 				}
+ 				return StockAtMaximum;
  			}
  			else {
 
- 				if(foundMovie->decrementStock()) {
+ 				if(stock.decrementStock(e.getIndex(), format)) {
 
- 					return true;
+ 					if(stock.getStock(e.getIndex(), format) == 0 && !stock.inStock(e.getIndex())) {
+
+ 						addInStock(e.getIndex(), -1);
+ 					}
+ 					return e.getIndex();
  				}
- 				cout << "Borrow failed for movie with sorting criteria - " << movie.getSortingCriteria() << ": there is no stock for this movie at the moment." << endl;
- 				return false;
+ 				if(counters != nullptr) {
+
+ 					counters->outOfStock++;
+ 				}
+ 				return StockNoneLeft;
  			}
  		}
- 		cout << "The movie with sorting criteria: " << movie.getSortingCriteria() << " was not found within the inventory." << endl;
- 		return false;
+ 		if(counters != nullptr) {
+
+ 			counters->notFound++;
+ 		}
+ 		return StockMovieNotFound;
  	}
 
  	/**
@@ -294,14 +659,15 @@ public:
 	 * empty, invoke helper, if so, assign value to argument movie. Print out 
 	 * circumstances of search, if helper invoked.
  	 * @param movie - The movie to be inserted into BST
+ 	 * @param formatStock - The stock of the movie in every format (nullptr for the movie's stock in the first format)
  	 *
  	 * @return The success status of the insertion
  	 */
- 	bool Insert(MovieType& movie) {
+ 	bool Insert(MovieType& movie, const int *formatStock = nullptr) {
 
- 		if(!movies[0].isEmpty()) {
+ 		if(!movies.isEmpty(0)) {
 
- 			char insertSucceeded = InsertHelper(movie);
+ 			char insertSucceeded = InsertHelper(movie, formatStock);
  			switch(insertSucceeded) {
 
  				case -1:
@@ -325,12 +691,414 @@ public:
  		}
  		else {
 
- 			movies[0] = movie;
+ 			storeMovie(0, movie, formatStock);
  			currentSize++;
  			return true;
  		}
  	}
 
+ 	/**
+ 	 * Removes a movie (and its stock in every format) from the BST. The subtree below the movie is
+ 	 * rebuilt balanced, and the whole tree is compacted once fewer than a quarter of the array's
+ 	 * slots are used.
+ 	 *
+ 	 * @param movie - The movie to be removed (only its sorting criteria are compared)
+ 	 *
+ 	 * @return The success status of the removal
+ 	 */
+ 	bool Remove(MovieType &movie) {
+
+ 		typename Storage::Probe probe = movies.makeProbe(movie);
+ 		E e = movies.isEmpty(0) ? E(false, 0) : searchTree(probe, 0);
+ 		if(!e.isFound()) {
+
+ 			cout << "The movie with sorting criteria: " << movie.getSortingCriteria() << " was not found within the inventory." << endl;
+ 			return false;
+ 		}
+ 		rebuildSubtree(e.getIndex(), e.getIndex());
+ 		currentSize--;
+ 		cout << "Successfully removed movie from the inventory. Sorting criteria is: " << movie.getSortingCriteria() << endl;
+ 		if(movieInventoryMax > originalSize && currentSize * 4 < movieInventoryMax) {
+
+ 			compact();
+ 		}
+ 		return true;
+ 	}
+
+ 	/**
+ 	 * Evaluates whether a movie is in the BST.
+ 	 *
+ 	 * @param movie - The movie searched (only its sorting criteria are compared)
+ 	 *
+ 	 * @return Whether the movie was found
+ 	 */
+ 	bool contains(MovieType &movie) {
+
+ 		return findSlot(movie) >= 0;
+ 	}
+
+ 	/**
+ 	 * Evaluates whether copies of a movie are borrowed, in any format.
+ 	 *
+ 	 * @param movie - The movie searched (only its sorting criteria are compared)
+ 	 *
+ 	 * @return Whether the movie was found with copies borrowed
+ 	 */
+ 	bool hasBorrowedCopies(MovieType &movie) {
+
+ 		int index = findSlot(movie);
+ 		for(int format = 0; index >= 0 && format < stock.getFormatCount(); format++) {
+
+ 			if(stock.getStock(index, format) < stock.getStartingStock(index, format)) {
+
+ 				return true;
+ 			}
+ 		}
+ 		return false;
+ 	}
+
+ 	/**
+ 	 * Evaluates whether restocking a movie would set its starting stock in a format below the copies
+ 	 * of it borrowed in that format (which could then never all be returned).
+ 	 *
+ 	 * @param movie - The movie searched (only its sorting criteria are compared)
+ 	 * @param formatStock - The new starting stock of the movie in every format
+ 	 *
+ 	 * @return Whether the movie was found with more copies borrowed in a format than the new stock
+ 	 */
+ 	bool restocksBelowBorrowed(MovieType &movie, const int *formatStock) {
+
+ 		int index = findSlot(movie);
+ 		for(int format = 0; index >= 0 && format < stock.getFormatCount(); format++) {
+
+ 			if(formatStock[format] < stock.getStartingStock(index, format) - stock.getStock(index, format)) {
+
+ 				return true;
+ 			}
+ 		}
+ 		return false;
+ 	}
+
+ 	/**
+ 	 * Gets the copies of a movie in stock in a format.
+ 	 *
+ 	 * @param movie - The movie searched (only its sorting criteria are compared)
+ 	 * @param format - The index of the media format
+ 	 *
+ 	 * @return The copies in stock, -1 if the movie is not in the BST
+ 	 */
+ 	int getStock(MovieType &movie, int format = 0) {
+
+ 		int index = findSlot(movie);
+ 		return index < 0 ? -1 : stock.getStock(index, format);
+ 	}
+
+ 	/**
+ 	 * Gets the copies in stock of the movie of a slot in a format.
+ 	 *
+ 	 * @param index - The slot (as returned by "changeMediaStock")
+ 	 * @param format - The index of the media format
+ 	 *
+ 	 * @return The copies in stock
+ 	 */
+ 	int getStockAt(int index, int format = 0) {
+
+ 		return stock.getStock(index, format);
+ 	}
+
+ 	/**
+ 	 * Gets the starting stock of the movie of a slot in a format.
+ 	 *
+ 	 * @param index - The slot
+ 	 * @param format - The index of the media format
+ 	 *
+ 	 * @return The starting stock
+ 	 */
+ 	int getStartingStockAt(int index, int format = 0) {
+
+ 		return stock.getStartingStock(index, format);
+ 	}
+
+ 	/**
+ 	 * Gets the movie of a slot. The movie's stock is not kept up to date (see "getStockAt").
+ 	 *
+ 	 * @param index - The slot (as returned by "changeMediaStock")
+ 	 *
+ 	 * @return The movie
+ 	 */
+ 	const MovieType &getMovieAt(int index) {
+
+ 		return movies.getMovie(index);
+ 	}
+
+ 	/**
+ 	 * Restocks a movie: its starting stock in every format is set, and its current stock changes by
+ 	 * the same amount, so copies borrowed stay counted as borrowed. A restock below the copies
+ 	 * borrowed is rejected by the caller first (see "restocksBelowBorrowed").
+ 	 *
+ 	 * @param movie - The movie restocked (only its sorting criteria are compared)
+ 	 * @param formatStock - The new starting stock of the movie in every format
+ 	 *
+ 	 * @return The success status of the restock
+ 	 */
+ 	bool restock(MovieType &movie, const int *formatStock) {
+
+ 		int index = findSlot(movie);
+ 		if(index < 0) {
+
+ 			cout << "The movie with sorting criteria: " << movie.getSortingCriteria() << " was not found within the inventory." << endl;
+ 			return false;
+ 		}
+ 		bool wasInStock = stock.inStock(index);
+ 		for(int format = 0; format < stock.getFormatCount(); format++) {
+
+ 			stock.restock(index, format, formatStock[format]);
+ 		}
+ 		addInStock(index, stock.inStock(index) - wasInStock);
+ 		cout << "Successfully restocked movie: " << describeMovie(index) << endl;
+ 		return true;
+ 	}
+
+ 	/**
+ 	 * Gets the text of a movie as the inventory prints it (stock, then the movie's fields).
+ 	 *
+ 	 * @param movie - The movie searched (only its sorting criteria are compared)
+ 	 *
+ 	 * @return The movie's text, empty if it is not in the BST
+ 	 */
+ 	string describe(MovieType &movie) {
+
+ 		int index = findSlot(movie);
+ 		return index < 0 ? "" : describeMovie(index);
+ 	}
+
+ 	/**
+ 	 * Calls a visitor with every movie of the BST, in array order. The movies' stock is not kept up
+ 	 * to date (see "describe").
+ 	 *
+ 	 * @param visitor - Callable taking a "const MovieType&"
+ 	 */
+ 	template <typename Visitor>
+ 	void forEachMovie(Visitor &&visitor) {
+
+ 		for(int i = 0; i < movieInventoryMax; i++) {
+
+ 			if(!movies.isEmpty(i)) {
+
+ 				visitor(movies.getMovie(i));
+ 			}
+ 		}
+ 	}
+
+ 	/**
+ 	 * Calls a visitor with the slot of every movie of the BST, in order (ascending sorting criteria).
+ 	 *
+ 	 * @param visitor - Callable taking the slot, an "int" (see "getMovieAt" and "getStockAt")
+ 	 */
+ 	template <typename Visitor>
+ 	void forEachSlotInOrder(Visitor &&visitor) {
+
+ 		vector<int> slots;
+ 		collectSubtree(0, slots);
+ 		for(size_t i = 0; i < slots.size(); i++) {
+
+ 			visitor(slots[i]);
+ 		}
+ 	}
+
+ 	/**
+ 	 * Fills an empty BST with movies at once, e.g. those of a state export: they are sorted and laid
+ 	 * out as a complete binary tree in an array of twice their number (as "compact" does), rather than
+ 	 * inserted one by one.
+ 	 *
+ 	 * @param loaded - The movies, in any order
+ 	 * @param loadedStock - The current and starting stock of every format of each movie, in the same order
+ 	 *
+ 	 * @return Whether the movies were loaded: fails if the BST is not empty, two movies have the same
+ 	 * sorting criteria or they are more than the inventory's maximum size
+ 	 */
+ 	bool load(const vector<MovieType> &loaded, const vector<FormatStockTable::FormatStock> &loadedStock) {
+
+ 		int formats = stock.getFormatCount();
+ 		if(currentSize > 0 || (int) loaded.size() > maxInventorySize) {
+
+ 			return false;
+ 		}
+ 		vector<MovieSortKey> keys;
+ 		vector<int> order;
+ 		for(size_t i = 0; i < loaded.size(); i++) {
+
+ 			keys.push_back(loaded[i].getSortKey());
+ 			order.push_back(i);
+ 		}
+ 		sort(order.begin(), order.end(), [&](int first, int second) {
+
+ 			return keys[second] > keys[first];
+ 		});
+ 		vector<MovieType> sorted;
+ 		vector<FormatStockTable::FormatStock> sortedStock;
+ 		for(size_t i = 0; i < order.size(); i++) {
+
+ 			if(i > 0 && keys[order[i]] == keys[order[i - 1]]) {
+
+ 				return false;
+ 			}
+ 			sorted.push_back(loaded[order[i]]);
+ 			sortedStock.insert(sortedStock.end(), loadedStock.begin() + order[i] * formats, loadedStock.begin() + (order[i] + 1) * formats);
+ 		}
+ 		int newSize = min(maxInventorySize, max(originalSize, 2 * (int) sorted.size() + 1));
+ 		long long oldBytes = movieInventoryMax * getSlotBytes();
+ 		movies.resize(0, newSize);
+ 		stock.resize(0, newSize);
+ 		inStockCounts.assign(newSize, 0);
+ 		movieInventoryMax = newSize;
+ 		MemoryAccounting::recordResize(MemorySubsystem::Inventory, oldBytes, movieInventoryMax * getSlotBytes());
+ 		placeComplete(sorted, sortedStock, 0, sorted.size(), 0);
+ 		currentSize = sorted.size();
+ 		if(trackAvailability) {
+
+ 			recountInStock(0);
+ 		}
+ 		return true;
+ 	}
+
+ 	/**
+ 	 * Gets the number of titles with a copy in stock, in any format.
+ 	 *
+ 	 * @return The number of titles in stock
+ 	 */
+ 	int countInStock() {
+
+ 		if(trackAvailability) {
+
+ 			return movies.isEmpty(0) ? 0 : inStockCounts[0];
+ 		}
+ 		int count = 0;
+ 		for(int i = 0; i < movieInventoryMax; i++) {
+
+ 			count += !movies.isEmpty(i) && stock.inStock(i);
+ 		}
+ 		return count;
+ 	}
+
+ 	/**
+ 	 * Calls a visitor with every title in a range of sort keys that has a copy in stock, in sort key
+ 	 * order. The search descends into the range and the subtrees holding titles in stock alone, so
+ 	 * its cost follows the titles listed rather than the size of the tree; with tracking turned off
+ 	 * the whole tree is traversed.
+ 	 *
+ 	 * @param range - The range of sort keys
+ 	 * @param visitor - Callable taking a "const MovieType&"
+ 	 *
+ 	 * @return The number of titles visited
+ 	 */
+ 	template <typename Visitor>
+ 	int forEachInStock(const SortKeyRange &range, Visitor &&visitor) {
+
+ 		return visitInStock(0, range, visitor);
+ 	}
+
+ 	/**
+ 	 * Turns the availability index on or off (it is on by default). Turned on, the titles in stock
+ 	 * are counted again; turned off, stock changes no longer update it.
+ 	 *
+ 	 * @param tracking - Whether titles in stock are tracked
+ 	 */
+ 	void setAvailabilityTracking(bool tracking) {
+
+ 		trackAvailability = tracking;
+ 		if(tracking) {
+
+ 			recountInStock(0);
+ 		}
+ 	}
+
+ 	/**
+ 	 * Gets the bytes held by the availability index (counted with the inventory's slots).
+ 	 *
+ 	 * @return The bytes held
+ 	 */
+ 	long long getAvailabilityBytes() {
+
+ 		return inStockCounts.capacity() * sizeof(int);
+ 	}
+
+ 	/**
+ 	 * Compacts the BST: rebuilds it as a complete binary tree in an array of twice its number of
+ 	 * movies (one level of room for insertions, and never smaller than the original size). Shrinks
+ 	 * the memory of a tree that has lost movies and shortens its searches.
+ 	 */
+ 	void compact() {
+
+ 		vector<MovieType> sorted;
+ 		vector<FormatStockTable::FormatStock> sortedStock;
+ 		takeSubtree(0, -1, sorted, sortedStock);
+ 		int newSize = min(movieInventoryMax, max(originalSize, 2 * currentSize + 1));
+ 		long long oldBytes = movieInventoryMax * getSlotBytes();
+ 		movies.resize(0, newSize);
+ 		stock.resize(0, newSize);
+ 		inStockCounts.assign(newSize, 0);
+ 		movieInventoryMax = newSize;
+ 		MemoryAccounting::recordResize(MemorySubsystem::Inventory, oldBytes, movieInventoryMax * getSlotBytes());
+ 		placeComplete(sorted, sortedStock, 0, sorted.size(), 0);
+ 		if(trackAvailability) {
+
+ 			recountInStock(0);
+ 		}
+ 	}
+
+ 	/**
+ 	 * Gets the number of slots of the underlying array.
+ 	 *
+ 	 * @return The array's capacity
+ 	 */
+ 	int getCapacity() {
+
+ 		return movieInventoryMax;
+ 	}
+
+ 	/**
+ 	 * Sets the media formats stock is kept for. Only allowed while the tree is empty.
+ 	 *
+ 	 * @param codes - The format codes, in the order of the stock passed to "Insert" and of format indexes
+ 	 *
+ 	 * @return Whether the formats were set
+ 	 */
+ 	bool setFormatCodes(const string &codes) {
+
+ 		if(currentSize > 0 || codes.empty()) {
+
+ 			return false;
+ 		}
+ 		long long oldBytes = movieInventoryMax * getSlotBytes();
+ 		stock.setFormatCount(codes.size(), movieInventoryMax);
+ 		formatCodes = codes;
+ 		MemoryAccounting::recordResize(MemorySubsystem::Inventory, oldBytes, movieInventoryMax * getSlotBytes());
+ 		return true;
+ 	}
+
+ 	/**
+ 	 * Sets the statistics counters updated by searches and stock changes.
+ 	 *
+ 	 * @param inventoryCounters - The counters to be updated, nullptr to stop counting
+ 	 */
+ 	void setCounters(InventoryCounters *inventoryCounters) {
+
+ 		counters = inventoryCounters;
+ 	}
+
+ 	/**
+ 	 * Counts a stock change that failed because the movie was not found, for a movie known not to be
+ 	 * carried without searching (one whose names are not interned, see GenreTraits.h).
+ 	 */
+ 	void countNotFound() {
+
+ 		if(counters != nullptr) {
+
+ 			counters->notFound++;
+ 		}
+ 	}
+
  	/**
  	 * Gets the number of movies stored in BST at point called.
  	 *
@@ -349,9 +1117,9 @@ public:
 
  		for(int i = 0; i < movieInventoryMax; i++) {
 
- 			if(!movies[i].isEmpty()) {
+ 			if(!movies.isEmpty(i)) {
 
- 				cout << movies[i].toString() << endl;
+ 				cout << describeMovie(i) << endl;
  			}
  		}
  	}
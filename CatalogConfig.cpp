@@ -0,0 +1,214 @@
+#include "CatalogConfig.h"
+#include "DelimiterScanner.h"
+
+#include <fstream>
+#include <sstream>
+
+/**
+  * Default constructor - DVDs of every supported genre.
+  */
+CatalogConfig::CatalogConfig() {
+
+	clearFormats();
+	addFormat('D', "DVD");
+	for(int i = 0; i < 256; i++) {
+
+		genresCarried[i] = false;
+	}
+}
+
+/**
+  * Forgets every format.
+  */
+void CatalogConfig::clearFormats() {
+
+	formatCodes.clear();
+	formatNames.clear();
+	for(int i = 0; i < 256; i++) {
+
+		formatIndexes[i] = -1;
+	}
+}
+
+/**
+  * Reads a configuration file. The formats it lists replace the default format, and the genres it
+  * lists become the only genres carried. Invalid lines are reported and skipped.
+  *
+  * @param configFile - The directory of the configuration file
+  * @param supportedGenres - The codes of the genres the store supports
+  *
+  * @return Whether the file was read and lists at least one format
+  */
+bool CatalogConfig::load(string configFile, string supportedGenres) {
+
+	ifstream readFile(configFile);
+	if(!readFile) {
+
+		cout << "Catalog configuration file could not be read: " << configFile << endl;
+		return false;
+	}
+	bool formatsListed = false;
+	string line;
+	while(getline(readFile, line)) {
+
+		stringstream entry(line);
+		string kind;
+		string code;
+		if(!(entry >> kind) || kind[0] == '#') {
+
+			continue;
+		}
+		if(!(entry >> code) || code.size() != 1) {
+
+			cout << "Invalid catalog configuration line: " << line << endl;
+			continue;
+		}
+		if(kind == "format") {
+
+			string name;
+			getline(entry >> ws, name);
+			if(!formatsListed) {
+
+				clearFormats();
+				formatsListed = true;
+			}
+			addFormat(code[0], name == "" ? code : name);
+		}
+		else if(kind == "genre" && supportedGenres.find(code[0]) != string::npos) {
+
+			addGenre(code[0]);
+		}
+		else if(kind == "genre") {
+
+			cout << "Genre code '" << code << "' in catalog configuration is not supported by this store." << endl;
+		}
+		else {
+
+			cout << "Invalid catalog configuration line: " << line << endl;
+		}
+	}
+	if(formatCodes.empty()) {
+
+		addFormat('D', "DVD");
+	}
+	return true;
+}
+
+/**
+  * Adds a media format. Its index is the number of formats added before it.
+  *
+  * @param code - The format's code in commands and movie file stock fields
+  * @param name - The format's name in transactions
+  *
+  * @return Whether the format was added (fails if the code is taken or too many formats are carried)
+  */
+bool CatalogConfig::addFormat(char code, string name) {
+
+	if(getFormatIndex(code) >= 0 || (int) formatCodes.size() >= maxFormats) {
+
+		cout << "Media format '" << code << "' could not be added to the catalog." << endl;
+		return false;
+	}
+	formatIndexes[(unsigned char) code] = formatCodes.size();
+	formatCodes += code;
+	formatNames.push_back(name);
+	return true;
+}
+
+/**
+  * Adds a genre to the genres carried. Once one is added, only the genres added are carried.
+  *
+  * @param code - The genre code
+  */
+void CatalogConfig::addGenre(char code) {
+
+	allGenres = false;
+	genresCarried[(unsigned char) code] = true;
+}
+
+/**
+  * Gets the number of formats carried.
+  *
+  * @return The number of formats
+  */
+int CatalogConfig::getFormatCount() const {
+
+	return formatCodes.size();
+}
+
+/**
+  * Gets the codes of the formats carried.
+  *
+  * @return The codes, in format index order
+  */
+const string &CatalogConfig::getFormatCodes() const {
+
+	return formatCodes;
+}
+
+/**
+  * Gets the name of a format.
+  *
+  * @param format - The format index
+  *
+  * @return The format's name
+  */
+const string &CatalogConfig::getFormatName(int format) const {
+
+	return formatNames[format];
+}
+
+/**
+  * Evaluates whether a genre is carried.
+  *
+  * @param code - The genre code
+  *
+  * @return Whether the genre is carried
+  */
+bool CatalogConfig::carriesGenre(char code) const {
+
+	return allGenres || genresCarried[(unsigned char) code];
+}
+
+/**
+  * Parses the stock field of a movie file line. A plain number is the stock of the first format;
+  * otherwise the field lists "<code>:<stock>" pairs separated by spaces, e.g. "D:10 B:4 K:2".
+  * Formats not listed have no stock. Stocks are parsed without allocating or throwing (see
+  * "parseIntegerField"); one that is not a number, or is negative, makes the field invalid.
+  *
+  * @param field - The stock field, without its leading space
+  * @param stock - The stock of every format, filled (getFormatCount() entries)
+  *
+  * @return Whether the field was valid: every stock a number, and every format code listed carried
+  */
+bool CatalogConfig::parseStock(string_view field, int *stock) const {
+
+	for(size_t i = 0; i < formatCodes.size(); i++) {
+
+		stock[i] = 0;
+	}
+	if(field.find(':') == string_view::npos) {
+
+		if(!parseIntegerField(field, stock[0]) || stock[0] < 0) {
+
+			cout << "Invalid stock: " << field << "." << endl;
+			return false;
+		}
+		return true;
+	}
+	string_view pair;
+	while(splitFields(field, ' ', &pair, 1, &field) > 0) {
+
+		if(pair.empty()) {
+
+			continue;
+		}
+		int format = getFormatIndex(pair[0]);
+		if(format < 0 || pair.size() < 3 || pair[1] != ':' || !parseIntegerField(pair.substr(2), stock[format]) || stock[format] < 0) {
+
+			cout << "Invalid stock for media format: " << pair << "." << endl;
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,75 @@
+#ifndef CATALOGCONFIG_H
+#define CATALOGCONFIG_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// the media formats and genres a store carries. by default the store carries DVDs (code "D") of
+// every genre it supports; a configuration file replaces either list. the file holds one entry per
+// line, blank lines and lines starting with '#' are ignored:
+//   format <code> <name>      a media format, e.g. "format B Blu-ray" (in stock column order)
+//   genre <code>              a genre carried, e.g. "genre F" (must be a genre the store supports)
+class CatalogConfig {
+
+public:
+
+	// the largest number of media formats carried
+	static const int maxFormats = 16;
+
+private:
+
+	// the format codes, in format index order, and their names
+	string formatCodes;
+	vector<string> formatNames;
+
+	// index of every format code (-1 if not carried), indexed by the code's character
+	signed char formatIndexes[256];
+
+	// whether every supported genre is carried, else which genre codes are
+	bool allGenres = true;
+	bool genresCarried[256];
+
+	// forgets every format
+	void clearFormats();
+
+public:
+
+	// CatalogConfig default constructor - DVDs of every supported genre
+	CatalogConfig();
+
+	// reads a configuration file (first argument); genre codes must be among the second argument
+	bool load(string, string);
+
+	// adds a media format with the code and name arguments
+	bool addFormat(char, string);
+
+	// adds a genre code to the genres carried
+	void addGenre(char);
+
+	// gets the index of the format code argument, -1 if not carried
+	int getFormatIndex(char code) const {
+
+		return formatIndexes[(unsigned char) code];
+	}
+
+	// gets the number of formats carried
+	int getFormatCount() const;
+
+	// gets the codes of the formats carried, in format index order
+	const string &getFormatCodes() const;
+
+	// gets the name of the format at the index argument
+	const string &getFormatName(int) const;
+
+	// evaluates whether the genre code argument is carried
+	bool carriesGenre(char) const;
+
+	// parses the stock field of a movie file line into the stock of every format
+	bool parseStock(string_view, int *) const;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "CommandResult.h"
+
+#include <charconv>
+#include <cstring>
+
+// the names of the statuses, in the order of the enumeration
+static const char *const statusNames[] = {"ok", "waitlisted", "unknown_customer", "invalid_media_code", "invalid_genre_code",
+	"malformed_command", "movie_not_found", "out_of_stock", "stock_at_maximum", "borrow_limit_reached", "nothing_borrowed",
+	"not_borrowed", "invalid_action", "failed", "not_durable"};
+
+/**
+  * Gets the name of a status as the JSON lines format writes it.
+  *
+  * @param status - The status
+  *
+  * @return The name of the status, e.g. "out_of_stock"
+  */
+const char *getStatusName(CommandStatus status) {
+
+	return statusNames[(int) status];
+}
+
+// appends text, integers and JSON strings to a buffer, failing once the buffer is full
+class JsonWriter {
+
+private:
+
+	char *position;
+	char *end;
+
+public:
+
+	bool full = false;
+
+	JsonWriter(char *buffer, size_t size) : position(buffer), end(buffer + size) {}
+
+	// appends the text argument
+	void text(const char *value) {
+
+		size_t length = strlen(value);
+		if(full || (size_t) (end - position) < length) {
+
+			full = true;
+			return;
+		}
+		memcpy(position, value, length);
+		position += length;
+	}
+
+	// appends the integer argument
+	void integer(long long value) {
+
+		to_chars_result written = to_chars(position, end, value);
+		if(full || written.ec != errc()) {
+
+			full = true;
+			return;
+		}
+		position = written.ptr;
+	}
+
+	// appends the characters argument (and its length) as a JSON string, escaping quotes, backslashes
+	// and control characters
+	void quoted(const char *value, size_t length) {
+
+		static const char hexDigits[] = "0123456789abcdef";
+		text("\"");
+		for(size_t i = 0; i < length && !full; i++) {
+
+			unsigned char character = value[i];
+			if(character == '"' || character == '\\') {
+
+				char escaped[] = {'\\', (char) character, '\0'};
+				text(escaped);
+			}
+			else if(character == '\n') {
+
+				text("\\n");
+			}
+			else if(character < 0x20) {
+
+				char escaped[] = {'\\', 'u', '0', '0', hexDigits[character >> 4], hexDigits[character & 15], '\0'};
+				text(escaped);
+			}
+			else if(position < end) {
+
+				*position++ = character;
+			}
+			else {
+
+				full = true;
+			}
+		}
+		text("\"");
+	}
+
+	// gets the bytes written since the argument (the start of the buffer)
+	size_t written(const char *buffer) const {
+
+		return position - buffer;
+	}
+};
+
+/**
+  * Formats a result as a JSON object followed by a newline, e.g.
+  * {"action":"B","status":"ok","custID":1000,"media":"D","genre":"F","format":0,"slot":3,"stock":9,...}
+  * The argument and output are only written when not empty. Nothing is allocated.
+  *
+  * @param result - The result
+  * @param buffer - The buffer written to
+  * @param size - The size of the buffer
+  *
+  * @return The bytes written, 0 if the buffer is too small
+  */
+size_t formatJsonLine(const CommandResult &result, char *buffer, size_t size) {
+
+	JsonWriter writer(buffer, size);
+	writer.text("{\"action\":");
+	writer.quoted(&result.action, result.action == '\0' ? 0 : 1);
+	writer.text(",\"status\":\"");
+	writer.text(getStatusName(result.status));
+	writer.text("\"");
+	if(result.custID >= 0) {
+
+		writer.text(",\"custID\":");
+		writer.integer(result.custID);
+	}
+	if(result.mediaCode != '\0') {
+
+		writer.text(",\"media\":");
+		writer.quoted(&result.mediaCode, 1);
+	}
+	if(result.genre != '\0') {
+
+		writer.text(",\"genre\":");
+		writer.quoted(&result.genre, 1);
+		writer.text(",\"format\":");
+		writer.integer(result.format);
+		writer.text(",\"slot\":");
+		writer.integer(result.slot);
+		writer.text(",\"stock\":");
+		writer.integer(result.stock);
+	}
+	if(result.status == CommandStatus::Waitlisted) {
+
+		writer.text(",\"waitlistPosition\":");
+		writer.integer(result.waitlistPosition);
+	}
+	if(result.copiesLent > 0) {
+
+		writer.text(",\"copiesLent\":");
+		writer.integer(result.copiesLent);
+		writer.text(",\"lentTo\":");
+		writer.integer(result.lentTo);
+	}
+	if(result.lateFeeCents > 0) {
+
+		writer.text(",\"lateFeeCents\":");
+		writer.integer(result.lateFeeCents);
+	}
+	if(!result.argument.empty()) {
+
+		writer.text(",\"argument\":");
+		writer.quoted(result.argument.data(), result.argument.size());
+	}
+	if(!result.output.empty()) {
+
+		writer.text(",\"output\":");
+		writer.quoted(result.output.data(), result.output.size());
+	}
+	writer.text("}\n");
+	return writer.full ? 0 : writer.written(buffer);
+}
+
+/**
+  * Writes an integer of the given number of bytes, little endian.
+  *
+  * @param position - The first byte written
+  * @param value - The integer
+  * @param bytes - The number of bytes
+  *
+  * @return The byte after the integer
+  */
+static char *writeLittleEndian(char *position, unsigned long long value, int bytes) {
+
+	for(int i = 0; i < bytes; i++) {
+
+		*position++ = (char) (value >> (8 * i));
+	}
+	return position;
+}
+
+/**
+  * Formats a result as a binary frame (see CommandResult.h for its layout). Nothing is allocated.
+  *
+  * @param result - The result
+  * @param buffer - The buffer written to
+  * @param size - The size of the buffer
+  *
+  * @return The bytes written, 0 if the buffer is too small
+  */
+size_t formatBinaryFrame(const CommandResult &result, char *buffer, size_t size) {
+
+	size_t frameSize = minimumBinaryFrameSize + result.argument.size() + result.output.size();
+	if(frameSize > size) {
+
+		return 0;
+	}
+	char *position = writeLittleEndian(buffer, frameSize - 4, 4);
+	*position++ = result.action;
+	*position++ = (char) result.status;
+	*position++ = result.mediaCode;
+	*position++ = result.genre;
+	position = writeLittleEndian(position, (unsigned int) result.custID, 4);
+	position = writeLittleEndian(position, (unsigned int) result.format, 4);
+	position = writeLittleEndian(position, (unsigned int) result.slot, 4);
+	position = writeLittleEndian(position, (unsigned int) result.stock, 4);
+	position = writeLittleEndian(position, (unsigned int) result.waitlistPosition, 4);
+	position = writeLittleEndian(position, (unsigned int) result.copiesLent, 4);
+	position = writeLittleEndian(position, (unsigned int) result.lentTo, 4);
+	position = writeLittleEndian(position, (unsigned long long) result.lateFeeCents, 8);
+	position = writeLittleEndian(position, result.argument.size(), 4);
+	memcpy(position, result.argument.data(), result.argument.size());
+	position += result.argument.size();
+	position = writeLittleEndian(position, result.output.size(), 4);
+	memcpy(position, result.output.data(), result.output.size());
+	return frameSize;
+}
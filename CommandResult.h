@@ -0,0 +1,131 @@
+#ifndef COMMANDRESULT_H
+#define COMMANDRESULT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// the outcome of a command
+enum class CommandStatus : uint8_t {
+
+	// the command succeeded
+	Ok,
+
+	// a "W" borrow of a movie out of stock joined the movie's waitlist
+	Waitlisted,
+
+	// no customer has the ID given
+	UnknownCustomer,
+
+	// the media type is not one of the formats carried
+	InvalidMediaCode,
+
+	// the genre is not one of the genres carried
+	InvalidGenreCode,
+
+	// the borrow/return command is missing arguments
+	MalformedCommand,
+
+	// the movie is not in inventory
+	MovieNotFound,
+
+	// a borrow found no copy in stock
+	OutOfStock,
+
+	// a return found the stock already at its starting stock
+	StockAtMaximum,
+
+	// the customer already holds the maximum number of movies
+	BorrowLimitReached,
+
+	// a return by a customer holding no movies
+	NothingBorrowed,
+
+	// a return of a movie the customer holds no copy of
+	NotBorrowed,
+
+	// the command's code is not recognized
+	InvalidAction,
+
+	// any other command failed (its output tells why)
+	Failed,
+
+	// the command was executed, but the journal failed and could not record it
+	NotDurable
+};
+
+// the outcome of a command line executed through "MovieRentalStore::execute". borrow/return commands
+// ("B", "R" and "W") report their outcome in the fields of the result, which is filled without
+// allocating unless the command fails (the command still allocates the transaction it records in the
+// customer's history); the other commands report whether they succeeded, and the text they printed
+// in "output". the result is formatted as the store prints it by
+// "MovieRentalStore::printCommandResult", and as a JSON line or a binary frame by the functions below.
+struct CommandResult {
+
+	// the command's code, the first character of the line ('\0' for an empty line)
+	char action = '\0';
+
+	// the outcome of the command
+	CommandStatus status = CommandStatus::Failed;
+
+	// the customer handle: the ID of the customer a borrow/return command names, -1 until it is parsed
+	int custID = -1;
+
+	// the inventory ref: the media type and genre codes a borrow/return command names, the index of the
+	// format, and the slot of the movie in its genre's inventory (-1 if not found; valid until the
+	// inventory changes)
+	char mediaCode = '\0';
+	char genre = '\0';
+	int format = -1;
+	int slot = -1;
+
+	// the copies of the movie in stock in the format after the command, -1 if the movie is not found
+	int stock = -1;
+
+	// the position in the waitlist joined ("Waitlisted"), the copies a return handed to the customers
+	// waiting for the movie, and the ID of the customer lent the copy (-1 if none; a copy returned is
+	// the only one a return can lend, as copies in stock are never left with customers waiting)
+	int waitlistPosition = 0;
+	int copiesLent = 0;
+	int lentTo = -1;
+
+	// the late fee a return was charged, in cents
+	long long lateFeeCents = 0;
+
+	// the argument a failed borrow/return command names, as given: the customer ID of an unknown
+	// customer, or the sorting criteria of the movie
+	string argument;
+
+	// the text printed by a command other than a borrow/return
+	string output;
+
+	// gets whether the command succeeded
+	bool succeeded() const {
+
+		return status == CommandStatus::Ok || status == CommandStatus::Waitlisted;
+	}
+};
+
+// gets the name of a status as the JSON lines format writes it, e.g. "out_of_stock"
+const char *getStatusName(CommandStatus);
+
+// formats a result (first argument) as a JSON object followed by a newline into the buffer (second
+// argument) of the size given; gets the bytes written, 0 if the buffer is too small
+size_t formatJsonLine(const CommandResult &, char *, size_t);
+
+// formats a result (first argument) as a binary frame into the buffer (second argument) of the size
+// given; gets the bytes written, 0 if the buffer is too small. all integers are little endian:
+//   uint32 length of the rest of the frame
+//   uint8 action, uint8 status, uint8 media code, uint8 genre
+//   int32 customer ID, int32 format, int32 slot, int32 stock, int32 waitlist position, int32 copies lent,
+//   int32 ID of the customer lent the copy
+//   int64 late fee in cents
+//   uint32 length of the argument, the argument, uint32 length of the output, the output
+size_t formatBinaryFrame(const CommandResult &, char *, size_t);
+
+// the bytes of the binary frame of a result with no argument or output
+const size_t minimumBinaryFrameSize = 4 + 4 + 7 * 4 + 8 + 4 + 4;
+
+#endif
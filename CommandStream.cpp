@@ -0,0 +1,232 @@
+#include "CommandStream.h"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+/**
+  * OutputBuffer constructor - collects output in a buffer of the given size.
+  *
+  * @param fd - The descriptor the output is written to
+  * @param size - The size of the buffer
+  */
+CommandStream::OutputBuffer::OutputBuffer(int fd, size_t size) : fd(fd), buffer(size) {
+
+	setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+/**
+  * Writes the output collected to the descriptor, all of it (retrying partial writes).
+  *
+  * @return Whether the output was written
+  */
+bool CommandStream::OutputBuffer::writeOut() {
+
+	const char *next = pbase();
+	while(next < pptr()) {
+
+		ssize_t written = write(fd, next, pptr() - next);
+		if(written == -1 && errno == EINTR) {
+
+			continue;
+		}
+		if(written <= 0) {
+
+			setp(buffer.data(), buffer.data() + buffer.size());
+			return false;
+		}
+		next += written;
+	}
+	setp(buffer.data(), buffer.data() + buffer.size());
+	return true;
+}
+
+/**
+  * Drops the output collected, unwritten.
+  */
+void CommandStream::OutputBuffer::discard() {
+
+	setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+/**
+  * Called when the buffer is full: writes it out, then collects the character.
+  *
+  * @param character - The character that did not fit, or EOF
+  *
+  * @return The character, EOF if the output could not be written
+  */
+int CommandStream::OutputBuffer::overflow(int character) {
+
+	if(!writeOut()) {
+
+		return traits_type::eof();
+	}
+	if(character != traits_type::eof()) {
+
+		*pptr() = character;
+		pbump(1);
+	}
+	return traits_type::not_eof(character);
+}
+
+/**
+  * Called by every flush of cout ("endl"): the output stays collected until "writeOut".
+  *
+  * @return 0 (success)
+  */
+int CommandStream::OutputBuffer::sync() {
+
+	return 0;
+}
+
+/**
+  * CommandStream constructor.
+  *
+  * @param store - The store commands are executed against
+  * @param resultFormat - The format results are written in
+  */
+CommandStream::CommandStream(MovieRentalStore &store, ResultFormat resultFormat) : store(store), resultFormat(resultFormat), frame(4096) {}
+
+/**
+  * Executes one command line.
+  *
+  * @param line - The first character of the line
+  * @param length - The length of the line, its newline excluded
+  */
+void CommandStream::execute(const char *line, size_t length) {
+
+	if(length > 0 && line[length - 1] == '\r') {
+
+		length--;
+	}
+	if(length == 0) {
+
+		return;
+	}
+	if(resultFormat == ResultFormat::Text) {
+
+		store.executeCommand(string_view(line, length));
+	}
+	else {
+
+		// the frame buffer grows to the largest result (the output of an inventory command)
+		CommandResult result = store.execute(string_view(line, length));
+		size_t written;
+		while((written = resultFormat == ResultFormat::JsonLines ? formatJsonLine(result, frame.data(), frame.size())
+			: formatBinaryFrame(result, frame.data(), frame.size())) == 0) {
+
+			frame.resize(2 * frame.size());
+		}
+		cout.write(frame.data(), written);
+	}
+	commandCount++;
+}
+
+/**
+  * Evaluates whether input is waiting to be read, without blocking.
+  *
+  * @param fd - The input descriptor
+  *
+  * @return Whether a read would return at once (data, end of file or an error)
+  */
+bool CommandStream::inputWaiting(int fd) {
+
+	pollfd input = {fd, POLLIN, 0};
+	return poll(&input, 1, 0) > 0;
+}
+
+/**
+  * Executes the command lines read from a descriptor until end of file. Blocks of up to
+  * "readBlockSize" bytes are read, each complete line executed, and the output collected written
+  * before the next read would block (or "flushInterval" after the last write, while input keeps
+  * arriving). A line longer than the buffer grows it; a last line without a newline is executed at
+  * end of file.
+  *
+  * @param inputFd - The descriptor commands are read from
+  * @param outputFd - The descriptor the output of commands is written to
+  *
+  * @return Whether the input was read to its end and all output written
+  */
+bool CommandStream::run(int inputFd, int outputFd) {
+
+	OutputBuffer output(outputFd, outputBufferSize);
+	streambuf *standardOutput = cout.rdbuf(&output);
+	vector<char> input(readBlockSize);
+	size_t filled = 0;
+	bool succeeded = true;
+	steady_clock::time_point lastWrite = steady_clock::now();
+
+	// writes out the output collected, once the commands it answers are durable; if the journal failed
+	// they never will be, and the output is withheld
+	auto writeOutput = [&]() {
+
+		if(store.journal != nullptr && !store.journal->waitUntilDurable(store.lastJournalSequence)) {
+
+			output.discard();
+			if(succeeded) {
+
+				cerr << "The journal failed (" << store.journal->getFailure() << "): the output of commands not durable was withheld." << endl;
+			}
+			succeeded = false;
+			return;
+		}
+		succeeded = output.writeOut() && succeeded;
+		lastWrite = steady_clock::now();
+	};
+	while(succeeded) {
+
+		if(filled == input.size()) {
+
+			input.resize(2 * input.size());
+		}
+		ssize_t bytesRead = read(inputFd, input.data() + filled, input.size() - filled);
+		if(bytesRead == -1 && errno == EINTR) {
+
+			continue;
+		}
+		if(bytesRead <= 0) {
+
+			succeeded = bytesRead == 0;
+			execute(input.data(), filled);
+			break;
+		}
+		filled += bytesRead;
+
+		// execute every complete line, then keep the partial last line for the next read
+		char *lineStart = input.data();
+		char *end = input.data() + filled;
+		char *newline;
+		while((newline = (char*) memchr(lineStart, '\n', end - lineStart)) != nullptr) {
+
+			execute(lineStart, newline - lineStart);
+			lineStart = newline + 1;
+			if(steady_clock::now() - lastWrite >= flushInterval) {
+
+				writeOutput();
+			}
+		}
+		filled = end - lineStart;
+		memmove(input.data(), lineStart, filled);
+		if(!inputWaiting(inputFd) || steady_clock::now() - lastWrite >= flushInterval) {
+
+			writeOutput();
+		}
+	}
+	writeOutput();
+	cout.rdbuf(standardOutput);
+	return succeeded;
+}
+
+/**
+  * Gets the number of command lines executed.
+  *
+  * @return The number of command lines
+  */
+long long CommandStream::getCommandCount() const {
+
+	return commandCount;
+}
@@ -0,0 +1,95 @@
+#ifndef COMMANDSTREAM_H
+#define COMMANDSTREAM_H
+
+#include "MovieRentalStore.h"
+
+#include <chrono>
+#include <streambuf>
+#include <vector>
+
+using namespace std;
+
+// executes the command lines read from a file descriptor (standard input, a pipe, a file) as they
+// arrive, until end of file, so the store can sit in a pipeline indefinitely. input is read in large
+// blocks and every complete line is executed at once. the output commands print to cout is collected
+// (the flush of every "endl" is ignored) and written to the output descriptor once no more input is
+// waiting, or at the latest "flushInterval" after the last write while input keeps arriving: a slow
+// producer sees every command's output right away, a fast one gets large writes. when the store has
+// a journal, output is written once every command executed before it is durable (if the journal fails,
+// the output waiting is withheld and the stream ends, failed). the results of
+// commands are written as the store prints them, or as JSON lines or binary frames (see CommandResult.h).
+class CommandStream {
+
+public:
+
+	// the formats results are written in: the text the store prints, JSON lines or binary frames
+	enum class ResultFormat { Text, JsonLines, Binary };
+
+private:
+
+	// collects the output of commands; written out by "writeOut", or when full
+	class OutputBuffer: public streambuf {
+
+	private:
+
+		int fd;
+		vector<char> buffer;
+
+	public:
+
+		// OutputBuffer constructor - the descriptor written to and the size of the buffer
+		OutputBuffer(int, size_t);
+
+		// writes the output collected to the descriptor; false if the descriptor failed
+		bool writeOut();
+
+		// drops the output collected
+		void discard();
+
+	protected:
+
+		// writes out the full buffer, then collects the character argument
+		int overflow(int);
+
+		// ignores flushes (output is written by "writeOut")
+		int sync();
+	};
+
+	// the store commands are executed against
+	MovieRentalStore &store;
+
+	// the format results are written in, and the buffer a JSON line or binary frame is formatted in
+	ResultFormat resultFormat;
+	vector<char> frame;
+
+	// the bytes read per block, and the size of the output buffer
+	static constexpr size_t readBlockSize = 1 << 20;
+	static constexpr size_t outputBufferSize = 1 << 20;
+
+	// the longest output is held while input keeps arriving
+	const chrono::milliseconds flushInterval{50};
+
+	// number of command lines executed
+	long long commandCount = 0;
+
+	// executes one command line (a trailing carriage return is removed, blank lines skipped)
+	void execute(const char *, size_t);
+
+	// evaluates whether input is waiting to be read from the descriptor argument
+	static bool inputWaiting(int);
+
+public:
+
+	// CommandStream constructor - commands are executed against the store argument, their results
+	// written in the format argument
+	CommandStream(MovieRentalStore &, ResultFormat = ResultFormat::Text);
+
+	// executes the command lines read from the input descriptor (first argument) until end of file,
+	// writing their output to the output descriptor; false if either descriptor failed
+	bool run(int, int);
+
+	// gets the number of command lines executed
+	long long getCommandCount() const;
+};
+
+#endif
@@ -19,37 +19,11 @@ Customer::Customer() : customerID(0), firstName(""), lastName(""), movieBorrowCo
 Customer::Customer(int customerID, string firstName, string lastName) : customerID(customerID), firstName(firstName), lastName(lastName), movieBorrowCount(0), nextCustomer(nullptr) {}
 
 /**
- * Destructor calls helper that deletes all Customer objects in linked chain 
- * pointed to by "nextCustomer".
+ * Destructor. The Customer objects in the linked chain pointed to by
+ * "nextCustomer" are not deleted: they are allocated from the store's customer
+ * pool, and the store destroys every chain iteratively when it is destroyed.
  */
-Customer::~Customer() {
-
-	deletionHelper(nextCustomer);
-}
-
-/**
- * Deletes all Customer objects in linked chain pointed to by "nextCustomer".
- *
- * @param customer - Pointer to Customer object to be deleted
- */
-void Customer::deletionHelper(Customer *customer) {
-
-	if(customer != nullptr) {
-
-		if(customer->getNextCustomer() == nullptr) {
-
-			delete(customer);
-			customer = nullptr;
-			return;
-		}
-		else {
-
-			deletionHelper(customer->getNextCustomer());
-			delete(customer);
-			customer = nullptr;
- 		}
-	}
-}
+Customer::~Customer() {}
 
 /**
  * Gets the the customer's ID number.
@@ -93,21 +67,20 @@ bool Customer::isEmpty() {
 }
 
 /**
- * Prints to standard output the list of all transactions made by the 
- * customer. Customer's transactions are all stored in member vector 
- * "customerTransactions".
+ * Prints to standard output the transactions made by the customer, newest 
+ * first. Only the compressed blocks of "customerTransactions" holding the 
+ * transactions printed are decoded, so printing the newest few decodes none.
+ *
+ * @param count - The most transactions printed
  */
-void Customer::printCustomerTransactions() {
+void Customer::printCustomerTransactions(size_t count) {
 
-	if(customerTransactions.begin() != customerTransactions.end()) {
+	if(customerTransactions.size() > 0) {
 
-		vector<string>::iterator it = customerTransactions.end();
-		--it;
-		for(; it != customerTransactions.begin(); --it) {
+		customerTransactions.forEachNewestFirst(count, [](string_view transaction) {
 
-			cout << *it << endl;
-		}
-		cout << *it << endl;
+			cout << transaction << endl;
+		});
 	}
 	else {
 
@@ -116,13 +89,53 @@ void Customer::printCustomerTransactions() {
 }
 
 /**
- * Adds customer transaction to member string vector.
+ * Adds customer transaction to the transaction history, which compresses its
+ * older transactions as it grows.
  *
  * @param transaction - The customer transaction to be added.
  */
 void Customer::addTransaction(string transaction) {
 
-	customerTransactions.push_back(transaction);
+	if(!MemoryAccounting::isEnabled()) {
+
+		customerTransactions.add(move(transaction));
+		return;
+	}
+	size_t previousBytes = customerTransactions.getBytes();
+	customerTransactions.add(move(transaction));
+	MemoryAccounting::recordResize(MemorySubsystem::History, previousBytes, customerTransactions.getBytes());
+}
+
+/**
+ * Gets the heap bytes held by the customer's first and last name. Names short enough to fit
+ * the strings' internal buffers hold none.
+ *
+ * @return The heap bytes of the customer's names
+ */
+size_t Customer::getNameBytes() {
+
+	return MemoryAccounting::stringHeapBytes(firstName) + MemoryAccounting::stringHeapBytes(lastName);
+}
+
+/**
+ * Gets the heap bytes held by the customer's transaction history: the recent
+ * transactions and the compressed blocks.
+ *
+ * @return The heap bytes of the customer's transaction history
+ */
+size_t Customer::getHistoryBytes() {
+
+	return customerTransactions.getBytes();
+}
+
+/**
+ * Gets the transactions made by the customer.
+ *
+ * @return The customer's transaction history
+ */
+const TransactionHistory &Customer::getTransactions() {
+
+	return customerTransactions;
 }
 
 /**
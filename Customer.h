@@ -1,5 +1,8 @@
+#include <cstdint>
 #include <iostream>
 #include <vector>
+#include "MemoryAccounting.h"
+#include "TransactionHistory.h"
 
 using namespace std;
 
@@ -16,8 +19,8 @@ private:
 	// customer's last name
 	string lastName;
 
-	// vector list of all transactions made by customer
-	vector<string> customerTransactions;
+	// all transactions made by customer, the older ones compressed
+	TransactionHistory customerTransactions;
 
 	// number of movies customer has borrowed
 	int movieBorrowCount;
@@ -34,12 +37,9 @@ public:
 	// Customer constructor assigns members fields to parameter values
 	Customer(int customerID, string firstName, string lastName);
 
-	// Customer destructor - deletes all customers in chain
+	// Customer destructor - chained customers are owned (and destroyed) by the store
 	~Customer();
 
-	// helper function aids in deletion of all customers in linked-list chain
-	void deletionHelper(Customer*);
-
 	// getter for customer ID
 	int getCustomerID();
 
@@ -52,8 +52,17 @@ public:
 	// add customer transaction to customer transaction vector list
 	void addTransaction(string transaction);
 
-	// print all customer transactions conducted thus far
-	void printCustomerTransactions();
+	// print the customer transactions conducted thus far, newest first, up to the count argument (all unless given)
+	void printCustomerTransactions(size_t = SIZE_MAX);
+
+	// getter for the customer transactions conducted thus far
+	const TransactionHistory &getTransactions();
+
+	// the heap bytes held by the customer's name strings
+	size_t getNameBytes();
+
+	// the heap bytes held by the customer's transaction history
+	size_t getHistoryBytes();
 
 	// evaluates whether the Customer object is "empty" (constructed via default constructor, with all member field values still set to default values)
 	bool isEmpty();
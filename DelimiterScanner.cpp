@@ -0,0 +1,391 @@
+#include "DelimiterScanner.h"
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DELIMITER_SCANNER_X86
+#endif
+
+/**
+  * Finds delimiters one byte at a time.
+  *
+  * @param text - The text scanned
+  * @param delimiters - The delimiters (one to four characters)
+  * @param positions - The positions of the delimiters found, filled
+  * @param count - The most positions found
+  *
+  * @return The number of positions found
+  */
+static size_t findDelimitersScalar(string_view text, string_view delimiters, uint32_t *positions, size_t count) {
+
+	// the delimiters, the first repeated in place of those not given
+	char first = delimiters[0];
+	char second = delimiters.size() > 1 ? delimiters[1] : first;
+	char third = delimiters.size() > 2 ? delimiters[2] : first;
+	char fourth = delimiters.size() > 3 ? delimiters[3] : first;
+	size_t found = 0;
+	for(size_t i = 0; i < text.size() && found < count; i++) {
+
+		char character = text[i];
+		if(character == first || character == second || character == third || character == fourth) {
+
+			positions[found++] = i;
+		}
+	}
+	return found;
+}
+
+#ifdef DELIMITER_SCANNER_X86
+
+/**
+  * Finds delimiters 16 bytes at a time: each delimiter is compared against the bytes, the comparisons
+  * are combined into a mask of the bytes matching any, and the mask's bits are handed out in order.
+  * The bytes after the last full 16 are scanned one at a time.
+  *
+  * @param text - The text scanned
+  * @param delimiters - The delimiters (one to four characters)
+  * @param positions - The positions of the delimiters found, filled
+  * @param count - The most positions found
+  *
+  * @return The number of positions found
+  */
+__attribute__((target("sse2")))
+static size_t findDelimitersSse2(string_view text, string_view delimiters, uint32_t *positions, size_t count) {
+
+	__m128i patterns[4];
+	for(size_t d = 0; d < 4; d++) {
+
+		patterns[d] = _mm_set1_epi8(delimiters[d < delimiters.size() ? d : 0]);
+	}
+	size_t found = 0;
+	size_t i = 0;
+	for(; i + 16 <= text.size() && found < count; i += 16) {
+
+		__m128i bytes = _mm_loadu_si128((const __m128i*) (text.data() + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, patterns[0]), _mm_cmpeq_epi8(bytes, patterns[1])),
+			_mm_or_si128(_mm_cmpeq_epi8(bytes, patterns[2]), _mm_cmpeq_epi8(bytes, patterns[3])));
+		unsigned int mask = _mm_movemask_epi8(matches);
+		while(mask != 0 && found < count) {
+
+			positions[found++] = i + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+	}
+	if(found < count && i < text.size()) {
+
+		size_t tail = findDelimitersScalar(text.substr(i), delimiters, positions + found, count - found);
+		for(size_t j = found; j < found + tail; j++) {
+
+			positions[j] += i;
+		}
+		found += tail;
+	}
+	return found;
+}
+
+/**
+  * Finds delimiters 32 bytes at a time, as "findDelimitersSse2" does 16. The bytes after the last full
+  * 32 are scanned 16 at a time while they can be, then one at a time: calling the SSE2 scan from here
+  * would mix its encoding with the AVX2 instructions' and stall.
+  *
+  * @param text - The text scanned
+  * @param delimiters - The delimiters (one to four characters)
+  * @param positions - The positions of the delimiters found, filled
+  * @param count - The most positions found
+  *
+  * @return The number of positions found
+  */
+__attribute__((target("avx2")))
+static size_t findDelimitersAvx2(string_view text, string_view delimiters, uint32_t *positions, size_t count) {
+
+	__m256i patterns[4];
+	for(size_t d = 0; d < 4; d++) {
+
+		patterns[d] = _mm256_set1_epi8(delimiters[d < delimiters.size() ? d : 0]);
+	}
+	size_t found = 0;
+	size_t i = 0;
+	for(; i + 32 <= text.size() && found < count; i += 32) {
+
+		__m256i bytes = _mm256_loadu_si256((const __m256i*) (text.data() + i));
+		__m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, patterns[0]), _mm256_cmpeq_epi8(bytes, patterns[1])),
+			_mm256_or_si256(_mm256_cmpeq_epi8(bytes, patterns[2]), _mm256_cmpeq_epi8(bytes, patterns[3])));
+		unsigned int mask = _mm256_movemask_epi8(matches);
+		while(mask != 0 && found < count) {
+
+			positions[found++] = i + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+	}
+	if(i + 16 <= text.size() && found < count) {
+
+		__m128i bytes = _mm_loadu_si128((const __m128i*) (text.data() + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(patterns[0])), _mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(patterns[1]))),
+			_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(patterns[2])), _mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(patterns[3]))));
+		unsigned int mask = _mm_movemask_epi8(matches);
+		while(mask != 0 && found < count) {
+
+			positions[found++] = i + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+		i += 16;
+	}
+	if(found < count && i < text.size()) {
+
+		size_t tail = findDelimitersScalar(text.substr(i), delimiters, positions + found, count - found);
+		for(size_t j = found; j < found + tail; j++) {
+
+			positions[j] += i;
+		}
+		found += tail;
+	}
+	return found;
+}
+
+#endif
+
+/**
+  * Gets the best scan level the processor supports, detected on the first call.
+  *
+  * @return The scan level
+  */
+ScanLevel getSupportedScanLevel() {
+
+#ifdef DELIMITER_SCANNER_X86
+	static const ScanLevel supported = __builtin_cpu_supports("avx2") ? ScanLevel::Avx2
+		: __builtin_cpu_supports("sse2") ? ScanLevel::Sse2 : ScanLevel::Scalar;
+	return supported;
+#else
+	return ScanLevel::Scalar;
+#endif
+}
+
+// the scan level used when none is named
+static ScanLevel scanLevel = getSupportedScanLevel();
+
+ScanLevel getScanLevel() {
+
+	return scanLevel;
+}
+
+/**
+  * Sets the scan level used when none is named, e.g. to compare the levels on the store's files.
+  *
+  * @param level - The scan level, lowered to the supported one if the processor does not support it
+  */
+void setScanLevel(ScanLevel level) {
+
+	scanLevel = min(level, getSupportedScanLevel());
+}
+
+/**
+  * Gets the name of a scan level.
+  *
+  * @param level - The scan level
+  *
+  * @return "scalar", "sse2" or "avx2"
+  */
+const char *getScanLevelName(ScanLevel level) {
+
+	return level == ScanLevel::Avx2 ? "avx2" : level == ScanLevel::Sse2 ? "sse2" : "scalar";
+}
+
+/**
+  * Finds the positions of delimiters in a text, with the instruction set of the level given if the
+  * processor supports it (else the best one it does).
+  *
+  * @param text - The text scanned
+  * @param delimiters - The delimiters (one to four characters)
+  * @param positions - The positions of the delimiters found, in order, filled
+  * @param count - The most positions found
+  * @param level - The scan level
+  *
+  * @return The number of positions found
+  */
+size_t findDelimiters(string_view text, string_view delimiters, uint32_t *positions, size_t count, ScanLevel level) {
+
+	if(level > getSupportedScanLevel()) {
+
+		level = getSupportedScanLevel();
+	}
+#ifdef DELIMITER_SCANNER_X86
+	if(level == ScanLevel::Avx2) {
+
+		return findDelimitersAvx2(text, delimiters, positions, count);
+	}
+	if(level == ScanLevel::Sse2) {
+
+		return findDelimitersSse2(text, delimiters, positions, count);
+	}
+#endif
+	return findDelimitersScalar(text, delimiters, positions, count);
+}
+
+/**
+  * Splits a line into fields at a delimiter, as successive calls to "getline(stream, field,
+  * delimiter)" on a stream of the line would: "a,,b," holds "a", "" and "b". The delimiters are
+  * found in bulk, as many at a time as fields are left to split.
+  *
+  * @param line - The line
+  * @param delimiter - The delimiter
+  * @param fields - The fields, filled
+  * @param count - The most fields split
+  * @param rest - If given, the text following the delimiter ending the last field split, empty when the
+  * line holds no more
+  *
+  * @return The number of fields split
+  */
+size_t splitFields(string_view line, char delimiter, string_view *fields, size_t count, string_view *rest) {
+
+	// the delimiters are found in groups of up to "batch", enough for the lines of the store's files at once
+	static const size_t batch = 16;
+	uint32_t positions[batch];
+	size_t split = 0;
+	size_t fieldStart = 0;
+	while(split < count && fieldStart < line.size()) {
+
+		string_view remaining = line.substr(fieldStart);
+		size_t wanted = min(batch, count - split);
+		size_t found = findDelimiters(remaining, string_view(&delimiter, 1), positions, wanted);
+		size_t previous = 0;
+		for(size_t i = 0; i < found; i++) {
+
+			fields[split++] = remaining.substr(previous, positions[i] - previous);
+			previous = positions[i] + 1;
+		}
+		fieldStart += previous;
+		if(found < wanted) {
+
+			// no delimiter follows the last field of the line (none at all if the line ends in one)
+			if(previous < remaining.size()) {
+
+				fields[split++] = remaining.substr(previous);
+			}
+			fieldStart = line.size();
+		}
+	}
+	if(rest != nullptr) {
+
+		*rest = line.substr(fieldStart);
+	}
+	return split;
+}
+
+/**
+  * Constructs a line scanner, no file opened.
+  *
+  * @param blockSize - The size of the block the file is read in
+  */
+LineScanner::LineScanner(size_t blockSize) : buffer(blockSize == 0 ? 1 : blockSize) {}
+
+LineScanner::~LineScanner() {
+
+	close();
+}
+
+/**
+  * Opens a file to read its lines.
+  *
+  * @param path - The path of the file
+  *
+  * @return Whether the file was opened
+  */
+bool LineScanner::open(const string &path) {
+
+	close();
+	fd = ::open(path.c_str(), O_RDONLY);
+	start = 0;
+	end = 0;
+	endOfFile = false;
+	newlineCount = 0;
+	nextNewline = 0;
+	return fd >= 0;
+}
+
+void LineScanner::close() {
+
+	if(fd >= 0) {
+
+		::close(fd);
+		fd = -1;
+	}
+}
+
+/**
+  * Moves the bytes not yet handed out to the front of the buffer, growing it when they fill it, reads
+  * more of the file after them and finds the newlines of the bytes read.
+  *
+  * @return Whether more of the file was read
+  */
+bool LineScanner::fill() {
+
+	if(endOfFile || fd < 0) {
+
+		return false;
+	}
+	memmove(buffer.data(), buffer.data() + start, end - start);
+	end -= start;
+	start = 0;
+	if(end == buffer.size()) {
+
+		buffer.resize(buffer.size() * 2);
+	}
+	ssize_t read;
+	do {
+
+		read = ::read(fd, buffer.data() + end, buffer.size() - end);
+	} while(read < 0 && errno == EINTR);
+	if(read <= 0) {
+
+		endOfFile = true;
+		return false;
+	}
+
+	// the bytes kept hold no newline, so only those read are scanned
+	size_t scanned = end;
+	end += read;
+	if(newlines.size() < (size_t) read) {
+
+		newlines.resize(read);
+	}
+	newlineCount = findDelimiters(string_view(buffer.data() + scanned, read), "\n", newlines.data(), read);
+	for(size_t i = 0; i < newlineCount; i++) {
+
+		newlines[i] += scanned;
+	}
+	nextNewline = 0;
+	return true;
+}
+
+/**
+  * Reads the next line of the file. A last line not ended by a newline is read as well; a newline
+  * ending the file starts no line.
+  *
+  * @param line - The line, without its newline (its carriage return, if any, is kept), assigned
+  *
+  * @return Whether a line was read
+  */
+bool LineScanner::next(string_view &line) {
+
+	while(nextNewline == newlineCount) {
+
+		if(!fill()) {
+
+			if(start == end) {
+
+				return false;
+			}
+			line = string_view(buffer.data() + start, end - start);
+			start = end;
+			return true;
+		}
+	}
+	size_t newline = newlines[nextNewline++];
+	line = string_view(buffer.data() + start, newline - start);
+	start = newline + 1;
+	return true;
+}
@@ -0,0 +1,118 @@
+#ifndef DELIMITERSCANNER_H
+#define DELIMITERSCANNER_H
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// the instruction sets delimiters are scanned with: 16 bytes at a time (SSE2) or 32 (AVX2), compared
+// against every delimiter at once, or one byte at a time. the best one the processor supports is
+// detected once and used unless lowered by "setScanLevel" or a scan names another (so they can be
+// compared and checked against each other).
+enum class ScanLevel { Scalar, Sse2, Avx2 };
+
+// gets the best scan level the processor supports (Scalar on other architectures)
+ScanLevel getSupportedScanLevel();
+
+// gets the scan level used when none is named: the supported one, unless lowered
+ScanLevel getScanLevel();
+
+// sets the scan level used when none is named (one the processor does not support is lowered to the
+// supported one)
+void setScanLevel(ScanLevel);
+
+// gets the name of a scan level ("scalar", "sse2" or "avx2")
+const char *getScanLevelName(ScanLevel);
+
+// finds the positions of the delimiters (first argument, one to four characters) in the text argument,
+// in order, into the positions argument, stopping once it holds the count argument; gets the number
+// found. the level argument, if supported, selects the instruction set.
+size_t findDelimiters(string_view, string_view, uint32_t *, size_t, ScanLevel = getScanLevel());
+
+// splits the line argument at the delimiter argument into at most the count argument of fields, as
+// reading the line with "getline(stream, field, delimiter)" would: empty fields are kept, but a
+// delimiter ending the line starts no field, and an empty line holds none. gets the number of fields;
+// the last argument, if given, receives the text after the delimiter ending the last field split
+// (empty when the line holds no more).
+size_t splitFields(string_view, char, string_view *, size_t, string_view * = nullptr);
+
+// parses a field (first argument) holding a decimal integer, optionally signed, into the second
+// argument with "from_chars": nothing is allocated or thrown. spaces, tabs and carriage returns around
+// the digits are ignored (a line of a file written on Windows ends in one); anything else, an empty
+// field or a value out of the range of the type fails, leaving the argument unchanged. gets whether
+// the field held an integer.
+template <typename Integer>
+bool parseIntegerField(string_view field, Integer &value) {
+
+	size_t first = field.find_first_not_of(" \t\r");
+	if(first == string_view::npos) {
+
+		return false;
+	}
+	field = field.substr(first, field.find_last_not_of(" \t\r") + 1 - first);
+	if(field[0] == '+' && field.size() > 1 && field[1] != '-') {
+
+		field.remove_prefix(1);
+	}
+	Integer parsed;
+	from_chars_result result = from_chars(field.data(), field.data() + field.size(), parsed);
+	if(result.ec != errc() || result.ptr != field.data() + field.size()) {
+
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+// reads the lines of a file block by block, as "getline(file, line)" would: the newlines of a block are
+// found in bulk and its lines handed out as views into it, valid until the next line is read. a line
+// longer than the block grows it.
+class LineScanner {
+
+private:
+
+	int fd = -1;
+
+	// the block read: the line handed out next starts at "start", and the bytes read end at "end"
+	vector<char> buffer;
+	size_t start = 0;
+	size_t end = 0;
+	bool endOfFile = false;
+
+	// the newlines found in the bytes last read (the first "newlineCount"), and the next one to end a line
+	vector<uint32_t> newlines;
+	size_t newlineCount = 0;
+	size_t nextNewline = 0;
+
+	// moves the bytes from "start" to the front of the buffer (grown if they fill it), reads more of the
+	// file after them and finds their newlines; false once nothing more is read
+	bool fill();
+
+public:
+
+	// the size of the block unless the constructor is given another
+	static const size_t defaultBlockSize = 1 << 20;
+
+	// LineScanner constructor - the size of the block
+	LineScanner(size_t = defaultBlockSize);
+
+	// LineScanner destructor - closes the file
+	~LineScanner();
+
+	LineScanner(const LineScanner&) = delete;
+	LineScanner &operator=(const LineScanner&) = delete;
+
+	// opens the file at the path argument; false if it could not be opened
+	bool open(const string &);
+
+	// reads the next line (without its newline) into the argument; false at the end of the file
+	bool next(string_view &);
+
+	void close();
+};
+
+#endif
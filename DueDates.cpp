@@ -0,0 +1,240 @@
+#include "DueDates.h"
+
+#include <algorithm>
+
+/**
+  * Adds a rental to the wheel bucket of the hour it is due, or beyond the wheel if due further ahead
+  * than it reaches. A rental due in an hour already emptied goes to the bucket of the current hour.
+  *
+  * @param rental - The ID of the rental
+  */
+void DueDates::schedule(uint32_t rental) {
+
+	long long hour = max(rentals[rental].dueTime / bucketSeconds, currentHour);
+	place(rental, hour < currentHour + wheelSize ? hour % wheelSize : overflowBucket);
+}
+
+/**
+  * Adds a rental to the end of a bucket.
+  *
+  * @param rental - The ID of the rental
+  * @param bucket - The bucket
+  */
+void DueDates::place(uint32_t rental, uint32_t bucket) {
+
+	rentals[rental].bucket = bucket;
+	rentals[rental].position = buckets[bucket].size();
+	buckets[bucket].push_back({rentals[rental].dueTime, rental});
+}
+
+/**
+  * Removes a rental from a bucket, the last rental of the bucket filling its position.
+  *
+  * @param bucket - The bucket
+  * @param position - The position of the rental in the bucket
+  */
+void DueDates::unplace(uint32_t bucket, uint32_t position) {
+
+	Entry last = buckets[bucket].back();
+	buckets[bucket].pop_back();
+	if(position < buckets[bucket].size()) {
+
+		buckets[bucket][position] = last;
+		rentals[last.rental].position = position;
+	}
+}
+
+/**
+  * Moves the rentals due beyond the wheel that it now reaches to their buckets. Called every half
+  * turn of the wheel, so every rental is moved before the wheel reaches the hour it is due.
+  */
+void DueDates::rescheduleOverflow() {
+
+	vector<Entry> overflow;
+	overflow.swap(buckets[overflowBucket]);
+	for(const Entry &entry : overflow) {
+
+		schedule(entry.rental);
+	}
+}
+
+/**
+  * Opens a rental. The rental is pending until "advance" passes its due time (even if it is due
+  * already).
+  *
+  * @param copy - The borrowed movie record held by the customer's borrow list
+  * @param custID - The ID of the customer
+  * @param borrowTime - The time of the borrow
+  * @param dueTime - The time the copy is due back
+  */
+void DueDates::add(const Movie *copy, int custID, long long borrowTime, long long dueTime) {
+
+	if(currentHour < 0) {
+
+		currentHour = borrowTime / bucketSeconds;
+	}
+	uint32_t rental;
+	if(freeRentals.empty()) {
+
+		rental = rentals.size();
+		rentals.push_back(Rental());
+	}
+	else {
+
+		rental = freeRentals.back();
+		freeRentals.pop_back();
+	}
+	rentals[rental] = {copy, custID, borrowTime, dueTime, 0, 0};
+	rentalsByCopy[copy] = rental;
+	schedule(rental);
+}
+
+/**
+  * Closes the rental of a borrowed movie record, pending or overdue.
+  *
+  * @param copy - The borrowed movie record
+  * @param removed - Receives the rental closed
+  *
+  * @return Whether a rental of the record was open
+  */
+bool DueDates::remove(const Movie *copy, Rental &removed) {
+
+	unordered_map<const Movie*, uint32_t>::iterator found = rentalsByCopy.find(copy);
+	if(found == rentalsByCopy.end()) {
+
+		return false;
+	}
+	uint32_t rental = found->second;
+	rentalsByCopy.erase(found);
+	removed = rentals[rental];
+	unplace(removed.bucket, removed.position);
+	freeRentals.push_back(rental);
+	return true;
+}
+
+/**
+  * Gets the rental open for a borrowed movie record, pending or overdue, leaving it open.
+  *
+  * @param copy - The borrowed movie record
+  * @param found - Receives the rental
+  *
+  * @return Whether a rental of the record is open
+  */
+bool DueDates::find(const Movie *copy, Rental &found) const {
+
+	unordered_map<const Movie*, uint32_t>::const_iterator rental = rentalsByCopy.find(copy);
+	if(rental == rentalsByCopy.end()) {
+
+		return false;
+	}
+	found = rentals[rental->second];
+	return true;
+}
+
+/**
+  * Moves the rentals due before a time to the rentals overdue (a nightly late fee run, or a
+  * query of who is overdue now, calls it first). The buckets of the hours passed since the last
+  * call are emptied whole, and the bucket of the current hour is checked rental by rental.
+  *
+  * @param now - The time
+  *
+  * @return The number of rentals that became overdue
+  */
+size_t DueDates::advance(long long now) {
+
+	long long nowHour = now / bucketSeconds;
+	if(currentHour < 0) {
+
+		currentHour = nowHour;
+	}
+	size_t expired = 0;
+	long long hoursPassed = nowHour - currentHour;
+	for(long long hour = currentHour; hour < currentHour + min(hoursPassed, (long long) wheelSize); hour++) {
+
+		vector<Entry> &bucket = buckets[hour % wheelSize];
+		for(const Entry &entry : bucket) {
+
+			place(entry.rental, overdueBucket);
+		}
+		expired += bucket.size();
+		bucket.clear();
+	}
+	if(hoursPassed > 0) {
+
+		long long previousHour = currentHour;
+		currentHour = nowHour;
+		if(currentHour / (wheelSize / 2) != previousHour / (wheelSize / 2)) {
+
+			rescheduleOverflow();
+		}
+	}
+
+	// the bucket of the current hour holds rentals due before and after the time
+	uint32_t current = currentHour % wheelSize;
+	for(size_t position = buckets[current].size(); position > 0; position--) {
+
+		Entry entry = buckets[current][position - 1];
+		if(entry.dueTime < now) {
+
+			unplace(current, position - 1);
+			place(entry.rental, overdueBucket);
+			expired++;
+		}
+	}
+	return expired;
+}
+
+/**
+  * Gets the days a rental is late at a time, every day started counting as a day.
+  *
+  * @param rental - The rental
+  * @param now - The time
+  *
+  * @return The days late, 0 if the rental is not late
+  */
+long long DueDates::getDaysLate(const Rental &rental, long long now) {
+
+	if(now <= rental.dueTime) {
+
+		return 0;
+	}
+	return (now - rental.dueTime + secondsPerDay - 1) / secondsPerDay;
+}
+
+/**
+  * Gets the number of rentals open, pending and overdue.
+  *
+  * @return The number of rentals
+  */
+size_t DueDates::getOpenCount() const {
+
+	return rentalsByCopy.size();
+}
+
+/**
+  * Gets the number of rentals overdue, as of the last "advance".
+  *
+  * @return The number of rentals overdue
+  */
+size_t DueDates::getOverdueCount() const {
+
+	return buckets[overdueBucket].size();
+}
+
+/**
+  * Gets the bytes held by the rentals: the rentals, the buckets of the wheel and the hash map of the
+  * borrowed records (nodes and buckets, approximately).
+  *
+  * @return The bytes held
+  */
+size_t DueDates::getBytes() const {
+
+	const size_t nodeOverhead = 2 * sizeof(void*);
+	size_t bytes = rentals.capacity() * sizeof(Rental) + freeRentals.capacity() * sizeof(uint32_t) + sizeof(buckets)
+		+ rentalsByCopy.size() * (sizeof(pair<const Movie*, uint32_t>) + nodeOverhead) + rentalsByCopy.bucket_count() * sizeof(void*);
+	for(const vector<Entry> &bucket : buckets) {
+
+		bytes += bucket.capacity() * sizeof(Entry);
+	}
+	return bytes;
+}
@@ -0,0 +1,123 @@
+#ifndef DUEDATES_H
+#define DUEDATES_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class Movie;
+
+// the borrow and due times of every rental open, each rental named by the borrowed movie record the
+// customer's borrow list holds. rentals not yet due are kept in a timer wheel: a ring of buckets, each
+// holding the rentals due within one hour, the rentals due further ahead than the ring reaches kept
+// aside until it turns to them. "advance" moves the rentals whose due time has passed to the list of
+// rentals overdue, emptying whole buckets and checking only the bucket of the current hour; finding
+// who is overdue therefore costs the rentals expiring (and those due later in the hour), however many
+// rentals are open. times are in seconds (since the epoch for the store).
+class DueDates {
+
+public:
+
+	// a rental open
+	struct Rental {
+
+		// the borrowed movie record and the customer holding it
+		const Movie *copy;
+		int custID;
+
+		long long borrowTime;
+		long long dueTime;
+
+		// the bucket of the wheel holding the rental (or "overflowBucket", "overdueBucket"), and the
+		// rental's position in it
+		uint32_t bucket;
+		uint32_t position;
+	};
+
+	// the seconds of a day (late fees are charged per day late, started)
+	static constexpr long long secondsPerDay = 86400;
+
+private:
+
+	// a rental held by a bucket, with its due time (so a bucket is checked without visiting its rentals)
+	struct Entry {
+
+		long long dueTime;
+		uint32_t rental;
+	};
+
+	// the seconds covered by a bucket, and the number of buckets of the wheel (about 170 days)
+	static constexpr long long bucketSeconds = 3600;
+	static constexpr uint32_t wheelSize = 4096;
+
+	// the buckets of the rentals due beyond the wheel, and of the rentals overdue
+	static constexpr uint32_t overflowBucket = wheelSize;
+	static constexpr uint32_t overdueBucket = wheelSize + 1;
+
+	// the rentals by ID, and the IDs of the unused ones
+	vector<Rental> rentals;
+	vector<uint32_t> freeRentals;
+
+	// the ID of the rental of every borrowed movie record
+	unordered_map<const Movie*, uint32_t> rentalsByCopy;
+
+	// the buckets of the wheel, then the rentals due beyond it, then the rentals overdue
+	vector<Entry> buckets[wheelSize + 2];
+
+	// the hour (time divided by "bucketSeconds") of the first bucket not emptied yet, -1 until the
+	// first rental is added or the first advance
+	long long currentHour = -1;
+
+	// adds a rental (its ID) to the wheel bucket of its due time, or beyond the wheel
+	void schedule(uint32_t);
+
+	// adds a rental (first argument, its ID) to the end of a bucket (second argument)
+	void place(uint32_t, uint32_t);
+
+	// removes the rental at the position (second argument) of a bucket (first argument); the last
+	// rental of the bucket fills the gap
+	void unplace(uint32_t, uint32_t);
+
+	// moves the rentals due beyond the wheel that it now reaches to their buckets
+	void rescheduleOverflow();
+
+public:
+
+	// opens a rental: the borrowed movie record, the customer, the borrow time and the due time
+	void add(const Movie *, int, long long, long long);
+
+	// closes the rental of a borrowed movie record, copied to the second argument; false if none is open
+	bool remove(const Movie *, Rental &);
+
+	// gets the rental open for a borrowed movie record (second argument receives it); false if none is
+	bool find(const Movie *, Rental &) const;
+
+	// moves the rentals due before the time argument to the rentals overdue; gets their number
+	size_t advance(long long);
+
+	// calls the visitor argument with every rental overdue (as of the last "advance"), in no order
+	template <typename Visitor>
+	void forEachOverdue(Visitor visitor) const {
+
+		for(const Entry &entry : buckets[overdueBucket]) {
+
+			visitor(rentals[entry.rental]);
+		}
+	}
+
+	// gets the days (started) a rental (first argument) is late at the time argument, 0 if not late
+	static long long getDaysLate(const Rental &, long long);
+
+	// gets the number of rentals open
+	size_t getOpenCount() const;
+
+	// gets the number of rentals overdue (as of the last "advance")
+	size_t getOverdueCount() const;
+
+	// gets the bytes held by the rentals
+	size_t getBytes() const;
+};
+
+#endif
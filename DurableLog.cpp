@@ -0,0 +1,308 @@
+#include "DurableLog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+/**
+  * Constructor leaves the log closed. "open" must be called before records are appended.
+  */
+DurableLog::DurableLog() {}
+
+/**
+  * Destructor stops the writer thread once every appended record has been written, then closes
+  * the log file and the notification descriptor.
+  */
+DurableLog::~DurableLog() {
+
+	if(writer.joinable()) {
+
+		{
+			lock_guard<mutex> lock(pendingMutex);
+			stopping = true;
+		}
+		pendingCondition.notify_one();
+		writer.join();
+	}
+	if(logFd != -1) {
+
+		close(logFd);
+	}
+	if(notificationFd != -1) {
+
+		close(notificationFd);
+	}
+}
+
+/**
+  * Opens the log file for appending and starts the writer thread.
+  *
+  * @param path - The directory of the log file (created if missing)
+  * @param sync - Whether every batch is fdatasync'ed before it is reported durable
+  *
+  * @return The success status of the open
+  */
+bool DurableLog::open(string path, bool sync) {
+
+	logFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if(logFd == -1) {
+
+		cout << "Could not open log file " << path << ": " << strerror(errno) << endl;
+		return false;
+	}
+	notificationFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(notificationFd == -1) {
+
+		cout << "Could not create eventfd: " << strerror(errno) << endl;
+		return false;
+	}
+	syncWrites = sync;
+	writer = thread(&DurableLog::writeLoop, this);
+	return true;
+}
+
+/**
+  * Writer thread body. Takes every record appended since the last batch, writes the batch with a
+  * single write and (optionally) a single fdatasync, then publishes the new durable sequence and
+  * signals the notification descriptor. If the write or the fdatasync fails, the file is cut back to
+  * where the batch started (so no torn record is left for later records to follow), the log is put
+  * in its failed state with the durable sequence left where it was, every waiter is released, and
+  * the thread stops.
+  */
+void DurableLog::writeLoop() {
+
+	string batch;
+	unique_lock<mutex> lock(pendingMutex);
+	while(true) {
+
+		pendingCondition.wait(lock, [this] { return !pendingRecords.empty() || stopping; });
+		if(pendingRecords.empty() && stopping) {
+
+			return;
+		}
+		batch.swap(pendingRecords);
+		unsigned long long batchSequence = appendedSequence;
+		lock.unlock();
+
+		off_t batchStart = lseek(logFd, 0, SEEK_END);
+		string error;
+		size_t written = 0;
+		while(written < batch.size()) {
+
+			ssize_t result = write(logFd, batch.data() + written, batch.size() - written);
+			if(result == -1) {
+
+				if(errno == EINTR) {
+
+					continue;
+				}
+				error = string("write: ") + strerror(errno);
+				break;
+			}
+			written += result;
+		}
+		if(error == "" && syncWrites && fdatasync(logFd) == -1) {
+
+			error = string("fdatasync: ") + strerror(errno);
+		}
+		batch.clear();
+		if(error != "") {
+
+			cerr << "Log write failed: " << error << endl;
+			if(batchStart != -1 && ftruncate(logFd, batchStart) == -1) {
+
+				cerr << "Could not remove the failed batch from the log: " << strerror(errno) << endl;
+			}
+			lock.lock();
+			failure = error;
+			failed.store(true);
+			pendingRecords.clear();
+			durableCondition.notify_all();
+			unsigned long long one = 1;
+			ssize_t signalled = ::write(notificationFd, &one, sizeof(one));
+			(void) signalled;
+			return;
+		}
+
+		lock.lock();
+		durableSequence.store(batchSequence);
+		durableCondition.notify_all();
+		unsigned long long one = 1;
+		ssize_t signalled = ::write(notificationFd, &one, sizeof(one));
+		(void) signalled;
+	}
+}
+
+/**
+  * Appends a record to the pending batch. The record is not durable until the writer thread has
+  * written it; use "onDurable" or "waitUntilDurable" to wait for that. Once the log has failed, the
+  * record is dropped.
+  *
+  * @param record - The record (a single line, without newline)
+  *
+  * @return The sequence number of the record, 0 if the log has failed
+  */
+unsigned long long DurableLog::append(string_view record) {
+
+	unsigned long long sequence;
+	{
+		lock_guard<mutex> lock(pendingMutex);
+		if(failed.load()) {
+
+			return 0;
+		}
+		sequence = ++appendedSequence;
+		pendingRecords += record;
+		pendingRecords += '\n';
+	}
+	pendingCondition.notify_one();
+	return sequence;
+}
+
+/**
+  * Gets the sequence number of the last appended record.
+  *
+  * @return The last appended sequence number (0 if none)
+  */
+unsigned long long DurableLog::getAppendedSequence() {
+
+	lock_guard<mutex> lock(pendingMutex);
+	return appendedSequence;
+}
+
+/**
+  * Gets the sequence number of the last record known to be durable.
+  *
+  * @return The durable sequence number (0 if none)
+  */
+unsigned long long DurableLog::getDurableSequence() {
+
+	return durableSequence.load();
+}
+
+/**
+  * Registers a continuation run once the sequence is durable, or the log has failed. If either is
+  * already so, the continuation runs on the next call to "runCompletedContinuations".
+  *
+  * @param sequence - The sequence number waited for
+  * @param continuation - The function run once the sequence is durable
+  */
+void DurableLog::onDurable(unsigned long long sequence, function<void()> continuation) {
+
+	continuations.insert(make_pair(sequence, continuation));
+	if(sequence <= durableSequence.load() || failed.load()) {
+
+		unsigned long long one = 1;
+		ssize_t signalled = ::write(notificationFd, &one, sizeof(one));
+		(void) signalled;
+	}
+}
+
+/**
+  * Clears the notification descriptor and runs, in sequence order, every continuation whose
+  * sequence is durable, or every continuation once the log has failed (the sequences above the
+  * durable one will never be).
+  */
+void DurableLog::runCompletedContinuations() {
+
+	unsigned long long signals;
+	ssize_t cleared = read(notificationFd, &signals, sizeof(signals));
+	(void) cleared;
+	unsigned long long durable = durableSequence.load();
+	bool releasingAll = failed.load();
+	while(!continuations.empty() && (releasingAll || continuations.begin()->first <= durable)) {
+
+		function<void()> continuation = continuations.begin()->second;
+		continuations.erase(continuations.begin());
+		continuation();
+	}
+}
+
+/**
+  * Blocks until the sequence argument is durable, or the log has failed.
+  *
+  * @param sequence - The sequence number waited for
+  *
+  * @return Whether the sequence is durable (false if the log failed before it was written)
+  */
+bool DurableLog::waitUntilDurable(unsigned long long sequence) {
+
+	unique_lock<mutex> lock(pendingMutex);
+	durableCondition.wait(lock, [this, sequence] { return durableSequence.load() >= sequence || failed.load(); });
+	return durableSequence.load() >= sequence;
+}
+
+/**
+  * Evaluates whether a write or fdatasync of the log failed. Once it has, nothing more is written.
+  *
+  * @return Whether the log has failed
+  */
+bool DurableLog::hasFailed() {
+
+	return failed.load();
+}
+
+/**
+  * Gets why the log failed, e.g. "fdatasync: Input/output error".
+  *
+  * @return The failed call and its error, empty unless the log has failed
+  */
+string DurableLog::getFailure() {
+
+	lock_guard<mutex> lock(pendingMutex);
+	return failure;
+}
+
+/**
+  * Gets the descriptor signalled whenever the durable sequence advances. Meant to be registered
+  * for reads with the owner's event loop.
+  *
+  * @return The notification descriptor
+  */
+int DurableLog::getNotificationFd() {
+
+	return notificationFd;
+}
+
+/**
+  * Reads every record of an existing log file, oldest first. A missing file holds no records; a last
+  * record not ended by a newline was torn by a failed write: it is not read, and is cut off the file.
+  *
+  * @param path - The directory of the log file
+  * @param records - Receives the records
+  *
+  * @return Whether the file existed and was read
+  */
+bool DurableLog::readRecords(string path, vector<string> &records) {
+
+	ifstream readFile(path);
+	if(!readFile) {
+
+		return false;
+	}
+	string line;
+	streamoff lineStart = 0;
+	while(getline(readFile, line)) {
+
+		// a torn record is cut off the file, so the records appended next start on a line of their own
+		if(readFile.eof()) {
+
+			cout << "Skipped a torn last record of the log file: " << line << endl;
+			if(truncate(path.c_str(), lineStart) == -1) {
+
+				cout << "Could not remove the torn record from the log file: " << strerror(errno) << endl;
+			}
+			break;
+		}
+		lineStart = readFile.tellg();
+		if(line != "") {
+
+			records.push_back(line);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,105 @@
+#ifndef DURABLELOG_H
+#define DURABLELOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a write-ahead log of the store's state changing commands. records are appended by the command path
+// without touching the disk; a dedicated writer thread writes and fdatasyncs them in batches (group
+// commit). every record gets a sequence number, and callers register continuations that run, on the
+// owner's thread, once the record with a given sequence number is durable. this lets an event loop
+// keep executing other commands while a response waits for its commit. a failed write or fdatasync
+// puts the log in a failed state: the batch is cut from the file, no record is written after it, and
+// the records not yet durable never become durable (waits and continuations are released, reporting
+// so through "waitUntilDurable" and "hasFailed").
+class DurableLog {
+
+private:
+
+	// descriptor of the log file
+	int logFd = -1;
+
+	// eventfd signalled by the writer thread whenever the durable sequence advances
+	int notificationFd = -1;
+
+	// whether every batch is fdatasync'ed before being reported durable
+	bool syncWrites = true;
+
+	// the writer thread and the state shared with it
+	thread writer;
+	mutex pendingMutex;
+	condition_variable pendingCondition;
+	condition_variable durableCondition;
+	string pendingRecords;
+	bool stopping = false;
+
+	// the sequence number of the last appended record, and of the last record known to be durable
+	unsigned long long appendedSequence = 0;
+	atomic<unsigned long long> durableSequence{0};
+
+	// whether a write or fdatasync failed, and why (guarded by "pendingMutex")
+	atomic<bool> failed{false};
+	string failure;
+
+	// continuations waiting for a sequence number to become durable (owner thread only)
+	multimap<unsigned long long, function<void()>> continuations;
+
+	// body of the writer thread - writes and syncs pending records until stopped
+	void writeLoop();
+
+public:
+
+	// DurableLog constructor - the log is unusable until "open" succeeds
+	DurableLog();
+
+	// DurableLog destructor - flushes every appended record, then stops the writer thread
+	~DurableLog();
+
+	// opens (appending to) the log file at the path argument and starts the writer thread.
+	// second argument disables fdatasync when false
+	bool open(string, bool syncWrites = true);
+
+	// appends a record and returns its sequence number, or 0 (the record dropped) once the log has
+	// failed. never blocks on the disk
+	unsigned long long append(string_view);
+
+	// gets the sequence number of the last appended record
+	unsigned long long getAppendedSequence();
+
+	// gets the sequence number of the last record known to be durable
+	unsigned long long getDurableSequence();
+
+	// registers a continuation to be run by "runCompletedContinuations" once the sequence is durable,
+	// or the log has failed (the continuation then finds the sequence above "getDurableSequence")
+	void onDurable(unsigned long long, function<void()>);
+
+	// runs every continuation whose sequence is durable, or all of them once the log has failed.
+	// called from the owner's event loop when the notification descriptor becomes readable
+	void runCompletedContinuations();
+
+	// blocks the caller until the sequence argument is durable; false if the log failed first
+	bool waitUntilDurable(unsigned long long);
+
+	// evaluates whether a write or fdatasync of the log failed
+	bool hasFailed();
+
+	// gets why the log failed (empty unless it has)
+	string getFailure();
+
+	// gets the descriptor that becomes readable whenever the durable sequence advances
+	int getNotificationFd();
+
+	// reads the command of every record in the log file at the path argument, oldest first
+	static bool readRecords(string, vector<string> &);
+};
+
+#endif
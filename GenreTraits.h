@@ -0,0 +1,662 @@
+#ifndef GENRETRAITS_H
+#define GENRETRAITS_H
+
+#include "MovieRentalStore.h"
+
+// compile time description of every genre the store carries. the movie file and borrow/return
+// paths are written once, as templates over the genre's movie class, and instantiated per genre
+// from its traits: the movie line and command parsers, the text titles are searched and indexed
+// by, the ranges availability queries name, the inventory holding the genre, the latency histogram it is timed in and its name in transactions. the movie classes are final, so comparisons, sort keys and sorting criteria
+// are resolved at compile time rather than through the vtable. supporting a new genre takes a
+// movie class with a "code", a specialization below and an entry in "StoreGenres".
+template <typename MovieType>
+struct GenreTraits;
+
+/**
+ * Parses a comedy or drama line of the movie file (comma delimited): genre, stock, director, title
+ * and release year.
+ *
+ * @param movieLine - The movie file line
+ * @param catalog - The catalog configuration, whose formats the stock field lists
+ * @param formatStock - The stock of the movie in every format, filled
+ * @param director - The movie's director, filled
+ * @param title - The movie's title, filled
+ * @param releaseYear - The movie's release year, filled
+ *
+ * @return Whether the stock field and release year were valid and no field was empty (numbers are parsed
+ * without throwing, see "parseIntegerField"; an invalid one is reported)
+ */
+inline bool parseDefaultMovieLine(string_view movieLine, const CatalogConfig &catalog, int *formatStock, string &director,
+	string &title, short int &releaseYear) {
+
+	// the comma delimited tokens of the line (any following the release year are ignored)
+	string_view movieParameters[5];
+	size_t parameterCount = splitFields(movieLine, ',', movieParameters, 5);
+
+	// loop parses through movie line and assigns movie's parameters
+	for(size_t parameterCounter = 1; parameterCounter <= parameterCount; parameterCounter++) {
+
+		// an empty field (two commas) holds not even the space leading its text
+		if(movieParameters[parameterCounter - 1].empty()) {
+
+			cout << "Field " << parameterCounter << " is empty. Movie was not added to inventory." << endl;
+			return false;
+		}
+
+		// get token removing starting space character
+		string_view cleanedParameter = movieParameters[parameterCounter - 1].substr(1);
+
+		// depending on loop iteration, assign different movie parameters
+		switch(parameterCounter) {
+
+			case 1:
+				break;
+
+			case 2:
+				if(!catalog.parseStock(cleanedParameter, formatStock)) {
+
+					cout << "Movie was not added to inventory." << endl;
+					return false;
+				}
+				break;
+			case 3:
+				director = cleanedParameter;
+				break;
+			case 4:
+				title = cleanedParameter;
+				break;
+			case 5:
+				if(!parseIntegerField(cleanedParameter, releaseYear) || releaseYear < 0) {
+
+					cout << "Invalid release year: " << cleanedParameter << ". Movie was not added to inventory." << endl;
+					return false;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Evaluates whether every name of the movie of a borrow/return command is in the string table,
+ * without interning any: a name not in it is held by no title carried, so the movie is not in
+ * inventory, and the command cannot grow the table with names no title holds.
+ *
+ * @param names - The names (title, director or major actor) the movie would be constructed from
+ *
+ * @return Whether every name is interned
+ */
+inline bool namesInterned(initializer_list<string_view> names) {
+
+	uint32_t index;
+	for(string_view name : names) {
+
+		if(!StringTable::find(name, index)) {
+
+			return false;
+		}
+	}
+	return true;
+}
+
+template <>
+struct GenreTraits<Comedy> {
+
+	// name of the genre in transactions
+	static constexpr const char *name = "comedy";
+
+	// the store's inventory of the genre, and the histogram of its borrow/return latency
+	static constexpr InventoryTree<Comedy> MovieRentalStore::*inventory = &MovieRentalStore::comedyMovieInventory;
+	static constexpr LatencyHistogram StoreStatistics::*latency = &StoreStatistics::comedyLatency;
+
+	/**
+	 * Parses a line of the movie file into a comedy.
+	 *
+	 * @param movieLine - The movie file line
+	 * @param catalog - The catalog configuration, whose formats the stock field lists
+	 * @param movie - The comedy, assigned
+	 * @param formatStock - The stock of the movie in every format, filled
+	 *
+	 * @return Whether the line was valid
+	 */
+	static bool parseMovieLine(string_view movieLine, const CatalogConfig &catalog, Comedy &movie, int *formatStock) {
+
+		string director;
+		string title;
+		short int releaseYear = 0;
+		if(!parseDefaultMovieLine(movieLine, catalog, formatStock, director, title, releaseYear)) {
+
+			return false;
+		}
+		movie = Comedy(releaseYear, title, director, formatStock[0]);
+		return true;
+	}
+
+	/**
+	 * Gets the text a comedy title is searched by in the title search index.
+	 *
+	 * @param movie - The movie
+	 *
+	 * @return Its title, release year and director
+	 */
+	static string getSearchText(const Comedy &movie) {
+
+		return string(movie.getTitle()) + ", " + to_string(movie.getReleaseYear()) + ", " + string(movie.getDirector());
+	}
+
+	/**
+	 * Parses the query of an availability command into a range of comedies: the titles starting
+	 * with the query (every title when it is empty).
+	 *
+	 * @param query - The query, e.g. "You've"
+	 * @param range - The range, assigned
+	 *
+	 * @return Whether the query was valid
+	 */
+	static bool parseAvailabilityRange(const string &query, SortKeyRange &range) {
+
+		range.lastNumber = 0;
+		range.textPrefix = query;
+		return true;
+	}
+
+	// gets the major actor of a movie (none: comedies have no major actor)
+	static string_view getMajorActor(const Comedy &movie) {
+
+		(void) movie;
+		return string_view();
+	}
+
+	// gets the release month of a movie (none: comedies only have a release year)
+	static int getReleaseMonth(const Comedy &movie) {
+
+		(void) movie;
+		return 0;
+	}
+
+	// constructs a comedy from the fields of a state record (see MovieRentalStore::exportState); the
+	// month and major actor are ignored
+	static Comedy makeMovie(const string &director, const string &title, int releaseYear, int releaseMonth, const string &majorActor, int stock) {
+
+		(void) releaseMonth;
+		(void) majorActor;
+		return Comedy(releaseYear, title, director, stock);
+	}
+
+	/**
+	 * Parses the movie of a borrow/return command into a movie holding its sorting criteria.
+	 * Expected movie format: Pirate of the Caribbean, 2003 (title, release year)
+	 *
+	 * @param movieParameters - The rest of the command line, following the genre code
+	 * @param movie - The comedy movie, assigned if its title is interned
+	 * @param carried - Whether its title is interned (else no comedy carried has it), assigned
+	 *
+	 * @return Whether the release year, if given, was a number (parsed without throwing)
+	 */
+	static bool parseCommand(string_view movieParameters, Comedy &movie, bool &carried) {
+
+		string_view parameters[2];
+		size_t count = splitFields(movieParameters, ',', parameters, 2);
+		string_view title;
+		short int releaseYear = 0;
+		for(size_t counter = 0; counter < count; counter++) {
+
+			switch(counter) {
+
+				case 0:
+					title = parameters[counter];
+					break;
+				case 1:
+					if(!parseIntegerField(parameters[counter], releaseYear)) {
+
+						return false;
+					}
+					break;
+				default:
+					break;
+			}
+		}
+		carried = namesInterned({title});
+		if(carried) {
+
+			movie = Comedy(releaseYear, title);
+		}
+		return true;
+	}
+};
+
+template <>
+struct GenreTraits<Drama> {
+
+	// name of the genre in transactions
+	static constexpr const char *name = "drama";
+
+	// the store's inventory of the genre, and the histogram of its borrow/return latency
+	static constexpr InventoryTree<Drama> MovieRentalStore::*inventory = &MovieRentalStore::dramaMovieInventory;
+	static constexpr LatencyHistogram StoreStatistics::*latency = &StoreStatistics::dramaLatency;
+
+	/**
+	 * Parses a line of the movie file into a drama.
+	 *
+	 * @param movieLine - The movie file line
+	 * @param catalog - The catalog configuration, whose formats the stock field lists
+	 * @param movie - The drama, assigned
+	 * @param formatStock - The stock of the movie in every format, filled
+	 *
+	 * @return Whether the line was valid
+	 */
+	static bool parseMovieLine(string_view movieLine, const CatalogConfig &catalog, Drama &movie, int *formatStock) {
+
+		string director;
+		string title;
+		short int releaseYear = 0;
+		if(!parseDefaultMovieLine(movieLine, catalog, formatStock, director, title, releaseYear)) {
+
+			return false;
+		}
+		movie = Drama(director, title, releaseYear, formatStock[0]);
+		return true;
+	}
+
+	/**
+	 * Gets the text a drama title is searched by in the title search index.
+	 *
+	 * @param movie - The movie
+	 *
+	 * @return Its title, release year and director
+	 */
+	static string getSearchText(const Drama &movie) {
+
+		return string(movie.getTitle()) + ", " + to_string(movie.getReleaseYear()) + ", " + string(movie.getDirector());
+	}
+
+	/**
+	 * Parses the query of an availability command into a range of dramas: the dramas whose
+	 * director starts with the query (every drama when it is empty).
+	 *
+	 * @param query - The query, e.g. "Barry Levinson"
+	 * @param range - The range, assigned
+	 *
+	 * @return Whether the query was valid
+	 */
+	static bool parseAvailabilityRange(const string &query, SortKeyRange &range) {
+
+		range.lastNumber = 0;
+		range.textPrefix = query;
+		return true;
+	}
+
+	// gets the major actor of a movie (none: dramas have no major actor)
+	static string_view getMajorActor(const Drama &movie) {
+
+		(void) movie;
+		return string_view();
+	}
+
+	// gets the release month of a movie (none: dramas only have a release year)
+	static int getReleaseMonth(const Drama &movie) {
+
+		(void) movie;
+		return 0;
+	}
+
+	// constructs a drama from the fields of a state record (see MovieRentalStore::exportState); the
+	// month and major actor are ignored
+	static Drama makeMovie(const string &director, const string &title, int releaseYear, int releaseMonth, const string &majorActor, int stock) {
+
+		(void) releaseMonth;
+		(void) majorActor;
+		return Drama(director, title, releaseYear, stock);
+	}
+
+	/**
+	 * Parses the movie of a borrow/return command into a movie holding its sorting criteria.
+	 * Expected movie format: Gore Verbinski, Pirate of the Caribbean, (director, title)
+	 *
+	 * @param movieParameters - The rest of the command line, following the genre code
+	 * @param movie - The drama movie, assigned if its director and title are interned
+	 * @param carried - Whether its director and title are interned (else no drama carried has them), assigned
+	 *
+	 * @return Whether the movie was parsed (false if its title field is empty)
+	 */
+	static bool parseCommand(string_view movieParameters, Drama &movie, bool &carried) {
+
+		string_view parameters[2];
+		size_t count = splitFields(movieParameters, ',', parameters, 2);
+		string_view director;
+		string_view title;
+		for(size_t counter = 0; counter < count; counter++) {
+
+			switch(counter) {
+
+				case 0:
+					director = parameters[counter];
+					break;
+				case 1:
+
+					// an empty title field (two commas) holds not even the space leading the title
+					if(parameters[counter].empty()) {
+
+						return false;
+					}
+					title = parameters[counter].substr(1);
+					break;
+				default:
+					break;
+			}
+		}
+		carried = namesInterned({director, title});
+		if(carried) {
+
+			movie = Drama(director, title);
+		}
+		return true;
+	}
+};
+
+template <>
+struct GenreTraits<Classics> {
+
+	// name of the genre in transactions
+	static constexpr const char *name = "classics";
+
+	// the store's inventory of the genre, and the histogram of its borrow/return latency
+	static constexpr InventoryTree<Classics> MovieRentalStore::*inventory = &MovieRentalStore::classicsMovieInventory;
+	static constexpr LatencyHistogram StoreStatistics::*latency = &StoreStatistics::classicsLatency;
+
+	/**
+	 * Parses a line of the movie file into a classics movie (comma delimited): genre, stock,
+	 * director, title, then major actor and release date (space delimited).
+	 *
+	 * @param movieLine - The movie file line
+	 * @param catalog - The catalog configuration, whose formats the stock field lists
+	 * @param movie - The classics movie, assigned
+	 * @param formatStock - The stock of the movie in every format, filled
+	 *
+	 * @return Whether the line was valid
+	 */
+	static bool parseMovieLine(string_view movieLine, const CatalogConfig &catalog, Classics &movie, int *formatStock) {
+
+		// the comma delimited tokens of the line (any following the major actor and release date are ignored)
+		string_view movieParameters[5];
+		size_t parameterCount = splitFields(movieLine, ',', movieParameters, 5);
+
+		// movie director, title, major actor and release date
+		string director;
+		string title;
+		string majorActor;
+		int releaseMonth = 0;
+		int releaseYear = 0;
+
+		// loop parses through movie line and assigns movie's parameters
+		for(size_t parameterCounter = 1; parameterCounter <= parameterCount; parameterCounter++) {
+
+			// an empty field (two commas) holds not even the space leading its text
+			if(movieParameters[parameterCounter - 1].empty()) {
+
+				cout << "Field " << parameterCounter << " is empty. Movie was not added to inventory." << endl;
+				return false;
+			}
+
+			// get token removing starting space character
+			string_view cleanedParameter = movieParameters[parameterCounter - 1].substr(1);
+
+			// depending on loop iteration, assign different movie parameters
+			switch(parameterCounter) {
+
+				case 1:
+					break;
+				case 2:
+					if(!catalog.parseStock(cleanedParameter, formatStock)) {
+
+						cout << "Movie was not added to inventory." << endl;
+						return false;
+					}
+					break;
+				case 3:
+					director = cleanedParameter;
+					break;
+				case 4:
+					title = cleanedParameter;
+					break;
+				case 5:
+					{
+					// the major actor and release date tokens are deliminted via space characters and thus
+					// require their own split
+					string_view actorAndDate[4];
+					size_t actorAndDateCount = splitFields(cleanedParameter, ' ', actorAndDate, 4);
+					for(size_t i = 0; i < actorAndDateCount; i++) {
+
+						if(i == 0) {
+
+							majorActor = actorAndDate[i];
+						}
+						if(i == 1) {
+
+							majorActor += " ";
+							majorActor += actorAndDate[i];
+						}
+						if(i == 2 && (!parseIntegerField(actorAndDate[i], releaseMonth) || releaseMonth < 1 || releaseMonth > 12)) {
+
+							cout << "Invalid release month: " << actorAndDate[i] << ". Movie was not added to inventory." << endl;
+							return false;
+						}
+						if(i == 3 && (!parseIntegerField(actorAndDate[i], releaseYear) || releaseYear < 0 || releaseYear > SHRT_MAX)) {
+
+							cout << "Invalid release year: " << actorAndDate[i] << ". Movie was not added to inventory." << endl;
+							return false;
+						}
+					}
+					break;
+					}
+				default:
+					break;
+			}
+		}
+		movie = Classics(releaseYear, releaseMonth, majorActor, director, title, formatStock[0]);
+		return true;
+	}
+
+	/**
+	 * Gets the text a classics title is searched by in the title search index.
+	 *
+	 * @param movie - The movie
+	 *
+	 * @return Its title, release date, director and major actor
+	 */
+	static string getSearchText(const Classics &movie) {
+
+		return string(movie.getTitle()) + ", " + movie.getReleaseDate() + ", " + string(movie.getDirector()) + ", " + string(movie.getMajorActor());
+	}
+
+	/**
+	 * Parses the query of an availability command into a range of classics: the classics released
+	 * in a year or a range of years (every classic when the query is empty).
+	 *
+	 * @param query - The query, e.g. "1940" or "1940-1949"
+	 * @param range - The range, assigned
+	 *
+	 * @return Whether the query was valid
+	 */
+	static bool parseAvailabilityRange(const string &query, SortKeyRange &range) {
+
+		if(query == "") {
+
+			return true;
+		}
+		int firstYear = 0;
+		int lastYear = 0;
+		char separator = 0;
+		stringstream years(query);
+		if(!(years >> firstYear)) {
+
+			return false;
+		}
+		if(!(years >> separator)) {
+
+			lastYear = firstYear;
+		}
+		else if(separator != '-' || !(years >> lastYear)) {
+
+			return false;
+		}
+
+		// classics sort keys lead with the release year and month (see Classics::getSortKey)
+		range.firstNumber = firstYear * 16;
+		range.lastNumber = lastYear * 16 + 15;
+		return true;
+	}
+
+	// gets the major actor of a movie (indexed by secondary indexes)
+	static string_view getMajorActor(const Classics &movie) {
+
+		return movie.getMajorActor();
+	}
+
+	// gets the release month of a movie
+	static int getReleaseMonth(const Classics &movie) {
+
+		return movie.getReleaseMonth();
+	}
+
+	// constructs a classics movie from the fields of a state record (see MovieRentalStore::exportState)
+	static Classics makeMovie(const string &director, const string &title, int releaseYear, int releaseMonth, const string &majorActor, int stock) {
+
+		return Classics(releaseYear, releaseMonth, majorActor, director, title, stock);
+	}
+
+	/**
+	 * Parses the movie of a borrow/return command into a movie holding its sorting criteria.
+	 * Expected movie format: 3 1971 Katherine Hepburn (month, year, first name, last name)
+	 *
+	 * @param movieParameters - The rest of the command line, following the genre code
+	 * @param movie - The classics movie, assigned if its major actor is interned
+	 * @param carried - Whether its major actor is interned (else no classics movie carried has it), assigned
+	 *
+	 * @return Whether the release month and year, if given, were numbers (parsed without throwing)
+	 */
+	static bool parseCommand(string_view movieParameters, Classics &movie, bool &carried) {
+
+		string_view parameters[4];
+		size_t count = splitFields(movieParameters, ' ', parameters, 4);
+		int month = 0;
+		short int year = 0;
+		string_view majorActorFirstName;
+		string_view majorActorLastName;
+		for(size_t counter = 0; counter < count; counter++) {
+
+			switch(counter) {
+
+				case 0:
+					if(!parseIntegerField(parameters[counter], month)) {
+
+						return false;
+					}
+					break;
+				case 1:
+					if(!parseIntegerField(parameters[counter], year)) {
+
+						return false;
+					}
+					break;
+				case 2:
+					majorActorFirstName = parameters[counter];
+					break;
+				case 3:
+					majorActorLastName = parameters[counter];
+					break;
+				default:
+					break;
+			}
+		}
+
+		// both names, and the single space splitting them, are a view of the command; a missing last name
+		// is joined as it always was ("first" and a space)
+		string joinedNames;
+		string_view majorActor;
+		if(count == 4) {
+
+			majorActor = string_view(majorActorFirstName.data(), majorActorLastName.data() + majorActorLastName.size() - majorActorFirstName.data());
+		}
+		else {
+
+			joinedNames = string(majorActorFirstName) + " " + string(majorActorLastName);
+			majorActor = joinedNames;
+		}
+		carried = namesInterned({majorActor});
+		if(carried) {
+
+			movie = Classics(year, month, majorActor);
+		}
+		return true;
+	}
+};
+
+/**
+ * Gets the movie portion of the borrow command naming a movie, the key it is searched by in the
+ * title search index.
+ *
+ * @param movie - The movie
+ *
+ * @return The genre code, a space and the sorting criteria of the movie
+ */
+template <typename MovieType>
+string getMovieCommand(const MovieType &movie) {
+
+	return string(1, MovieType::code) + " " + movie.getSortingCriteria();
+}
+
+// a genre passed to a visitor of "GenreList": the visitor reads the movie class from "Movie"
+template <typename MovieType>
+struct GenreTag {
+
+	typedef MovieType Movie;
+};
+
+// a list of genres, dispatched on by their codes
+template <typename... MovieTypes>
+struct GenreList {
+
+	/**
+	 * Calls the visitor with the tag of the genre whose code is given. The codes are compared in
+	 * order; the call on the matching genre is resolved at compile time.
+	 *
+	 * @param code - The genre code
+	 * @param visitor - Callable taking a "GenreTag"
+	 *
+	 * @return Whether a genre of the list has the code
+	 */
+	template <typename Visitor>
+	static bool visit(char code, Visitor &&visitor) {
+
+		return ((code == MovieTypes::code && (visitor(GenreTag<MovieTypes>()), true)) || ...);
+	}
+
+	/**
+	 * Calls the visitor with the tag of every genre of the list, in order.
+	 *
+	 * @param visitor - Callable taking a "GenreTag"
+	 */
+	template <typename Visitor>
+	static void forEach(Visitor &&visitor) {
+
+		(visitor(GenreTag<MovieTypes>()), ...);
+	}
+
+	// gets the codes of the genres of the list
+	static string getCodes() {
+
+		return string({MovieTypes::code...});
+	}
+
+	// a tuple holding a "Holder<MovieType>" for every genre of the list (read with "get<Holder<MovieType>>")
+	template <template <typename> class Holder>
+	using Tuple = tuple<Holder<MovieTypes>...>;
+};
+
+// the genres supported by the store (its catalog configuration may carry fewer)
+typedef GenreList<Comedy, Drama, Classics> StoreGenres;
+
+#endif
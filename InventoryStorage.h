@@ -0,0 +1,378 @@
+#ifndef INVENTORYSTORAGE_H
+#define INVENTORYSTORAGE_H
+
+#include "Movie.h"
+
+#include <algorithm>
+#include <vector>
+
+// storage policies of ArrayBasedBSTree: how the slots of the tree's array are laid out. a policy
+// provides, by slot index, emptiness, comparison against a searched movie (reduced to a "Probe"
+// once per search), insertion, removal and the movie itself (for printing and rebuilding). the stock of every slot is kept
+// apart, per media format, in a FormatStockTable.
+
+// stores whole movie objects in one array (the original layout)
+template <typename MovieType>
+class ObjectStorage {
+
+private:
+
+	MovieType *movies = nullptr;
+
+public:
+
+	// a searched movie, compared with the genre's comparison operators
+	typedef MovieType *Probe;
+
+	ObjectStorage() {}
+
+	ObjectStorage(const ObjectStorage&) = delete;
+	ObjectStorage &operator=(const ObjectStorage&) = delete;
+
+	~ObjectStorage() {
+
+		delete[] movies;
+	}
+
+	/**
+	 * Resizes the array, keeping the movies of the slots below the old capacity.
+	 *
+	 * @param oldCapacity - The current number of slots
+	 * @param newCapacity - The new number of slots
+	 */
+	void resize(int oldCapacity, int newCapacity) {
+
+		MovieType *expandedInventory = new MovieType[newCapacity];
+		for(int i = 0; i < oldCapacity; i++) {
+
+			expandedInventory[i] = movies[i];
+		}
+		delete[] movies;
+		movies = expandedInventory;
+	}
+
+	// gets the bytes of a slot
+	static long long getSlotBytes() {
+
+		return sizeof(MovieType);
+	}
+
+	Probe makeProbe(MovieType &movie) {
+
+		return &movie;
+	}
+
+	bool isEmpty(int index) {
+
+		return movies[index].isEmpty();
+	}
+
+	// evaluates if the movie at the index is equal to the searched movie
+	bool matches(int index, Probe &probe) {
+
+		return movies[index] == *probe;
+	}
+
+	// evaluates if the movie at the index is greater than the searched movie
+	bool greaterThan(int index, Probe &probe) {
+
+		return movies[index] > *probe;
+	}
+
+	void store(int index, MovieType &movie) {
+
+		movies[index] = movie;
+	}
+
+	// empties the slot at the index
+	void clear(int index) {
+
+		movies[index] = MovieType();
+	}
+
+	// gets the movie at the index (its stock is not kept up to date)
+	const MovieType &getMovie(int index) {
+
+		return movies[index];
+	}
+};
+
+// stores the sort key borrow/return commands search by in a dense array, and the rest of each
+// movie in a separate array of cold records that is only read to print the inventory. a search
+// walks the key array alone.
+template <typename MovieType>
+class ColumnStorage {
+
+private:
+
+	// hot columns
+	MovieSortKey *keys = nullptr;
+	bool *occupied = nullptr;
+
+	// cold records: the movies as inserted
+	MovieType *records = nullptr;
+
+	/**
+	 * Copies the first "count" elements of a column into a new column of "capacity" elements.
+	 *
+	 * @param column - The column, replaced by the new one
+	 * @param count - The number of elements copied
+	 * @param capacity - The size of the new column
+	 */
+	template <typename Field>
+	static void resizeColumn(Field *&column, int count, int capacity) {
+
+		Field *expandedColumn = new Field[capacity]();
+		for(int i = 0; i < count; i++) {
+
+			expandedColumn[i] = column[i];
+		}
+		delete[] column;
+		column = expandedColumn;
+	}
+
+public:
+
+	// a searched movie, reduced to its sort key
+	typedef MovieSortKey Probe;
+
+	ColumnStorage() {}
+
+	ColumnStorage(const ColumnStorage&) = delete;
+	ColumnStorage &operator=(const ColumnStorage&) = delete;
+
+	~ColumnStorage() {
+
+		delete[] keys;
+		delete[] occupied;
+		delete[] records;
+	}
+
+	/**
+	 * Resizes every column, keeping the fields of the slots below the old capacity.
+	 *
+	 * @param oldCapacity - The current number of slots
+	 * @param newCapacity - The new number of slots
+	 */
+	void resize(int oldCapacity, int newCapacity) {
+
+		resizeColumn(keys, oldCapacity, newCapacity);
+		resizeColumn(occupied, oldCapacity, newCapacity);
+		resizeColumn(records, oldCapacity, newCapacity);
+	}
+
+	// gets the bytes of a slot (every column)
+	static long long getSlotBytes() {
+
+		return sizeof(MovieSortKey) + sizeof(bool) + sizeof(MovieType);
+	}
+
+	Probe makeProbe(MovieType &movie) {
+
+		return movie.getSortKey();
+	}
+
+	bool isEmpty(int index) {
+
+		return !occupied[index];
+	}
+
+	// evaluates if the movie at the index is equal to the searched movie
+	bool matches(int index, Probe &probe) {
+
+		return keys[index] == probe;
+	}
+
+	// evaluates if the movie at the index is greater than the searched movie
+	bool greaterThan(int index, Probe &probe) {
+
+		return keys[index] > probe;
+	}
+
+	void store(int index, MovieType &movie) {
+
+		keys[index] = movie.getSortKey();
+		occupied[index] = !movie.isEmpty();
+		records[index] = movie;
+	}
+
+	// empties the slot at the index
+	void clear(int index) {
+
+		keys[index] = MovieSortKey();
+		occupied[index] = false;
+		records[index] = MovieType();
+	}
+
+	// gets the movie at the index (its stock is not kept up to date)
+	const MovieType &getMovie(int index) {
+
+		return records[index];
+	}
+};
+
+// the stock of every slot of an inventory in each media format carried. the counts of a slot are
+// one contiguous run of "formats" entries, so the slot index a search returns locates the stock of
+// every format of the title without another search, and the formats of a title share cache lines.
+class FormatStockTable {
+
+public:
+
+	// the current and starting (maximum) stock of a title in a format
+	struct FormatStock {
+
+		int current;
+		int starting;
+	};
+
+private:
+
+	FormatStock *entries = nullptr;
+
+	// number of formats per slot
+	int formats = 1;
+
+public:
+
+	FormatStockTable() {}
+
+	FormatStockTable(const FormatStockTable&) = delete;
+	FormatStockTable &operator=(const FormatStockTable&) = delete;
+
+	~FormatStockTable() {
+
+		delete[] entries;
+	}
+
+	/**
+	 * Resizes the table, keeping the stock of the slots below the old capacity (which must not be
+	 * above the new one).
+	 *
+	 * @param oldCapacity - The current number of slots
+	 * @param newCapacity - The new number of slots
+	 */
+	void resize(int oldCapacity, int newCapacity) {
+
+		FormatStock *expandedEntries = new FormatStock[newCapacity * formats]();
+		for(int i = 0; i < oldCapacity * formats; i++) {
+
+			expandedEntries[i] = entries[i];
+		}
+		delete[] entries;
+		entries = expandedEntries;
+	}
+
+	/**
+	 * Changes the number of formats per slot. The stock of every slot is discarded.
+	 *
+	 * @param formatCount - The new number of formats
+	 * @param capacity - The number of slots
+	 */
+	void setFormatCount(int formatCount, int capacity) {
+
+		delete[] entries;
+		formats = formatCount;
+		entries = new FormatStock[capacity * formats]();
+	}
+
+	int getFormatCount() const {
+
+		return formats;
+	}
+
+	// gets the bytes of a slot
+	long long getSlotBytes() const {
+
+		return formats * sizeof(FormatStock);
+	}
+
+	// sets the current and starting stock of a title in a format
+	void set(int index, int format, int stock) {
+
+		entries[index * formats + format] = {stock, stock};
+	}
+
+	int getStock(int index, int format) const {
+
+		return entries[index * formats + format].current;
+	}
+
+	int getStartingStock(int index, int format) const {
+
+		return entries[index * formats + format].starting;
+	}
+
+	// counts the formats a title has a copy in stock in
+	int getFormatsInStock(int index) const {
+
+		int inStock = 0;
+		for(int format = 0; format < formats; format++) {
+
+			inStock += entries[index * formats + format].current > 0;
+		}
+		return inStock;
+	}
+
+	// evaluates whether a title has a copy in stock, in any format
+	bool inStock(int index) const {
+
+		return getFormatsInStock(index) > 0;
+	}
+
+	// copies the stock of every format of a slot to the end of a list
+	void copySlot(int index, vector<FormatStock> &stock) const {
+
+		stock.insert(stock.end(), entries + index * formats, entries + (index + 1) * formats);
+	}
+
+	// sets the stock of every format of a slot from a list, starting at the position argument
+	void restoreSlot(int index, const vector<FormatStock> &stock, size_t position) {
+
+		for(int format = 0; format < formats; format++) {
+
+			entries[index * formats + format] = stock[position + format];
+		}
+	}
+
+	// empties the stock of every format of a slot
+	void clear(int index) {
+
+		for(int format = 0; format < formats; format++) {
+
+			entries[index * formats + format] = {0, 0};
+		}
+	}
+
+	// sets the starting stock of a title in a format, changing its current stock by the same amount
+	// (never below none)
+	void restock(int index, int format, int startingStock) {
+
+		FormatStock &stock = entries[index * formats + format];
+		stock.current = max(0, stock.current + startingStock - stock.starting);
+		stock.starting = startingStock;
+	}
+
+	bool incrementStock(int index, int format) {
+
+		FormatStock &stock = entries[index * formats + format];
+		if(stock.current < stock.starting) {
+
+			stock.current++;
+			return true;
+		}
+		return false;
+	}
+
+	bool decrementStock(int index, int format) {
+
+		FormatStock &stock = entries[index * formats + format];
+		if(stock.current > 0) {
+
+			stock.current--;
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif
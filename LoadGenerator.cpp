@@ -0,0 +1,360 @@
+#include <bits/stdc++.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// a load generator client for the store server (see StoreServer.h). opens many connections to the
+// server, keeps a fixed number of pipelined commands in flight on each one, and reports the latency
+// distribution (p50/p99/p999) and throughput of the responses.
+
+// the state of a single client connection
+struct LoadConnection {
+
+	// socket descriptor
+	int fd;
+
+	// number of commands written and fully answered on this connection
+	int sent = 0;
+	int answered = 0;
+
+	// position within the command list of the next command to send
+	size_t nextCommand;
+
+	// send times of the commands that are still waiting for a response, oldest first
+	deque<steady_clock::time_point> inFlight;
+
+	// response bytes received but not yet split into lines
+	string readBuffer;
+
+	// command bytes not yet accepted by the socket
+	string writeBuffer;
+};
+
+// the settings of a load generator run
+struct LoadSettings {
+
+	string socketPath;
+	int port = 0;
+	int connections = 100;
+	int requestsPerConnection = 1000;
+	int pipelineDepth = 8;
+	string commandFile = "data_files/data4commands2.txt";
+};
+
+/**
+  * Prints the command line usage of the load generator.
+  */
+void printUsage() {
+
+	cout << "Usage: LoadGenerator (--unix <socket path> | --tcp <port>) [--connections N] [--requests N]" << endl;
+	cout << "                     [--pipeline N] [--commands <command file>]" << endl;
+}
+
+/**
+  * Reads the commands to be sent from a command file. Inventory commands are skipped since their
+  * responses are large and would dominate the measurement.
+  *
+  * @param commandFile - The directory of the command file
+  * @param commands - Receives the command lines
+  *
+  * @return Whether at least one command was read
+  */
+bool readCommands(string commandFile, vector<string> &commands) {
+
+	ifstream readFile(commandFile);
+	string line;
+	while(getline(readFile, line)) {
+
+		if(line != "" && line[line.length() - 1] == '\r') {
+
+			line.erase(line.length() - 1);
+		}
+		if(line != "" && line[0] != 'I') {
+
+			commands.push_back(line + "\n");
+		}
+	}
+	return !commands.empty();
+}
+
+/**
+  * Opens a blocking connection to the server, then switches it to non-blocking mode.
+  *
+  * @param settings - The run settings holding the server address
+  *
+  * @return The connected socket descriptor, -1 on failure
+  */
+int connectToServer(LoadSettings &settings) {
+
+	int fd;
+	if(settings.socketPath != "") {
+
+		struct sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, settings.socketPath.c_str(), sizeof(address.sun_path) - 1);
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(fd == -1 || connect(fd, (struct sockaddr *) &address, sizeof(address)) == -1) {
+
+			cout << "Could not connect: " << strerror(errno) << endl;
+			return -1;
+		}
+	}
+	else {
+
+		struct sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons(settings.port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		if(fd == -1 || connect(fd, (struct sockaddr *) &address, sizeof(address)) == -1) {
+
+			cout << "Could not connect: " << strerror(errno) << endl;
+			return -1;
+		}
+		int noDelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+	return fd;
+}
+
+/**
+  * Queues commands on the connection until the pipeline is full or all its requests were sent, then
+  * writes as much as the socket accepts.
+  *
+  * @param connection - The connection to be written to
+  * @param commands - The command lines sent in rotation
+  * @param settings - The run settings
+  *
+  * @return Whether the connection is still usable
+  */
+bool fillPipeline(LoadConnection &connection, vector<string> &commands, LoadSettings &settings) {
+
+	while((int) connection.inFlight.size() < settings.pipelineDepth && connection.sent < settings.requestsPerConnection) {
+
+		connection.writeBuffer += commands[connection.nextCommand];
+		connection.nextCommand = (connection.nextCommand + 1) % commands.size();
+		connection.inFlight.push_back(steady_clock::now());
+		connection.sent++;
+	}
+	while(!connection.writeBuffer.empty()) {
+
+		ssize_t bytesSent = send(connection.fd, connection.writeBuffer.data(), connection.writeBuffer.size(), MSG_NOSIGNAL);
+		if(bytesSent > 0) {
+
+			connection.writeBuffer.erase(0, bytesSent);
+			continue;
+		}
+		if(bytesSent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+
+			break;
+		}
+		return false;
+	}
+	return true;
+}
+
+/**
+  * Reads the responses available on the connection. Every terminator line completes the oldest
+  * in-flight command, whose latency is recorded.
+  *
+  * @param connection - The connection to be read
+  * @param latencies - Receives the latency of each completed command in nanoseconds
+  *
+  * @return Whether the connection is still usable
+  */
+bool drainResponses(LoadConnection &connection, vector<long long> &latencies) {
+
+	char buffer[64 * 1024];
+	while(true) {
+
+		ssize_t bytesRead = recv(connection.fd, buffer, sizeof(buffer), 0);
+		if(bytesRead > 0) {
+
+			connection.readBuffer.append(buffer, bytesRead);
+			continue;
+		}
+		if(bytesRead == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+
+			break;
+		}
+		return false;
+	}
+	size_t lineStart = 0;
+	size_t lineEnd;
+	steady_clock::time_point now = steady_clock::now();
+	while((lineEnd = connection.readBuffer.find('\n', lineStart)) != string::npos) {
+
+		if(lineEnd - lineStart == 1 && connection.readBuffer[lineStart] == '.' && !connection.inFlight.empty()) {
+
+			latencies.push_back(duration_cast<nanoseconds>(now - connection.inFlight.front()).count());
+			connection.inFlight.pop_front();
+			connection.answered++;
+		}
+		lineStart = lineEnd + 1;
+	}
+	connection.readBuffer.erase(0, lineStart);
+	return true;
+}
+
+/**
+  * Gets the given percentile of a sorted list of latencies.
+  *
+  * @param sortedLatencies - The latencies sorted in ascending order
+  * @param percentile - The percentile requested (0-100)
+  *
+  * @return The latency at the percentile, in microseconds
+  */
+double percentileMicros(vector<long long> &sortedLatencies, double percentile) {
+
+	if(sortedLatencies.empty()) {
+
+		return 0;
+	}
+	size_t index = (size_t) ceil(percentile / 100.0 * sortedLatencies.size());
+	index = index == 0 ? 0 : index - 1;
+	return sortedLatencies[min(index, sortedLatencies.size() - 1)] / 1000.0;
+}
+
+int main(int argc, char *argv[]) {
+
+	LoadSettings settings;
+	for(int i = 1; i + 1 < argc; i += 2) {
+
+		string option = argv[i];
+		if(option == "--unix") {
+
+			settings.socketPath = argv[i + 1];
+		}
+		else if(option == "--tcp") {
+
+			settings.port = stoi(argv[i + 1]);
+		}
+		else if(option == "--connections") {
+
+			settings.connections = stoi(argv[i + 1]);
+		}
+		else if(option == "--requests") {
+
+			settings.requestsPerConnection = stoi(argv[i + 1]);
+		}
+		else if(option == "--pipeline") {
+
+			settings.pipelineDepth = max(1, stoi(argv[i + 1]));
+		}
+		else if(option == "--commands") {
+
+			settings.commandFile = argv[i + 1];
+		}
+		else {
+
+			printUsage();
+			return 1;
+		}
+	}
+	if(settings.socketPath == "" && settings.port == 0) {
+
+		printUsage();
+		return 1;
+	}
+	vector<string> commands;
+	if(!readCommands(settings.commandFile, commands)) {
+
+		cout << "No commands could be read from: " << settings.commandFile << endl;
+		return 1;
+	}
+
+	// allow as many sockets as the hard limit permits
+	struct rlimit fileLimit;
+	if(getrlimit(RLIMIT_NOFILE, &fileLimit) == 0) {
+
+		fileLimit.rlim_cur = fileLimit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &fileLimit);
+	}
+
+	int epollFd = epoll_create1(0);
+	vector<LoadConnection> connections(settings.connections);
+	for(int i = 0; i < settings.connections; i++) {
+
+		connections[i].fd = connectToServer(settings);
+		if(connections[i].fd == -1) {
+
+			return 1;
+		}
+		connections[i].nextCommand = i % commands.size();
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+		event.data.u32 = i;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, connections[i].fd, &event);
+	}
+
+	vector<long long> latencies;
+	latencies.reserve((size_t) settings.connections * settings.requestsPerConnection);
+	long long expected = (long long) settings.connections * settings.requestsPerConnection;
+	int openConnections = settings.connections;
+	vector<struct epoll_event> events(1024);
+	steady_clock::time_point start = steady_clock::now();
+	for(int i = 0; i < settings.connections; i++) {
+
+		fillPipeline(connections[i], commands, settings);
+	}
+	while((long long) latencies.size() < expected && openConnections > 0) {
+
+		int readyCount = epoll_wait(epollFd, events.data(), events.size(), 1000);
+		if(readyCount == -1 && errno != EINTR) {
+
+			break;
+		}
+		for(int i = 0; i < readyCount; i++) {
+
+			LoadConnection &connection = connections[events[i].data.u32];
+			if(connection.fd == -1) {
+
+				continue;
+			}
+			if(!drainResponses(connection, latencies) || !fillPipeline(connection, commands, settings)) {
+
+				cout << "Connection closed by server after " << connection.answered << " responses." << endl;
+				close(connection.fd);
+				connection.fd = -1;
+				openConnections--;
+			}
+		}
+	}
+	double elapsedSeconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+	for(size_t i = 0; i < connections.size(); i++) {
+
+		if(connections[i].fd != -1) {
+
+			close(connections[i].fd);
+		}
+	}
+	close(epollFd);
+
+	sort(latencies.begin(), latencies.end());
+	cout << fixed << setprecision(1);
+	cout << "connections:      " << settings.connections << endl;
+	cout << "pipeline depth:   " << settings.pipelineDepth << endl;
+	cout << "responses:        " << latencies.size() << " / " << expected << endl;
+	cout << "elapsed:          " << setprecision(3) << elapsedSeconds << " s" << endl;
+	cout << "throughput:       " << setprecision(0) << latencies.size() / elapsedSeconds << " commands/s" << endl;
+	cout << setprecision(1);
+	cout << "latency p50:      " << percentileMicros(latencies, 50) << " us" << endl;
+	cout << "latency p99:      " << percentileMicros(latencies, 99) << " us" << endl;
+	cout << "latency p999:     " << percentileMicros(latencies, 99.9) << " us" << endl;
+	cout << "latency max:      " << percentileMicros(latencies, 100) << " us" << endl;
+	return (long long) latencies.size() == expected ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "MemoryAccounting.h"
+
+#include <iomanip>
+
+bool MemoryAccounting::enabled = false;
+MemoryAccount MemoryAccounting::accounts[(int) MemorySubsystem::Count];
+
+// display names of the subsystems, in enum order
+static const char *subsystemNames[] = {"Inventory", "Customer table", "Ledgers", "History"};
+
+/**
+  * Starts accounting. Allocations made before this call are not attributed, so accounting should be
+  * enabled before the store is constructed.
+  */
+void MemoryAccounting::enable() {
+
+	enabled = true;
+}
+
+/**
+  * Gets whether accounting is enabled.
+  *
+  * @return The accounting state
+  */
+bool MemoryAccounting::isEnabled() {
+
+	return enabled;
+}
+
+/**
+  * Records an allocation.
+  *
+  * @param subsystem - The subsystem the bytes are attributed to
+  * @param bytes - The number of bytes allocated
+  */
+void MemoryAccounting::recordAllocation(MemorySubsystem subsystem, long long bytes) {
+
+	if(!enabled) {
+
+		return;
+	}
+	MemoryAccount &account = accounts[(int) subsystem];
+	account.allocations++;
+	account.liveBytes += bytes;
+	if(account.liveBytes > account.peakBytes) {
+
+		account.peakBytes = account.liveBytes;
+	}
+}
+
+/**
+  * Records a free.
+  *
+  * @param subsystem - The subsystem the bytes are attributed to
+  * @param bytes - The number of bytes freed
+  */
+void MemoryAccounting::recordFree(MemorySubsystem subsystem, long long bytes) {
+
+	if(!enabled) {
+
+		return;
+	}
+	MemoryAccount &account = accounts[(int) subsystem];
+	account.frees++;
+	account.liveBytes -= bytes;
+}
+
+/**
+  * Records a block being reallocated with a different size (one allocation and one free).
+  *
+  * @param subsystem - The subsystem the bytes are attributed to
+  * @param oldBytes - The size of the block before, 0 if there was no block
+  * @param newBytes - The size of the block after
+  */
+void MemoryAccounting::recordResize(MemorySubsystem subsystem, long long oldBytes, long long newBytes) {
+
+	if(!enabled || oldBytes == newBytes) {
+
+		return;
+	}
+	recordAllocation(subsystem, newBytes);
+	if(oldBytes > 0) {
+
+		recordFree(subsystem, oldBytes);
+	}
+}
+
+/**
+  * Gets the account of a subsystem.
+  *
+  * @param subsystem - The subsystem
+  *
+  * @return The subsystem's account
+  */
+const MemoryAccount &MemoryAccounting::getAccount(MemorySubsystem subsystem) {
+
+	return accounts[(int) subsystem];
+}
+
+/**
+  * Prints the live bytes, peak bytes and allocation counts of every subsystem.
+  *
+  * @param out - The stream printed to
+  */
+void MemoryAccounting::print(ostream &out) {
+
+	long long totalBytes = 0;
+	out << "----------Memory----------" << endl;
+	for(int i = 0; i < (int) MemorySubsystem::Count; i++) {
+
+		out << "  " << left << setw(16) << subsystemNames[i] << right << " live bytes=" << setw(12) << accounts[i].liveBytes
+			<< " peak bytes=" << setw(12) << accounts[i].peakBytes << " allocations=" << accounts[i].allocations
+			<< " frees=" << accounts[i].frees << endl;
+		totalBytes += accounts[i].liveBytes;
+	}
+	out << "  " << left << setw(16) << "Total" << right << " live bytes=" << setw(12) << totalBytes << endl;
+}
+
+/**
+  * Prints every subsystem that still holds bytes. Called after the store was destroyed, any such
+  * bytes were never freed (or were freed without being recorded).
+  *
+  * @param out - The stream printed to
+  */
+void MemoryAccounting::printLeaks(ostream &out) {
+
+	bool leaked = false;
+	for(int i = 0; i < (int) MemorySubsystem::Count; i++) {
+
+		if(accounts[i].liveBytes != 0) {
+
+			out << "Memory accounting: " << subsystemNames[i] << " still holds " << accounts[i].liveBytes << " bytes after shutdown." << endl;
+			leaked = true;
+		}
+	}
+	if(!leaked) {
+
+		out << "Memory accounting: every subsystem released its memory." << endl;
+	}
+}
+
+/**
+  * Gets the bytes a string holds on the heap. Strings whose capacity fits the small string
+  * buffer (15 characters with libstdc++) hold none.
+  *
+  * @param text - The string
+  *
+  * @return The heap bytes of the string
+  */
+size_t MemoryAccounting::stringHeapBytes(const string &text) {
+
+	return text.capacity() > 15 ? text.capacity() + 1 : 0;
+}
@@ -0,0 +1,77 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// the parts of the store memory is attributed to
+enum class MemorySubsystem {
+
+	// genre inventory arrays (movie names are interned and reported by the string table)
+	Inventory,
+
+	// the customer hash table, its chained customer records and their names
+	CustomerTable,
+
+	// customer borrow lists and the movie records held in them
+	Ledgers,
+
+	// customer transaction histories
+	History,
+
+	// number of subsystems (not a subsystem)
+	Count
+};
+
+// the memory attributed to a single subsystem
+struct MemoryAccount {
+
+	long long allocations = 0;
+	long long frees = 0;
+	long long liveBytes = 0;
+	long long peakBytes = 0;
+};
+
+// opt-in accounting of the bytes and allocation counts of each store subsystem. allocation sites
+// report what they allocate and free; while accounting is disabled every report is a single branch.
+// bytes held when the store has been destroyed point to a leak in the subsystem.
+class MemoryAccounting {
+
+private:
+
+	static bool enabled;
+	static MemoryAccount accounts[(int) MemorySubsystem::Count];
+
+public:
+
+	// starts accounting
+	static void enable();
+
+	// gets whether accounting is enabled
+	static bool isEnabled();
+
+	// records an allocation of the given number of bytes in the subsystem
+	static void recordAllocation(MemorySubsystem, long long);
+
+	// records a free of the given number of bytes in the subsystem
+	static void recordFree(MemorySubsystem, long long);
+
+	// records a block of the subsystem being resized from the first byte count to the second
+	static void recordResize(MemorySubsystem, long long, long long);
+
+	// gets the account of the subsystem
+	static const MemoryAccount &getAccount(MemorySubsystem);
+
+	// prints the account of every subsystem
+	static void print(ostream &);
+
+	// prints the subsystems still holding bytes (meant to be called once the store is destroyed)
+	static void printLeaks(ostream &);
+
+	// gets the bytes a string holds on the heap (0 while it fits the small string buffer)
+	static size_t stringHeapBytes(const string &);
+};
+
+#endif
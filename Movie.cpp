@@ -20,7 +20,7 @@ Movie::Movie() {
   * @param movieReleaseYear - The movie's release year
   * @param stock - Number of copies of movie available in stock within associated store
   */
-Movie::Movie(string movieDirector, string movieTitle, short int movieReleaseYear, int Stock) {
+Movie::Movie(string_view movieDirector, string_view movieTitle, short int movieReleaseYear, int Stock) {
 
 	setDirector(movieDirector);
 	setTitle(movieTitle);
@@ -39,7 +39,7 @@ Movie::~Movie() {}
   *
   * @param Director - The movie's director to be set
   */
-void Movie::setDirector(string Director) {
+void Movie::setDirector(string_view Director) {
 
 	director = Director;
 }
@@ -49,7 +49,7 @@ void Movie::setDirector(string Director) {
   *
   * @param Title - The movie's title to be set
   */
-void Movie::setTitle(string Title) {
+void Movie::setTitle(string_view Title) {
 
 	title = Title;
 }
@@ -87,21 +87,21 @@ void Movie::setStartingStock(int Stock) {
 /**
   * Gets the movie's director.
   *
-  * @return The movie's director
+  * @return The movie's director (valid for the life of the process)
   */
-string Movie::getDirector() const {
+string_view Movie::getDirector() const {
 
-	return director;
+	return director.view();
 }
 
 /**
   * Gets the movie's title.
   *
-  * @return The movie's title
+  * @return The movie's title (valid for the life of the process)
   */
-string Movie::getTitle() const {
+string_view Movie::getTitle() const {
 
-	return title;
+	return title.view();
 }
 
 /**
@@ -134,6 +134,36 @@ int Movie::getStartingStock() const {
 	return startingStock;
 }
 
+/**
+  * Gets the code of the movie's genre.
+  *
+  * @return The genre code, 0 for a movie of no genre
+  */
+char Movie::getGenreCode() const {
+
+	return genreCode;
+}
+
+/**
+  * Gets the index of the media format of the copy a borrowed movie record stands for.
+  *
+  * @return The format index
+  */
+int Movie::getFormat() const {
+
+	return format;
+}
+
+/**
+  * Sets the index of the media format of the copy a borrowed movie record stands for.
+  *
+  * @param Format - The format index
+  */
+void Movie::setFormat(int Format) {
+
+	format = Format;
+}
+
 /**
   * Increments the movie's current stock.
   *
@@ -167,6 +197,25 @@ bool Movie::decrementStock() {
 	return false;
 }
 
+/**
+  * Sets the movie's current and starting stock. Used when a movie is rebuilt from fields stored apart from it.
+  *
+  * @param Stock - The current stock, between 0 and the starting stock
+  * @param StartingStock - The starting stock
+  *
+  * @return Whether the stock was in range and set
+  */
+bool Movie::setStockLevels(int Stock, int StartingStock) {
+
+	if(Stock < 0 || Stock > StartingStock) {
+
+		return false;
+	}
+	setStock(Stock);
+	setStartingStock(StartingStock);
+	return true;
+}
+
 /**
   * Checks if the movie's member variables are all set to default values (an empty movie).
   *
@@ -174,7 +223,18 @@ bool Movie::decrementStock() {
   */
 bool Movie::isEmpty() const {
 
-	return (director == "" && title == "" && releaseYear == 0 && stock == 0);
+	return (director.empty() && title.empty() && releaseYear == 0 && stock == 0);
+}
+
+/**
+  * Gets the bytes held by the movie. Its director and title are interned, so their characters are
+  * accounted to the string table. Comedy and Drama add no members, so this covers them as well.
+  *
+  * @return The movie's memory footprint in bytes
+  */
+size_t Movie::getMemoryFootprint() const {
+
+	return sizeof(*this);
 }
 
 /**
@@ -194,13 +254,18 @@ string Movie::toString() const {
 /**
   * Default Comedy constructor invokes parent default "Movie" class constructor to initialize member variables.
   */
-Comedy::Comedy(): Movie() {};
+Comedy::Comedy(): Movie() {
+
+	genreCode = code;
+};
 
 /**
   * Comedy constructor calls parent "Movie" class constructor to initialize member variables to parameter
   * arguments.
   */
-Comedy::Comedy(short int year, string title, string director, int stock): Movie(director, title, year, stock) {
+Comedy::Comedy(short int year, string_view title, string_view director, int stock): Movie(director, title, year, stock) {
+
+	genreCode = code;
 }
 
 /**
@@ -215,7 +280,23 @@ Comedy::~Comedy(){};
   */
 string Comedy::getSortingCriteria() const {
 
-	return getTitle() + ", " + to_string(getReleaseYear());
+	string criteria;
+	criteria.reserve(getTitle().size() + 8);
+	criteria.append(getTitle()).append(", ").append(to_string(getReleaseYear()));
+	return criteria;
+}
+
+/**
+  * Gets the sorting criteria of the comedy movie as a key: title, then release year.
+  *
+  * @return The sort key of the comedy movie
+  */
+MovieSortKey Comedy::getSortKey() const {
+
+	MovieSortKey key;
+	key.firstText = title;
+	key.trailingNumber = releaseYear;
+	return key;
 }
 
 /**
@@ -225,7 +306,7 @@ string Comedy::getSortingCriteria() const {
   */
 bool Comedy::isEmpty() const {
 
-	return (director == "" && title == "" && releaseYear == 0 && stock == 0);
+	return (director.empty() && title.empty() && releaseYear == 0 && stock == 0);
 }
 
 /**
@@ -255,11 +336,11 @@ bool Comedy::operator>(Comedy &movie) {
 
 	// checks if title is greater than parameter argument title; if equal
         // than check if release year is greater.
-	if(title == movie.getTitle()) {
+	if(title == movie.title) {
 
-		return releaseYear > movie.getReleaseYear();
+		return releaseYear > movie.releaseYear;
 	}
-	return title > movie.getTitle();
+	return title > movie.title;
 }
 
 /**
@@ -274,17 +355,20 @@ bool Comedy::operator<(Comedy &movie) {
 
 	// checks if title is less than parameter argument title; if equal
         // than check if release year is lesser.
-	if(title == movie.getTitle()) {
+	if(title == movie.title) {
 
-		return releaseYear < movie.getReleaseYear();
+		return releaseYear < movie.releaseYear;
 	}
-	return title < movie.getTitle();
+	return title < movie.title;
 }
 
 /**
   * Default constructor for Drama movie object. Invokes parent default "Movie" constructor to assign member variables default values.
   */
-Drama::Drama(): Movie(){};
+Drama::Drama(): Movie(){
+
+	genreCode = code;
+};
 
 /**
   * Constructor for Drama movie object invokes parent "Movie" constructor assigning member variables to parameter argument values.
@@ -294,7 +378,9 @@ Drama::Drama(): Movie(){};
   * @param year - The year for the movie
   * @param stock - The stock for the movie
   */
-Drama::Drama(string director, string title, short int year, int stock): Movie(director, title, year, stock) {
+Drama::Drama(string_view director, string_view title, short int year, int stock): Movie(director, title, year, stock) {
+
+	genreCode = code;
 }
 
 /**
@@ -309,7 +395,23 @@ Drama::~Drama(){};
   */
 string Drama::getSortingCriteria() const {
 
-	return getDirector() + ", " + getTitle() + ",";
+	string criteria;
+	criteria.reserve(getDirector().size() + getTitle().size() + 3);
+	criteria.append(getDirector()).append(", ").append(getTitle()).append(",");
+	return criteria;
+}
+
+/**
+  * Gets the sorting criteria of the drama movie as a key: director, then title.
+  *
+  * @return The sort key of the drama movie
+  */
+MovieSortKey Drama::getSortKey() const {
+
+	MovieSortKey key;
+	key.firstText = director;
+	key.secondText = title;
+	return key;
 }
 
 /**
@@ -319,7 +421,7 @@ string Drama::getSortingCriteria() const {
   */
 bool Drama::isEmpty() const {
 
-	return (director == "" && title == "" && releaseYear == 0 && stock == 0);
+	return (director.empty() && title.empty() && releaseYear == 0 && stock == 0);
 }
 
 /**
@@ -350,11 +452,11 @@ bool Drama::operator>(Drama &movie) {
         // if the director is greater than the argument's director, then the movie object is greater.
         // if the directors are equal, evaluate if title is greater than argument title, if so,
         // then movie object is greater.
-	if(director == movie.getDirector()) {
+	if(director == movie.director) {
 
-		return title > movie.getTitle();
+		return title > movie.title;
 	}
-	return director > movie.getDirector();
+	return director > movie.director;
 }
 
 /**
@@ -370,11 +472,11 @@ bool Drama::operator<(Drama &movie) {
 	// if the director is less than the argument's director, then the movie object is lesser.
         // if the directors are equal, evaluate if title is lesser than argument title, if so,
         // then movie object is lesser.
-	if(director == movie.getDirector()) {
+	if(director == movie.director) {
 
-		return title < movie.getTitle();
+		return title < movie.title;
 	}
-	return director < movie.getDirector();
+	return director < movie.director;
 }
 
 /**
@@ -383,16 +485,17 @@ bool Drama::operator<(Drama &movie) {
   */
 Classics::Classics(): Movie() {
 
+	genreCode = code;
 	releaseMonth = 0;
-	majorActor = "";
 };
 
 /**
   * Classics constructor invokes parent "Movie" constructor initializing member variables to parameter
   * argument values. Classics exclusive member variables assigned to argument values in body.
   */
-Classics::Classics(short int year, int month, string actor, string director, string title, int stock): Movie(director, title, year, stock) {
+Classics::Classics(short int year, int month, string_view actor, string_view director, string_view title, int stock): Movie(director, title, year, stock) {
 
+	genreCode = code;
 	releaseMonth = month;
 	majorActor = actor;
 }
@@ -409,7 +512,24 @@ Classics::~Classics() {};
   */
 string Classics::getSortingCriteria() const {
 
-	return getReleaseDate() + " " + getMajorActor();
+	string criteria = getReleaseDate();
+	criteria.reserve(criteria.size() + 1 + getMajorActor().size());
+	criteria.append(" ").append(getMajorActor());
+	return criteria;
+}
+
+/**
+  * Gets the sorting criteria of the classics movie as a key: release year and month (months fit in
+  * 4 bits, so one number orders by year, then month), then major actor.
+  *
+  * @return The sort key of the classics movie
+  */
+MovieSortKey Classics::getSortKey() const {
+
+	MovieSortKey key;
+	key.leadingNumber = releaseYear * 16 + releaseMonth;
+	key.firstText = majorActor;
+	return key;
 }
 
 /**
@@ -419,7 +539,7 @@ string Classics::getSortingCriteria() const {
   */
 bool Classics::isEmpty() const {
 
-	return (director == "" && title == "" && releaseYear == 0 && stock == 0 && releaseMonth == 0 && majorActor == "");
+	return (director.empty() && title.empty() && releaseYear == 0 && stock == 0 && releaseMonth == 0 && majorActor.empty());
 }
 
 /**
@@ -445,11 +565,22 @@ int Classics::getReleaseMonth() const {
 /**
   * Gets the major actor of the movie.
   * 
-  * @return The movie's major actor
+  * @return The movie's major actor (valid for the life of the process)
+  */
+string_view Classics::getMajorActor() const {
+
+	return majorActor.view();
+}
+
+/**
+  * Gets the bytes held by the Classics movie. Its strings, major actor included, are interned, so
+  * their characters are accounted to the string table.
+  *
+  * @return The movie's memory footprint in bytes
   */
-string Classics::getMajorActor() const {
+size_t Classics::getMemoryFootprint() const {
 
-	return majorActor;
+	return sizeof(*this);
 }
 
 /**
@@ -477,8 +608,8 @@ string Classics::toString() const {
   */
 bool Classics::operator==(Classics &movie) {
 
-        // checks if objects release date and major actor are identical, if so, then objects are equal
-	return getReleaseDate() == movie.getReleaseDate() && getMajorActor() == movie.getMajorActor();
+        // checks if objects release date (month and year) and major actor are identical, if so, then objects are equal
+	return releaseMonth == movie.releaseMonth && releaseYear == movie.releaseYear && majorActor == movie.majorActor;
 }
 
 /**
@@ -494,15 +625,15 @@ bool Classics::operator>(Classics &movie) {
 	// if release date is greater than argument release date, then movie is greater
         // if release date is equal to argument release date, then check if major actor
         // is greater - if so, movie object is greater.
-	if(getReleaseDate() == movie.getReleaseDate()) {
+	if(releaseYear == movie.releaseYear && releaseMonth == movie.releaseMonth) {
 
-		return majorActor > movie.getMajorActor();
+		return majorActor > movie.majorActor;
 	}
-	if(getReleaseYear() == movie.getReleaseYear()) {
+	if(releaseYear == movie.releaseYear) {
 
-		return getReleaseMonth() > movie.getReleaseMonth();
+		return releaseMonth > movie.releaseMonth;
 	}
-	return getReleaseYear() > movie.getReleaseYear();
+	return releaseYear > movie.releaseYear;
 }
 
 /**
@@ -1,36 +1,83 @@
+#ifndef MOVIE_H
+#define MOVIE_H
+
 #include<bits/stdc++.h>
 #include <iostream>
 #include <map>
 #include <iterator>
+#include "MemoryAccounting.h"
+#include "StringTable.h"
 
 using namespace std;
 
+// the sorting criteria of a movie reduced to a fixed size key. fields are compared in declaration
+// order: numbers and string indexes for equality, string characters for ordering. each genre fills
+// the fields so that comparing keys gives the same result as the genre's comparison operators.
+struct MovieSortKey {
+
+	int leadingNumber = 0;
+	InternedString firstText;
+	InternedString secondText;
+	int trailingNumber = 0;
+
+	// evaluates if the key is equal to the parameter key
+	bool operator==(const MovieSortKey &key) const {
+
+		return leadingNumber == key.leadingNumber && firstText == key.firstText && secondText == key.secondText && trailingNumber == key.trailingNumber;
+	}
+
+	// evaluates if the key is greater than the parameter key
+	bool operator>(const MovieSortKey &key) const {
+
+		if(leadingNumber != key.leadingNumber) {
+
+			return leadingNumber > key.leadingNumber;
+		}
+		if(firstText != key.firstText) {
+
+			return firstText > key.firstText;
+		}
+		if(secondText != key.secondText) {
+
+			return secondText > key.secondText;
+		}
+		return trailingNumber > key.trailingNumber;
+	}
+};
+
 // class represents a Movie with a series of parameters
 class Movie {
 
 protected:
 
-	string director;
-	string title;
+	// director and title are interned: each distinct name is stored once in the string table
+	InternedString director;
+	InternedString title;
 	short int releaseYear;
 	int stock;
 	int startingStock;
 
+	// code of the movie's genre in the movie and command files, set by the genre's constructors
+	char genreCode = 0;
+
+	// index of the media format of the copy a borrowed movie record stands for
+	unsigned char format = 0;
+
 public:
 	// default constructor
 	Movie();
 
 	// constructor sets member fields to parameter arguments
-	Movie(string movieDirector, string movieTitle, short int movieReleaseYear, int Stock);
+	Movie(string_view movieDirector, string_view movieTitle, short int movieReleaseYear, int Stock);
 
 	// destructor
 	virtual ~Movie();
 
-	// getter for director
-	string getDirector() const;
+	// getter for director (a view of the interned string)
+	string_view getDirector() const;
 
-	// getter for title
-	string getTitle() const;
+	// getter for title (a view of the interned string)
+	string_view getTitle() const;
 
 	// getter for release year
 	short int getReleaseYear() const;
@@ -41,6 +88,12 @@ public:
 	// getter for starting stock (the stock at object creation)
 	int getStartingStock() const;
 
+	// getter for the genre code (0 for a movie of no genre)
+	char getGenreCode() const;
+
+	// getter for the media format index (of a borrowed copy)
+	int getFormat() const;
+
 	// verifies the emptiness of all the object field members (set to default values?)
 	bool isEmpty() const;
 
@@ -50,12 +103,21 @@ public:
 	// string representation of sorting criteria
 	virtual string getSortingCriteria() const = 0;
 
+	// the bytes held by the movie object (its interned strings are held by the string table)
+	virtual size_t getMemoryFootprint() const;
+
 	// increments the stock
 	bool incrementStock();
 
 	// decrements the stock
 	bool decrementStock();
 
+	// sets the current and starting stock (current between 0 and starting) - used to rebuild a movie from stored fields
+	bool setStockLevels(int Stock, int StartingStock);
+
+	// setter for the media format index (of a borrowed copy)
+	void setFormat(int Format);
+
 private:
 	// setter for stock
 	void setStock(int Stock);
@@ -64,25 +126,28 @@ private:
 	void setStartingStock(int Stock);
 
 	// setter for director
-	void setDirector(string Director);
+	void setDirector(string_view Director);
 
 	// setter for title
-	void setTitle(string Title);
+	void setTitle(string_view Title);
 
 	// setter for release year
 	void setReleaseYear(short int ReleaseYear);
 };
 
 // class represents a Comedy movie with a series of parameters and its own sorting criteria
-class Comedy: public Movie {
+class Comedy final: public Movie {
 
 public:
 
+	// code of the genre in the movie and command files
+	static const char code = 'F';
+
 	// Comedy movie default constructor
 	Comedy();
 
 	// Comedy constructor sets member fields to parameter arguments
-	Comedy(short int year, string title, string director = "", int stock = 0);
+	Comedy(short int year, string_view title, string_view director = "", int stock = 0);
 
 	// Comedy destructor
 	~Comedy();
@@ -90,6 +155,9 @@ public:
 	// gets the string representation of the sorting criteria of the Comedy movie (title, year)
 	string getSortingCriteria() const;
 
+	// gets the sorting criteria of the Comedy movie as a fixed size key (title, year)
+	MovieSortKey getSortKey() const;
+
 	// verifies the emptiness of all the object field members (set to default values?)
 	bool isEmpty() const;
 
@@ -107,15 +175,18 @@ public:
 };
 
 // class represents a Drama movie with a series of parameters and its own sorting criteria
-class Drama: public Movie {
+class Drama final: public Movie {
 
 public:
 
+	// code of the genre in the movie and command files
+	static const char code = 'D';
+
 	// Drama movie default constructor
 	Drama();
 
 	// Drama constructor sets member fields to parameter arguments
-	Drama(string director, string title, short int year = 0, int stock = 0);
+	Drama(string_view director, string_view title, short int year = 0, int stock = 0);
 
 	// Drama destructor
 	~Drama();
@@ -123,6 +194,9 @@ public:
 	// gets the string representation of the sorting criteria of the Drama movie (director, title,)
 	string getSortingCriteria() const;
 
+	// gets the sorting criteria of the Drama movie as a fixed size key (director, title)
+	MovieSortKey getSortKey() const;
+
 	// verifies the emptiness of all the object field members (set to default values?)
 	bool isEmpty() const;
 
@@ -141,22 +215,25 @@ public:
 
 // class represents a Classics movie with a series of unique and inherited parameters
 // as well as its own sorting criteria
-class Classics: public Movie {
+class Classics final: public Movie {
 
 private:
 
 	// unique member variables of Classics movie object: the month the movie released, and the
 	// associated major actor featuring in the movie
 	int releaseMonth;
-	string majorActor;
+	InternedString majorActor;
 
 public:
 
+	// code of the genre in the movie and command files
+	static const char code = 'C';
+
 	// Classics movie default constructor
 	Classics();
 
 	// Classics constructor sets member fields to parameter arguments
-	Classics(short int year, int month, string actor, string director = "", string title = "", int stock = 0);
+	Classics(short int year, int month, string_view actor, string_view director = "", string_view title = "", int stock = 0);
 
 	// Classics destructor
 	~Classics();
@@ -164,6 +241,9 @@ public:
 	// gets the string representation of the sorting criteria of the Classics movie (release date *space* major actor)
 	string getSortingCriteria() const;
 
+	// gets the sorting criteria of the Classics movie as a fixed size key (release year and month, major actor)
+	MovieSortKey getSortKey() const;
+
 	// verifies the emptiness of all the object field members (set to default values?)
 	bool isEmpty() const;
 
@@ -173,8 +253,11 @@ public:
 	// getter for release month
 	int getReleaseMonth() const;
 
-	// getter for major actor
-	string getMajorActor() const;
+	// getter for major actor (a view of the interned string)
+	string_view getMajorActor() const;
+
+	// the bytes held by the Classics object (its interned strings are held by the string table)
+	size_t getMemoryFootprint() const;
 
 	// a string representation of the Classics object (prints all members of Classics object)
 	string toString() const;
@@ -190,4 +273,6 @@ public:
 
 	// stream insertion operator for Classics movies, utilizes output of toString function as string inserted into stream
 	friend ostream& operator<<(ostream &out, const Classics&c);
-};
\ No newline at end of file
+};
+
+#endif
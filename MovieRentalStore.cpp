@@ -1,4 +1,39 @@
 #include "MovieRentalStore.h"
+#include "GenreTraits.h"
+
+#include <iomanip>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+// a stream buffer discarding everything written to it (the output of files loaded through the API)
+class DiscardedOutput : public streambuf {
+
+	char buffer[4096];
+
+protected:
+
+	int overflow(int character) {
+
+		setp(buffer, buffer + sizeof(buffer));
+		return traits_type::not_eof(character);
+	}
+};
+
+/**
+  * Formats an amount of money.
+  *
+  * @param cents - The amount, in cents
+  *
+  * @return The amount in dollars, e.g. "$3.00"
+  */
+static string formatCents(long long cents) {
+
+	stringstream amount;
+	amount << "$" << cents / 100 << "." << setw(2) << setfill('0') << cents % 100;
+	return amount.str();
+}
 
 /**
   * Constructor calls functions to read files at directories specified by string arguments.
@@ -9,37 +44,147 @@
   */
 MovieRentalStore::MovieRentalStore(string movieFile, string customerFile, string commandFile) {
 
+	processFiles(movieFile, customerFile, commandFile);
+}
+
+/**
+  * Reads the movie and customer files, then executes the command file. Stops at the first file that
+  * cannot be read.
+  *
+  * @param movieFile - The directory of the movie file, listing all movies to be added to inventory
+  * @param customerFile - The directory of the customer file, listing all customer to be added to database
+  * @param commandFile - The directory of the command file, listing all commands to be acted on the database
+  *
+  * @return Whether all three files were read
+  */
+bool MovieRentalStore::processFiles(string movieFile, string customerFile, string commandFile) {
+
 	// open and scan the movie file via it's directory, print error in failure
 	if(!scanMovieFile(movieFile)) {
 
 		cout << "Won't read customer and command files." << endl;
-		return;
+		return false;
 	}
 	// open and scan the customer file via it's directory, print error in failure
 	if(!scanCustomerFile(customerFile)) {
 
 		cout << "Won't read command file." << endl;
-		return;
+		return false;
 	}
 	// open and scan the command file via it's directory, print error in failure
 	cout << "------------------------------Commands Begin------------------------------" << endl;
-	scanCommandFile(commandFile);
+	return scanCommandFile(commandFile);
+}
+
+/**
+  * Default constructor builds an empty store. Movies, customers and commands are added afterwards
+  * via the file processing functions.
+  */
+MovieRentalStore::MovieRentalStore() {}
+
+/**
+  * Reads the catalog configuration file, listing the media formats and genres the store carries, and
+  * sets every genre inventory to keep stock for each format. Must be called before any movie is added.
+  *
+  * @param configFile - The directory of the catalog configuration file
+  *
+  * @return Whether the configuration was read and applied
+  */
+bool MovieRentalStore::loadCatalogConfig(string configFile) {
+
+	bool empty = true;
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		empty = empty && (this->*GenreTraits<MovieType>::inventory).getSize() == 0;
+	});
+	if(!empty) {
+
+		cout << "The catalog configuration can only be loaded before movies are added to inventory." << endl;
+		return false;
+	}
+	if(!catalog.load(configFile, StoreGenres::getCodes())) {
+
+		return false;
+	}
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		(this->*GenreTraits<MovieType>::inventory).setFormatCodes(catalog.getFormatCodes());
+	});
+	return true;
 }
 
 /**
-  * Destructor deallocates memory associated with object. Customer array and movie pointer array
-  * for each customer in customer-movie borrow map are explicitly deleted.
+  * Constructor calls functions to read the movie and customer files at directories specified by string
+  * arguments. No commands are executed; they are expected to arrive later via "executeCommand".
+  *
+  * @param movieFile - The directory of the movie file, listing all movies to be added to inventory
+  * @param customerFile - The directory of the customer file, listing all customer to be added to database
+  */
+MovieRentalStore::MovieRentalStore(string movieFile, string customerFile) {
+
+	// open and scan the movie file via it's directory, print error in failure
+	if(!scanMovieFile(movieFile)) {
+
+		cout << "Won't read customer file." << endl;
+		return;
+	}
+	// open and scan the customer file via it's directory, print error in failure
+	scanCustomerFile(customerFile);
+}
+
+/**
+  * Destructor deallocates memory associated with object. Chained customers are destroyed, then the
+  * customer array and movie pointer array for each customer in customer-movie borrow map are
+  * explicitly deleted. Customer and movie records live in slab pools freed along with the store.
   */
 MovieRentalStore::~MovieRentalStore() {
 
+	// destroy the chained customers iteratively; their blocks are released with the pool's slabs
+	for(int i = 0; i < maxNumberofCustomers; i++) {
+
+		if(MemoryAccounting::isEnabled()) {
+
+			MemoryAccounting::recordFree(MemorySubsystem::CustomerTable, customers[i].getNameBytes());
+			MemoryAccounting::recordFree(MemorySubsystem::History, customers[i].getHistoryBytes());
+		}
+		Customer *customer = customers[i].getNextCustomer();
+		while(customer != nullptr) {
+
+			Customer *nextCustomer = customer->getNextCustomer();
+			if(MemoryAccounting::isEnabled()) {
+
+				MemoryAccounting::recordFree(MemorySubsystem::CustomerTable, sizeof(Customer) + customer->getNameBytes());
+				MemoryAccounting::recordFree(MemorySubsystem::History, customer->getHistoryBytes());
+			}
+			customerPool.destroy(customer);
+			customer = nextCustomer;
+		}
+		customers[i].setNextCustomer(nullptr);
+	}
+	MemoryAccounting::recordFree(MemorySubsystem::CustomerTable, (long long) maxNumberofCustomers * sizeof(Customer));
 	delete[] customers;
 	clearCustMovieBorrowData();
 }
 
+/**
+  * Allocates the customer hash table.
+  *
+  * @param tableSize - The number of slots in the table
+  *
+  * @return The customer hash table
+  */
+Customer *MovieRentalStore::allocateCustomerTable(int tableSize) {
+
+	MemoryAccounting::recordAllocation(MemorySubsystem::CustomerTable, (long long) tableSize * sizeof(Customer));
+	return new Customer[tableSize];
+}
+
 /**
   * Generates hash code for given integer value and hash table size.
   * Hash function uses digit folding method. Used to generate hash value for
-  * customer IDs.
+  * customer IDs (a negative key is hashed as its magnitude).
   *
   * @param key - The value to be transformed into a hash key
   * @param hashTableSize - The size of the hash table
@@ -48,23 +193,20 @@ MovieRentalStore::~MovieRentalStore() {
   */
 int MovieRentalStore::getHashCode(int key, int hashTableSize) {
 
-	string keyString = to_string(key);
+	// the digits of the key, folded from the left in groups of as many digits as the largest index of the
+	// table has (the last group may be shorter), formatted and summed without allocating
+	char keyString[16];
+	int keyStringLength = to_chars(keyString, keyString + sizeof(keyString), key < 0 ? 0u - (unsigned int) key : (unsigned int) key).ptr - keyString;
 	int numberOfDigitsInTableSizeOneLess = log10(hashTableSize - 1) + 1;
 	int hashCode = 0;
-	int keyStringLength = keyString.length();
-	int iterations = keyStringLength / numberOfDigitsInTableSizeOneLess;
-	int index = 0;
-	for(int i = 0; i < iterations; i++, index+=numberOfDigitsInTableSizeOneLess) {
+	for(int index = 0; index < keyStringLength; index += numberOfDigitsInTableSizeOneLess) {
 
-		hashCode += stoi(keyString.substr(index, numberOfDigitsInTableSizeOneLess));
-		if((index + numberOfDigitsInTableSizeOneLess)/numberOfDigitsInTableSizeOneLess >= iterations && (index + numberOfDigitsInTableSizeOneLess < keyStringLength)) {
+		int group = 0;
+		for(int i = index; i < min(index + numberOfDigitsInTableSizeOneLess, keyStringLength); i++) {
 
-			hashCode += stoi(keyString.substr(index+numberOfDigitsInTableSizeOneLess));
+			group = group * 10 + (keyString[i] - '0');
 		}
-	}
-	if(iterations == 0) {
-
-		hashCode += key;
+		hashCode += group;
 	}
 	return hashCode % hashTableSize;
 }
@@ -81,9 +223,10 @@ void MovieRentalStore::addCustomer(Customer *customer) {
 	int custIndex = getHashCode(customer->getCustomerID(), maxNumberofCustomers);
 	if(customers[custIndex].isEmpty()) {
 
-		customers[custIndex] = *customer;
+		customers[custIndex] = move(*customer);
+		MemoryAccounting::recordAllocation(MemorySubsystem::CustomerTable, customers[custIndex].getNameBytes());
 		cout << "Customer added successfully (ID, First Name, Last Name): " << customers[custIndex].getCustomerID() << ", " << customers[custIndex].getFirstName() << ", " << customers[custIndex].getLastName() << endl;
-		delete(customer);
+		customerPool.destroy(customer);
 	}
 	else {
 
@@ -93,7 +236,7 @@ void MovieRentalStore::addCustomer(Customer *customer) {
 			if(*nextCustomer == *customer) {
 
 				cout << "Customer with ID - " << nextCustomer->getCustomerID() << " is already in database." << endl;
-				delete(customer);
+				customerPool.destroy(customer);
 				return;
 			}
 			nextCustomer = nextCustomer->getNextCustomer();
@@ -101,10 +244,11 @@ void MovieRentalStore::addCustomer(Customer *customer) {
 		if(*nextCustomer == *customer) {
 
 			cout << "Customer with ID - " << nextCustomer->getCustomerID() << " is already in database." << endl;
-			delete(customer);
+			customerPool.destroy(customer);
 			return;
 		}
 		nextCustomer->setNextCustomer(customer);
+		MemoryAccounting::recordAllocation(MemorySubsystem::CustomerTable, sizeof(Customer) + customer->getNameBytes());
 		cout << "Customer added successfully (ID, First Name, Last Name): " << customer->getCustomerID() << ", " << customer->getFirstName() << ", " << customer->getLastName() << endl;
 	}
 }
@@ -120,6 +264,10 @@ bool MovieRentalStore::findCustomer(int custID) {
 
 	// generates hash value for customer ID
 	int custIndex = getHashCode(custID, maxNumberofCustomers);
+	if(statistics.enabled) {
+
+		statistics.customerLookups++;
+	}
 
 	// checks if index for customer hash value in array is empty
 	if(customers[custIndex].isEmpty()) {
@@ -130,12 +278,20 @@ bool MovieRentalStore::findCustomer(int custID) {
 
 		// search through the linked-list chain within taken customer index slot
 		Customer *nextCustomer = &customers[custIndex];
+		if(statistics.enabled) {
+
+			statistics.customerProbes++;
+		}
 		if(nextCustomer->getCustomerID() == custID) {
 
 			return true;
 		}
 		while(nextCustomer->getNextCustomer() != nullptr) {
 
+			if(statistics.enabled) {
+
+				statistics.customerProbes++;
+			}
 			if((nextCustomer->getNextCustomer())->getCustomerID() == custID) {
 
 				return true;
@@ -164,7 +320,7 @@ bool MovieRentalStore::addTransaction(string transaction, int custID) {
 		Customer *customer = &customers[custIndex];
 		if(customer->getCustomerID() == custID) {
 
-			customer->addTransaction(transaction);
+			customer->addTransaction(move(transaction));
 		}
 		else {
 
@@ -172,7 +328,7 @@ bool MovieRentalStore::addTransaction(string transaction, int custID) {
 
 				if(customer->getNextCustomer()->getCustomerID() == custID) {
 
-					customer->getNextCustomer()->addTransaction(transaction);
+					customer->getNextCustomer()->addTransaction(move(transaction));
 					return true;
 				}
 				customer = customer->getNextCustomer();
@@ -184,13 +340,14 @@ bool MovieRentalStore::addTransaction(string transaction, int custID) {
 }
 
 /**
-  * Prints the vector list of transactions associated with the customer ID passed as argument.
+  * Prints the transactions associated with the customer ID passed as argument, newest first.
   *
   * @param custID - The ID of the customer who's transactions are being printed
+  * @param count - The most transactions printed (the newest ones)
   *
   * @return The success status of the transaction output (only fails if customer not found)
   */
-bool MovieRentalStore::printCustomerTransHistory(int custID) {
+bool MovieRentalStore::printCustomerTransHistory(int custID, size_t count) {
 
 	int custIndex;
 	if(findCustomer(custID)) {
@@ -199,7 +356,7 @@ bool MovieRentalStore::printCustomerTransHistory(int custID) {
 		if(customers[custIndex].getCustomerID() == custID) {
 
 			cout << "Printing transactions of customer with cust ID: " << custID << endl;
-			customers[custIndex].printCustomerTransactions();
+			customers[custIndex].printCustomerTransactions(count);
 			return true;
 		}
 		else {
@@ -210,7 +367,7 @@ bool MovieRentalStore::printCustomerTransHistory(int custID) {
 				if(nextCustomer->getNextCustomer()->getCustomerID() == custID) {
 
 					cout << "Printing transactions of customer with cust ID: " << custID << endl;
-					nextCustomer->getNextCustomer()->printCustomerTransactions();
+					nextCustomer->getNextCustomer()->printCustomerTransactions(count);
 					return true;
 				}
 				nextCustomer = nextCustomer->getNextCustomer();
@@ -234,6 +391,11 @@ bool MovieRentalStore::initializeCustomerBorrowList(int custID) {
 		return false;
 	}
 	Movie **customerMovieArray = new Movie*[defaultMaxCustMovieLimit];
+	if(statistics.enabled) {
+
+		statistics.borrowListAllocations++;
+	}
+	MemoryAccounting::recordAllocation(MemorySubsystem::Ledgers, defaultMaxCustMovieLimit * sizeof(Movie*));
 	moviesBorrowedByCustomers[custID] = customerMovieArray;
 	for(int i = 0; i < defaultMaxCustMovieLimit; i++) {
 
@@ -245,19 +407,20 @@ bool MovieRentalStore::initializeCustomerBorrowList(int custID) {
 /**
   * Add argument movie to customer borrow list.
   *
+  * @param movie - The movie being added to customer's borrow list
   * @param custID - The ID of the customer who's adding a movie to their borrow list
   *
-  * @return The success status of the borrow list insertion (only fails if customer not found
-  * or customer has already borrowed the max number of movies - 13)
+  * @return The outcome of the borrow list insertion: "Ok", or "UnknownCustomer" if customer not found,
+  * or "BorrowLimitReached" if customer has already borrowed the max number of movies - 13
   */
-bool MovieRentalStore::addToCustomersBorrowList(Movie *movie, int custID) {
+template <typename MovieType>
+CommandStatus MovieRentalStore::addToCustomersBorrowList(MovieType *movie, int custID) {
 
 	if(moviesBorrowedByCustomers.find(custID) == moviesBorrowedByCustomers.end()) {
 
 		if(!initializeCustomerBorrowList(custID)) {
 
-			cout << "Customer with ID: " << to_string(custID) << " cannot borrow. They are not in the database." << endl;
-			return false;
+			return CommandStatus::UnknownCustomer;
 		}
 	}
 	for(int i = 0; i < defaultMaxCustMovieLimit; i++) {
@@ -265,11 +428,16 @@ bool MovieRentalStore::addToCustomersBorrowList(Movie *movie, int custID) {
 		if(moviesBorrowedByCustomers[custID][i] == nullptr) {
 
 			moviesBorrowedByCustomers[custID][i] = movie;
-			return true;
+			MemoryAccounting::recordAllocation(MemorySubsystem::Ledgers, movie->getMemoryFootprint());
+			openRental(movie, custID);
+			return CommandStatus::Ok;
 		}
 	}
-	cout << "Customer with ID: " << custID << " has the max number of movies borrowed." << endl;
-	return false;
+	if(statistics.enabled) {
+
+		statistics.borrowLimitReached++;
+	}
+	return CommandStatus::BorrowLimitReached;
 }
 
 /**
@@ -293,14 +461,17 @@ bool MovieRentalStore::customerBorrowListEmpty(int custID) {
 }
 
 /**
-  * Remove argument movie from argument customer's borrow list.
+  * Remove argument movie from argument customer's borrow list. Borrowed movies are matched by genre
+  * code and sort key, so no virtual call is made on the movies of the list.
   *
   * @param movie - The movie being removed from customer's borrow list
   * @param custID - The ID of the customer who's removing a movie from their borrow list
   *
-  * @return The success status of the borrow list removal
+  * @return The outcome of the borrow list removal: "Ok", "NothingBorrowed" if the customer holds no
+  * movies, or "NotBorrowed" if they hold no copy of the movie
   */
-bool MovieRentalStore::removeFromCustomerList(Movie *movie, int custID) {
+template <typename MovieType>
+CommandStatus MovieRentalStore::removeFromCustomerList(MovieType *movie, int custID) {
 
 	// checks if movie is nullptr or empty (default constructed) movie. Also checks movie borrow map to evaluate if
         // customer borrowed any movies. If these conditions are true, return  false. Return false
@@ -308,13 +479,17 @@ bool MovieRentalStore::removeFromCustomerList(Movie *movie, int custID) {
         // borrow any movies at all.
 	if(movie != nullptr && !movie->isEmpty() && moviesBorrowedByCustomers.find(custID) != moviesBorrowedByCustomers.end()) {
 
+		MovieSortKey sortKey = movie->getSortKey();
 		for(int i = 0; i < defaultMaxCustMovieLimit; i++) {
 
-			if(moviesBorrowedByCustomers[custID][i] != nullptr) {
+			if(moviesBorrowedByCustomers[custID][i] != nullptr && moviesBorrowedByCustomers[custID][i]->getGenreCode() == MovieType::code) {
 
-				if(moviesBorrowedByCustomers[custID][i]->getSortingCriteria() == movie->getSortingCriteria()) {
+				MovieType *borrowedMovie = static_cast<MovieType*>(moviesBorrowedByCustomers[custID][i]);
+				if(borrowedMovie->getFormat() == movie->getFormat() && borrowedMovie->getSortKey() == sortKey) {
 
-					delete(moviesBorrowedByCustomers[custID][i]);
+					MemoryAccounting::recordFree(MemorySubsystem::Ledgers, borrowedMovie->getMemoryFootprint());
+					closeRental(borrowedMovie, custID);
+					movieRecordPool.destroy(borrowedMovie);
 					moviesBorrowedByCustomers[custID][i] = nullptr;
 					while(i < defaultMaxCustMovieLimit - 1) {
 
@@ -332,16 +507,151 @@ bool MovieRentalStore::removeFromCustomerList(Movie *movie, int custID) {
 					}
 					if(customerBorrowListEmpty(custID)) {
 
+						MemoryAccounting::recordFree(MemorySubsystem::Ledgers, defaultMaxCustMovieLimit * sizeof(Movie*));
 						delete[] moviesBorrowedByCustomers[custID];
 						moviesBorrowedByCustomers.erase(custID);
 					}
-					return true;
+					return CommandStatus::Ok;
 				}
 			}
 		}
-		cout << "Customer with ID: " << custID << " did not borrow this film (sorting criteria - " << movie->getSortingCriteria() << ")." << endl;
+		if(statistics.enabled) {
+
+			statistics.notBorrowed++;
+		}
+		return CommandStatus::NotBorrowed;
+	}
+	return CommandStatus::NothingBorrowed;
+}
+
+/**
+  * Gets the current time of the store, from its clock.
+  *
+  * @return The time, in seconds since the epoch
+  */
+long long MovieRentalStore::getCurrentTime() {
+
+	return clock->now();
+}
+
+/**
+  * Installs a clock as the store's clock, e.g. a simulated clock for command files and benchmarks
+  * whose "T"/Time commands give the time.
+  *
+  * @param storeClock - The clock (not owned; must outlive the store or be replaced)
+  */
+void MovieRentalStore::setClock(StoreClock *storeClock) {
+
+	clock = storeClock;
+}
+
+/**
+  * Sets the time of the store's clock, which must be simulated. Time only moves forward.
+  *
+  * @param time - A time (seconds since the epoch, or a UTC date "YYYY-MM-DD" optionally followed by
+  * "HH:MM" or "HH:MM:SS"), or "+" followed by the seconds to move the clock forward by
+  *
+  * @return Whether the clock was set
+  */
+bool MovieRentalStore::setStoreTime(string time) {
+
+	if(!clock->isSimulated()) {
+
+		cout << "The store clock (" << clock->getName() << ") cannot be set." << endl;
+		return false;
+	}
+	long long newTime;
+	if(time != "" && time[0] == '+') {
+
+		newTime = StoreClock::parseTime(time.substr(1));
+		newTime = newTime < 0 ? -1 : clock->now() + newTime;
+	}
+	else {
+
+		newTime = StoreClock::parseTime(time);
+	}
+	if(newTime < 0) {
+
+		cout << "Invalid time: " << time << "." << endl;
+		return false;
+	}
+	if(!clock->setTime(newTime)) {
+
+		cout << "Time " << StoreClock::formatTime(newTime) << " is before the store time " << StoreClock::formatTime(clock->now()) << "." << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+  * Appends a command line to the journal. A command stamped with the time (a borrow opens a rental
+  * due some days later) is replayed at the time it was executed: unless the store clock is simulated
+  * (its "T"/Time commands are journaled themselves), the current time is journaled first whenever
+  * it changed since the last command. Once the journal has failed, the command (already executed)
+  * is reported as not durable.
+  *
+  * @param line - The command line
+  *
+  * @return Whether the command was appended to the journal
+  */
+bool MovieRentalStore::journalCommand(string_view line) {
+
+	if(!clock->isSimulated()) {
+
+		long long now = clock->now();
+		if(now != lastJournalTime) {
+
+			journal->append("T " + to_string(now));
+			lastJournalTime = now;
+		}
+	}
+	unsigned long long sequence = journal->append(line);
+	if(sequence == 0) {
+
+		commandResult.status = CommandStatus::NotDurable;
+		cout << "The following command was executed but could not be journaled (" << journal->getFailure() << "): " << line << "." << endl;
+		return false;
+	}
+	lastJournalSequence = sequence;
+	return true;
+}
+
+/**
+  * Opens the rental of a movie record added to a customer's borrow list: borrowed now, due back
+  * "loanPeriodDays" later.
+  *
+  * @param copy - The movie record held by the borrow list
+  * @param custID - The ID of the customer
+  */
+void MovieRentalStore::openRental(const Movie *copy, int custID) {
+
+	long long now = getCurrentTime();
+	dueDates.add(copy, custID, now, now + loanPeriodDays * DueDates::secondsPerDay);
+}
+
+/**
+  * Closes the rental of a movie record removed from a customer's borrow list. A copy returned past
+  * its due time is charged "lateFeeCentsPerDay" for every day started since, added to the
+  * customer's transaction history and to the result of the return command.
+  *
+  * @param copy - The movie record held by the borrow list
+  * @param custID - The ID of the customer
+  */
+void MovieRentalStore::closeRental(const Movie *copy, int custID) {
+
+	DueDates::Rental rental;
+	if(!dueDates.remove(copy, rental)) {
+
+		return;
+	}
+	long long daysLate = DueDates::getDaysLate(rental, getCurrentTime());
+	if(daysLate > 0) {
+
+		commandResult.lateFeeCents = daysLate * lateFeeCentsPerDay;
+		string fee = formatCents(daysLate * lateFeeCentsPerDay);
+		cout << "Customer " << custID << " returned " << copy->getSortingCriteria() << " " << daysLate << " day(s) late. Late fee: " << fee << "." << endl;
+		addTransaction("Late fee of " + fee + " for movie with sorting criteria: " + copy->getSortingCriteria() + " (" + to_string(daysLate) + " day(s) late)", custID);
 	}
-	return false;
 }
 
 /**
@@ -356,10 +666,12 @@ void MovieRentalStore::clearCustMovieBorrowData() {
 
 			if(it->second[p] != nullptr) {
 
-				delete(it->second[p]);
+				MemoryAccounting::recordFree(MemorySubsystem::Ledgers, it->second[p]->getMemoryFootprint());
+				movieRecordPool.destroy(it->second[p]);
 				it->second[p] = nullptr;
 			}
 		}
+		MemoryAccounting::recordFree(MemorySubsystem::Ledgers, defaultMaxCustMovieLimit * sizeof(Movie*));
 		delete[] it->second;
 		it->second = nullptr;
 	}
@@ -380,838 +692,1923 @@ void MovieRentalStore::outputStoreInventory() {
 }
 
 /**
-  * Constructs a movie object from a given line from the movie file, passed as a stringstream argument.
-  * This movie object is then added to the appropriate genre inventory. Function handles construction
-  * of Drama and Comedy movies. Genre is specified by argument.
+  * Constructs a movie of the genre from a given line from the movie file with the genre's parser (see
+  * GenreTraits.h). This movie object is then added to the genre's inventory.
   *
   * @param movieParameters - The file line that holds the movie's information
-  * @param genre - The genre of the movie
   *
-  * @return The success state of the movie object insertion into inventory
+  * @return The success state of the movie object insertion into inventory (a line the parser rejects is
+  * counted in "statistics.malformedLines")
   */
-bool MovieRentalStore::DefaultMovieFactory(stringstream& movieParameters, char genre) {
+template <typename MovieType>
+bool MovieRentalStore::MovieFactory(string_view movieParameters) {
 
-        // holds a given comma delimited token of a parsed line from a movie file
-	string movieParameter;
+	// movie and its stock in every format
+	MovieType movie;
+	int formatStock[CatalogConfig::maxFormats];
+	if(!GenreTraits<MovieType>::parseMovieLine(movieParameters, catalog, movie, formatStock)) {
 
-	// holds the token held by "movieParameter" excluding the first space character
-	string cleanedParameter;
+		statistics.malformedLines++;
+		return false;
+	}
 
-	// counts the number of movie variables parsed as tokens
-	int parameterCounter = 1;
+	// add to corresponding inventory (which stores a copy), and to the title indexes
+	if(!(this->*GenreTraits<MovieType>::inventory).Insert(movie, formatStock)) {
 
-	// movie stock
-	int stock;
+		return false;
+	}
+	indexMovie(movie, true);
+	return true;
+}
 
-	// movie director
-	string director;
+/**
+  * Adds a movie to, or removes it from, the title search index and the secondary indexes enabled.
+  * Called as titles are added to and retired from inventory; restocking a title changes none of
+  * the attributes indexed.
+  *
+  * @param movie - The movie
+  * @param added - Whether the movie was added (else retired)
+  */
+template <typename MovieType>
+void MovieRentalStore::indexMovie(const MovieType &movie, bool added) {
 
-	// movie title
-	string title;
+	string command = getMovieCommand(movie);
+	if(added) {
 
-	// movie release year
-	short int releaseYear;
+		titleIndex.add(command, GenreTraits<MovieType>::getSearchText(movie));
+		secondaryIndexes.add(movie, command, GenreTraits<MovieType>::getMajorActor(movie));
+	}
+	else {
 
-	// loop parses through movie line and assigns movie's parameters and constructs the
-	// appropriate genre's movie object
-	while(getline(movieParameters, movieParameter, ',')) {
+		titleIndex.remove(command);
+		secondaryIndexes.remove(movie, command, GenreTraits<MovieType>::getMajorActor(movie));
+	}
+}
 
-		// get token removing starting space character
-		cleanedParameter = movieParameter.substr(1);
+/**
+  * Builds the transaction of a movie borrowed, returned or waitlisted in a format, e.g. "Borrowed
+  * comedy DVD movie with sorting criteria: Fargo, 1996". The transaction is sized once, as the
+  * customer's history keeps it.
+  *
+  * @param action - What was done, e.g. "Borrowed" or "Waitlisted for"
+  * @param movie - The movie
+  * @param format - The index of the media format
+  * @param note - Text ending the transaction, e.g. " (from the waitlist)"
+  *
+  * @return The transaction
+  */
+template <typename MovieType>
+string MovieRentalStore::makeTransaction(const char *action, const MovieType &movie, int format, const char *note) {
+
+	const char *criteriaLabel = " movie with sorting criteria: ";
+	const char *genreName = GenreTraits<MovieType>::name;
+	const string &formatName = catalog.getFormatName(format);
+	string criteria = movie.getSortingCriteria();
+	string transaction;
+	transaction.reserve(strlen(action) + strlen(genreName) + formatName.size() + strlen(criteriaLabel) + criteria.size() + strlen(note) + 2);
+	transaction.append(action).append(" ").append(genreName).append(" ").append(formatName).append(criteriaLabel).append(criteria).append(note);
+	return transaction;
+}
 
-		// depending on loop iteration, assign different movie parameters
-		switch(parameterCounter) {
+/**
+  * Constructs a movie of the genre from the movie portion of a borrow or return command. The movie is
+  * constructed from its sorting criteria exclusively, by the genre's
+  * parser (see GenreTraits.h). The stock of the movie, if found, is decremented if a borrow command, or
+  * increments if a return command. The borrow list for the given customer is also modified accordingly.
+  * 
+  * @param movieParameters - The movie portion of the borrow or return command, following the genre code
+  * @param custID - The customer conducting a command
+  * @param format - The index of the media format borrowed or returned
+  * @param borrowOrReturn - Whether the command being processed is a movie borrow or return
+  * @param waitIfOutOfStock - Whether a borrow of a movie out of stock joins the movie's waitlist (a
+  * return always lends the copy returned to the first customer waiting, if any)
+  *
+  * @return The success state of whether the movie specified in stringstream had it's stock changed appropriately and customer's borrow list was updated
+  * (or the customer joined the waitlist); the outcome is reported in "commandResult"
+  */
+template <typename MovieType>
+bool MovieRentalStore::borrowReturnCommandHelper(string_view movieParameters, int custID, int format, bool borrowOrReturn, bool waitIfOutOfStock) {
 
-			case 1:
-				break;
+	typedef GenreTraits<MovieType> Traits;
+	InventoryTree<MovieType> &inventory = this->*Traits::inventory;
 
-			case 2:
-				stock = stoi(cleanedParameter);
-				break;
-			case 3:
-				director = cleanedParameter;
-				break;
-			case 4:
-				title = cleanedParameter;
-				break;
-			case 5:
-				releaseYear = stoi(cleanedParameter);
-				break;
-			default:
-				break;
-		}
-		parameterCounter++;
+	// generate movie object; a movie whose numbers are malformed fails the command, and one whose
+	// names are not interned is not carried
+	MovieType parsedMovie;
+	bool carried = false;
+	if(!Traits::parseCommand(movieParameters, parsedMovie, carried)) {
+
+		statistics.malformedLines++;
+		commandResult.status = CommandStatus::MalformedCommand;
+		commandResult.argument = movieParameters;
+		return false;
+	}
+	if(!carried) {
+
+		inventory.countNotFound();
+		commandResult.status = CommandStatus::MovieNotFound;
+		commandResult.stock = -1;
+		commandResult.argument = movieParameters;
+		return false;
+	}
+	MovieType *movie = movieRecordPool.create<MovieType>(move(parsedMovie));
+	movie->setFormat(format);
+	if(statistics.enabled) {
+
+		statistics.movieRecordAllocations++;
 	}
-	movieParameters.str("");
 
-	// construct movie object according to genre parameter and add to corresponding inventory
-	if(genre == 'F') {
+	// if borrow command and inventory successfully decremented, else if return command and
+	// inventory successfully incremented, else one of the inventory changes failed
+	int slot = inventory.changeMediaStock(*movie, !borrowOrReturn, format);
+	commandResult.slot = slot < 0 ? -1 : slot;
+	if(borrowOrReturn && slot >= 0) {
 
-		Comedy *comedyMovie = new Comedy(releaseYear, title, director, stock);
-		if(comedyMovieInventory.Insert(*comedyMovie)) {
+		// if failed to add to customer borrow list, then backtrack inventory change - increment stock
+		commandResult.status = addToCustomersBorrowList(movie, custID);
+		if(commandResult.status != CommandStatus::Ok) {
 
-			delete(comedyMovie);
-			return true;
+			if(commandResult.status == CommandStatus::UnknownCustomer) {
+
+				commandResult.argument = to_string(custID);
+			}
+			inventory.changeMediaStock(*movie, true, format);
+			commandResult.stock = inventory.getStockAt(slot, format);
+			movieRecordPool.destroy(movie);
+			movie = nullptr;
+			return false;
 		}
+		commandResult.stock = inventory.getStockAt(slot, format);
+		addTransaction(makeTransaction("Borrowed", *movie, format), custID);
+		return true;
 	}
-	else if(genre == 'D') {
+	else if(!borrowOrReturn && slot >= 0) {
 
-		Drama *dramaMovie = new Drama(director, title, releaseYear, stock);
-		if(dramaMovieInventory.Insert(*dramaMovie)) {
-
-			delete(dramaMovie);
-			return true;
+		// if failed to remove from customer borrow list, then backtrack inventory change - decrement stock
+		commandResult.status = removeFromCustomerList(movie, custID);
+		if(commandResult.status != CommandStatus::Ok) {
+
+			inventory.changeMediaStock(*movie, false, format);
+			commandResult.stock = inventory.getStockAt(slot, format);
+			commandResult.argument = movie->getSortingCriteria();
+			movieRecordPool.destroy(movie);
+			movie = nullptr;
+			return false;
 		}
-		delete(dramaMovie);
+		addTransaction(makeTransaction("Returned", *movie, format), custID);
+
+		// the copy returned goes straight to the first customer waiting for it
+		commandResult.copiesLent = serveWaitlist(*movie, format, &commandResult.lentTo);
+		commandResult.stock = inventory.getStockAt(slot, format);
+		movieRecordPool.destroy(movie);
+		movie = nullptr;
+		return true;
+	}
+	commandResult.argument = movie->getSortingCriteria();
+	if(borrowOrReturn && waitIfOutOfStock && slot == StockNoneLeft) {
+
+		string title = getWaitlistTitle(*movie, format);
+		commandResult.status = CommandStatus::Waitlisted;
+		commandResult.waitlistPosition = waitlists.enqueue(title, custID);
+		commandResult.stock = 0;
+		addTransaction(makeTransaction("Waitlisted for", *movie, format), custID);
+		movieRecordPool.destroy(movie);
+		movie = nullptr;
+		return true;
+	}
+	else {
+
+		commandResult.status = slot == StockMovieNotFound ? CommandStatus::MovieNotFound : slot == StockNoneLeft ? CommandStatus::OutOfStock
+			: CommandStatus::StockAtMaximum;
+		commandResult.stock = slot == StockMovieNotFound ? -1 : inventory.getStock(*movie, format);
+		movieRecordPool.destroy(movie);
+		movie = nullptr;
+		return false;
 	}
-	return false;
 }
 
 /**
-  * Constructs a classics movie object from a given line from the movie file, passed as a
-  * stringstream argument. This movie object is then added to the appropriate genre inventory.
+  * Gets the name of the waitlist of a movie in a format: the format code, a space and the movie
+  * portion of the borrow command naming the movie.
   *
-  * @param movieParameters - The file line that holds the movie's information
+  * @param movie - The movie
+  * @param format - The index of the media format
   *
-  * @return The success state of the movie object insertion into inventory
+  * @return The name of the waitlist, e.g. "D F You've Got Mail, 1998"
   */
-bool MovieRentalStore::ClassicMovieFactory(stringstream& movieParameters) {
+template <typename MovieType>
+string MovieRentalStore::getWaitlistTitle(const MovieType &movie, int format) {
 
-        // holds a given comma delimited token of a parsed line from a movie file
-	string movieParameter;
+	return string(1, catalog.getFormatCodes()[format]) + " " + getMovieCommand(movie);
+}
 
-	// holds the token held by "movieParameter" excluding the first space character
-	string cleanedParameter;
+/**
+  * Lends the copies in stock of a movie to the customers waiting for it, first come first served,
+  * as a borrow of theirs would (a transaction is added to their history). Called when copies are
+  * returned or restocked. A customer who cannot borrow (at their borrow limit) leaves the
+  * waitlist without a copy.
+  *
+  * @param movie - The movie (only its sorting criteria are compared)
+  * @param format - The index of the media format
+  * @param servedCustID - Receives the ID of the last customer lent a copy, if not nullptr
+  *
+  * @return The number of copies lent
+  */
+template <typename MovieType>
+int MovieRentalStore::serveWaitlist(MovieType &movie, int format, int *servedCustID) {
 
-	// counts the number of movie variables parsed as tokens
-	int parameterCounter = 1;
+	typedef GenreTraits<MovieType> Traits;
+	InventoryTree<MovieType> &inventory = this->*Traits::inventory;
 
-	// movie stock
-	int stock;
+	// most returns find nobody waiting for anything, and need not name the waitlist
+	if(waitlists.getWaiterCount() == 0) {
 
-	// movie director
-	string director;
+		return 0;
+	}
+	string title = getWaitlistTitle(movie, format);
+	int lent = 0;
+	while(waitlists.getWaiting(title) > 0 && inventory.getStock(movie, format) > 0) {
 
-	// movie title
-	string title;
+		int custID = waitlists.dequeue(title);
+		MovieType *copy = movieRecordPool.create<MovieType>(movie);
+		copy->setFormat(format);
+		if(statistics.enabled) {
 
-	// movie major actor
-	string majorActor;
+			statistics.movieRecordAllocations++;
+		}
+		inventory.changeMediaStock(*copy, false, format);
+		CommandStatus status = addToCustomersBorrowList(copy, custID);
+		if(status != CommandStatus::Ok) {
 
-	// movie release month
-	char releaseMonth;
+			if(status == CommandStatus::BorrowLimitReached) {
 
-	// movie release year
-	int releaseYear;
+				cout << "Customer with ID: " << custID << " has the max number of movies borrowed." << endl;
+			}
+			cout << "Customer " << custID << " left the waitlist for " << title << " without a copy." << endl;
+			inventory.changeMediaStock(*copy, true, format);
+			movieRecordPool.destroy(copy);
+			continue;
+		}
+		cout << "Copy of " << title << " lent to waiting customer " << custID << "." << endl;
+		addTransaction(makeTransaction("Borrowed", *copy, format, " (from the waitlist)"), custID);
+		if(servedCustID != nullptr) {
 
-	// loop parses through movie line and assigns movie's parameters and constructs the
-	// appropriate genre's movie object
-	while(getline(movieParameters, movieParameter, ',')) {
+			*servedCustID = custID;
+		}
+		lent++;
+	}
+	return lent;
+}
 
-		// get token removing starting space character
-		cleanedParameter = movieParameter.substr(1);
+/**
+  * Utilizes helper functions to process borrow and return commands. Borrow commands decrement a given movie's stock in
+  * inventory. Return commands increment a given movie's stock in inventory. Determine genre of film via the command's
+  * space delimited tokens and call appropriate helper function with the rest of the command.
+  * 
+  * @param borrowReturnCommand - The borrow or return command line, following the action code
+  * @param borrowOrReturn - Whether the command represents a borrow or return (1 - borrow, 0 - return)
+  * @param waitIfOutOfStock - Whether a borrow of a movie out of stock joins the movie's waitlist
+  *
+  * @return The success state of the execution of the command; the outcome is reported in
+  * "commandResult" (printed by "printCommandResult")
+  */
+bool MovieRentalStore::handleBorrowReturnCommand(string_view borrowReturnCommand, bool borrowOrReturn, bool waitIfOutOfStock) {
 
-		// depending on loop iteration, assign different movie parameters
-		switch(parameterCounter) {
+	// the customer, media and genre tokens of the borrow/return line, and the movie portion following them
+	string_view parameters[3];
+	string_view movieParameters;
+	size_t count = splitFields(borrowReturnCommand, ' ', parameters, 3, &movieParameters);
 
-			case 1:
-				break;
-			case 2:
-				stock = stoi(cleanedParameter);
-				break;
-			case 3:
-				director = cleanedParameter;
-				break;
-			case 4:
-				title = cleanedParameter;
-				break;
-			case 5:
-				{
-				stringstream actorAndDate(cleanedParameter);
-				string actorAndDateBuilder;
+	// holds the inputted data/parameters from borrow/return line
+	int custID = 0;
 
-				// parses through the major actor and release date tokens, they are deliminted via space characters
-				// and thus require their own loop
-				while(getline(actorAndDate, actorAndDateBuilder, ' ')) {
+	// holds the media type (one of the formats of the catalog configuration, DVD - D by default)
+	// and its format index
+	char videoCode = '\0';
+	int format = -1;
+	char genre = '\0';
 
-					if(parameterCounter == 5) {
+	// outcome and start time of the genre helper (timed only while statistics are enabled)
+	bool succeeded = false;
+	steady_clock::time_point genreStart;
 
-						majorActor = actorAndDateBuilder;
-					}
-					if(parameterCounter == 6) {
+	// parse through tokens of the borrow/return command and assign parameter variables of command to tokens
+	for(size_t counter = 0; counter < count; counter++) {
 
-						majorActor += (" " + actorAndDateBuilder);
-					}
-					if(parameterCounter == 7) {
+		string_view parameter = parameters[counter];
+		switch(counter) {
+
+			case 0:
+				if(!parseIntegerField(parameter, custID) || custID <= 0) {
+
+					statistics.malformedLines++;
+					commandResult.status = CommandStatus::MalformedCommand;
+					commandResult.argument = parameter;
+					return false;
+				}
+				commandResult.custID = custID;
+				if(!findCustomer(custID)) {
+
+					if(statistics.enabled) {
 
-						releaseMonth = stoi(actorAndDateBuilder);
+						statistics.unknownCustomer++;
 					}
-					if(parameterCounter == 8) {
+					commandResult.status = CommandStatus::UnknownCustomer;
+					commandResult.argument = parameter;
+					return false;
+				}
+				break;
+			case 1:
+
+				// an empty token (two spaces between fields) names no media code
+				if(parameter.empty()) {
+
+					statistics.malformedLines++;
+					commandResult.status = CommandStatus::MalformedCommand;
+					return false;
+				}
+				videoCode = parameter[0];
+				format = catalog.getFormatIndex(videoCode);
+				commandResult.mediaCode = videoCode;
+				commandResult.format = format;
+				if(format < 0) {
 
-						releaseYear = stoi(actorAndDateBuilder);
+					if(statistics.enabled) {
+
+						statistics.invalidMediaCode++;
 					}
-					parameterCounter++;
+					commandResult.status = CommandStatus::InvalidMediaCode;
+					return false;
 				}
 				break;
+			case 2:
+
+				// based on genre specified, call designated helper function for command processing
+				if(parameter.empty()) {
+
+					statistics.malformedLines++;
+					commandResult.status = CommandStatus::MalformedCommand;
+					return false;
+				}
+				genre = parameter[0];
+				commandResult.genre = genre;
+				if(statistics.enabled) {
+
+					genreStart = steady_clock::now();
 				}
+				if(!catalog.carriesGenre(genre) || !StoreGenres::visit(genre, [&](auto genreTag) {
+
+					typedef typename decltype(genreTag)::Movie MovieType;
+					succeeded = borrowReturnCommandHelper<MovieType>(movieParameters, custID, format, borrowOrReturn, waitIfOutOfStock);
+					if(statistics.enabled) {
+
+						(statistics.*GenreTraits<MovieType>::latency).record(duration_cast<nanoseconds>(steady_clock::now() - genreStart).count());
+					}
+				})) {
+
+					if(statistics.enabled) {
+
+						statistics.invalidGenreCode++;
+					}
+					commandResult.status = CommandStatus::InvalidGenreCode;
+					return false;
+				}
+				return succeeded;
 			default:
+				commandResult.status = CommandStatus::MalformedCommand;
+				return false;
+		}
+	}
+	commandResult.status = CommandStatus::MalformedCommand;
+	return false;
+}
+
+/**
+  * Prints the result of a borrow/return command as the store reports it: nothing for a borrow or
+  * return that succeeded (late fees and copies lent to waiting customers are printed as they
+  * happen), else why it failed, and the titles the command may have meant when its movie is not in
+  * inventory. The results of other commands print nothing (they printed their output).
+  *
+  * @param result - The result of the command
+  */
+void MovieRentalStore::printCommandResult(const CommandResult &result) {
+
+	const char *couldNotExecute = "Could not execute command. Inventory stock not changed successfully!";
+	switch(result.status) {
+
+		case CommandStatus::Waitlisted:
+			cout << "Borrow failed for movie with sorting criteria - " << result.argument << ": there is no stock for this movie at the moment." << endl;
+			cout << "Customer " << result.custID << " is waiting for " << result.mediaCode << " " << result.genre << " " << result.argument
+				<< " (position " << result.waitlistPosition << ")." << endl;
+			break;
+		case CommandStatus::UnknownCustomer:
+			cout << "Customer ID was invalid. No customer found with ID: " << result.argument << "." << endl;
+			break;
+		case CommandStatus::InvalidMediaCode:
+			cout << "Invalid video code provided. Do not recognize video code: " << result.mediaCode << endl;
+			break;
+		case CommandStatus::InvalidGenreCode:
+			cout << "The genre code was invalid. Do not recognize code: " << result.genre << "." << endl;
+			break;
+		case CommandStatus::MalformedCommand:
+			if(result.argument != "") {
+
+				cout << "Malformed number in " << (result.action == 'R' ? "return" : "borrow") << " command: " << result.argument << "." << endl;
 				break;
+			}
+			cout << "Undefined error occured processing " << (result.action == 'R' ? "return" : "borrow") << " command." << endl;
+			break;
+		case CommandStatus::MovieNotFound:
+			cout << "The movie with sorting criteria: " << result.argument << " was not found within the inventory." << endl;
+			cout << couldNotExecute << endl;
+			suggestTitles(result.genre, result.argument);
+			break;
+		case CommandStatus::OutOfStock:
+			cout << "Borrow failed for movie with sorting criteria - " << result.argument << ": there is no stock for this movie at the moment." << endl;
+			cout << couldNotExecute << endl;
+			break;
+		case CommandStatus::StockAtMaximum:
+			cout << "Return failed: stock for this movie is already at maximum." << endl;
+			cout << couldNotExecute << endl;
+			break;
+		case CommandStatus::BorrowLimitReached:
+			cout << "Customer with ID: " << result.custID << " has the max number of movies borrowed." << endl;
+			cout << "Borrow failed...backtracking..." << endl;
+			break;
+		case CommandStatus::NothingBorrowed:
+			cout << "Return failed...backtracking..." << endl;
+			break;
+		case CommandStatus::NotBorrowed:
+			cout << "Customer with ID: " << result.custID << " did not borrow this film (sorting criteria - " << result.argument << ")." << endl;
+			cout << "Return failed...backtracking..." << endl;
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+  * Scans the movie inventory file, holding the list of all movies. Add each valid movie (one of the 3 supported genres: Comedy, Drama, Classics)
+  * to the corresponding inventory. Lines holding a malformed number (stock, release year or month) are reported with their line
+  * number and skipped, and the number skipped is printed at the end of the file.
+  *
+  * @param movieFile - The directory of the movie inventory file
+  *
+  * @return Whether the file was successfully read
+  */
+bool MovieRentalStore::scanMovieFile(string movieFile) {
+
+	// reads the movie inventory file line by line
+	LineScanner readFile;
+
+	// holds a given line of the file
+	string_view line;
+
+	// if file has not successfully opened, terminate function, return false, and notify user
+	if(readFile.open(movieFile)) {
+
+		cout << "-----------------Movie file read successfully-----------------!" << endl << endl;
+	}
+	else {
+
+		cout << "Movie file failed to be read successfully!" << endl << endl;
+		return false;
+	}
+	char genre;
+
+	// the number of the line read, and the lines skipped as malformed before the file
+	long long lineNumber = 0;
+	long long malformedBefore = statistics.malformedLines;
+
+	// read each line of movie inventory file, construct movie object via designated helper functions, then add to inventory
+	while(readFile.next(line)) {
+
+		lineNumber++;
+		if(line == "") {
+
+			continue;
+		}
+
+		// gets the genre and creates the designated movie object
+		genre = line.at(0);
+		long long malformed = statistics.malformedLines;
+		if(!catalog.carriesGenre(genre) || !StoreGenres::visit(genre, [&](auto genreTag) {
+
+			MovieFactory<typename decltype(genreTag)::Movie>(line);
+			if(statistics.malformedLines > malformed) {
+
+				cout << "Line " << lineNumber << " of the movie file was skipped: " << line << endl;
+			}
+		})) {
+
+			cout << "Invalid genre code provided: No genre associated with code '" << genre << "'" << ". Movie was not added to inventory: " << line << endl;
 		}
-		parameterCounter++;
 	}
-	movieParameters.str("");
 
-	// construct classics movie object and add to corresponding inventory
-	Classics *classicsMovie = new Classics(releaseYear, releaseMonth, majorActor, director, title, stock);
-	if(classicsMovieInventory.Insert(*classicsMovie)) {
+	if(statistics.malformedLines > malformedBefore) {
 
-		delete(classicsMovie);
-		return true;
+		cout << "Skipped " << statistics.malformedLines - malformedBefore << " malformed lines of the movie file." << endl;
 	}
-	delete(classicsMovie);
-	return false;
+
+	// close file and return true indicating all present valid movie lines were read and added to inventory
+	readFile.close();
+	return true;
 }
 
 /**
-  * Constructs a classics movie object from a given line from the movie file, passed as a
-  * stringstream argument. The classics movie is constructed from its sorting criteria exclusively.
-  * The stock of the movie, if found, is decremented if a borrow command, or increments if a return command.
-  * The borrow list for the given customer is also modified accordingly.
-  * 
-  * @param movieParameters - The file line that holds the borrow or return command's information
-  * @param custID - The customer conducting a command
-  * @param borrowOrReturn - Whether the command being processed is a movie borrow or return
+  * Applies a movie delta file to the live store: titles are added, restocked and retired without
+  * reloading the catalog. Lines hold an action and a movie file line:
+  *   + <movie line>   adds the title
+  *   = <movie line>   restocks the title: its starting stock in every format becomes the line's stock
+  *                    and its current stock changes by the same amount
+  *   - <movie line>   retires the title (its stock field is ignored); refused while copies are borrowed
+  * A line holding only "COMMIT" ends a batch, as does the end of the file. Blank lines and lines
+  * starting with '#' are ignored. Each batch is applied atomically (see "applyMovieDeltaBatch"), and
+  * costs one search per line, plus the rebuild of the subtree below each title retired, however
+  * large the catalog is.
+  *
+  * @param deltaFile - The directory of the movie delta file
   *
-  * @return The success state of whether the classics movie specified in stringstream had it's stock changed appropriately and customer's borrow list was updated
+  * @return Whether the file was read (batches rejected are reported, and change nothing)
   */
-bool MovieRentalStore::borrowReturnCommandClassicsHelper(stringstream &movieParameters, int custID, bool borrowOrReturn) {
+bool MovieRentalStore::applyMovieDelta(string deltaFile) {
 
-	// loop counter
-	int counter = 0;
+	vector<string> lines;
+	if(!readMovieDelta(deltaFile, lines)) {
 
-	// holds a token for the movie portion of a given borrow/return line
-	string parameter;
+		return false;
+	}
+	applyMovieDeltaLines(lines);
+	return true;
+}
 
-	// holds the inputted movie data from borrow/return line
-	int month;
-	short int year;
-	string majorActorFirstName;
-	string majorActorLastName;
-	string majorActor;
+/**
+  * Reads the lines of a movie delta file that are applied: the delta lines and "COMMIT" lines, without
+  * blank lines, comments and line endings. A line holding a tab is refused, as a tab separates the
+  * lines of the movie delta command journaled for the file (see "executeCommand").
+  *
+  * @param deltaFile - The directory of the movie delta file
+  * @param lines - The lines read, appended to
+  *
+  * @return Whether the file was read
+  */
+bool MovieRentalStore::readMovieDelta(string deltaFile, vector<string> &lines) {
 
-	// assigns classics movie constructor parameters holders to space delimited tokens
-	// expected movie format: 3 1971 Katherine Hepburn (month, year, first name, last name)
-	while(getline(movieParameters, parameter, ' ')) {
+	ifstream readFile(deltaFile);
+	if(!readFile) {
 
-		switch(counter) {
+		cout << "Movie delta file could not be read: " << deltaFile << endl;
+		return false;
+	}
+	string line;
+	while(getline(readFile, line)) {
 
-			case 0:
-				month = stoi(parameter);
-				break;
-			case 1:
-				year = stoi(parameter);
-				break;
-			case 2:
-				majorActorFirstName = parameter;
-				break;
-			case 3:
-				majorActorLastName = parameter;
-				break;
-			default:
-				break;
+		if(line != "" && line.back() == '\r') {
+
+			line.pop_back();
+		}
+		if(line.find('\t') != string::npos) {
+
+			cout << "Movie delta line holds a tab: " << line << endl;
+			return false;
+		}
+		if(line != "" && line[0] != '#') {
+
+			lines.push_back(line);
+		}
+	}
+	return true;
+}
+
+/**
+  * Applies the lines of a movie delta, batch by batch: a "COMMIT" line, or the last line, ends a batch.
+  *
+  * @param lines - The delta lines and "COMMIT" lines (see "readMovieDelta")
+  */
+void MovieRentalStore::applyMovieDeltaLines(const vector<string> &lines) {
+
+	vector<string> batch;
+	int batchNumber = 0;
+	for(size_t i = 0; i <= lines.size(); i++) {
+
+		if(i < lines.size() && lines[i] != "COMMIT") {
+
+			batch.push_back(lines[i]);
+			continue;
+		}
+		if(!batch.empty()) {
+
+			applyMovieDeltaBatch(batch, ++batchNumber);
+			batch.clear();
 		}
-		counter++;
 	}
-	majorActor = majorActorFirstName + " " + majorActorLastName;
+}
 
-	// generate classics movie object
-	Classics *classicsMovie = new Classics(year, month, majorActor);
+/**
+  * Applies one batch of a movie delta file, atomically: every line is validated before any is
+  * applied, and a batch holding an invalid line, a title in the wrong state (added but present,
+  * restocked or retired but missing, retired with copies borrowed, restocked below its copies
+  * borrowed) or a title named twice changes nothing. Titles are added first; should the inventory refuse one (it is full), the titles added
+  * are removed again and the batch is rejected.
+  *
+  * @param batch - The delta lines of the batch
+  * @param batchNumber - The number of the batch in its file, for messages
+  *
+  * @return Whether the batch was applied
+  */
+bool MovieRentalStore::applyMovieDeltaBatch(const vector<string> &batch, int batchNumber) {
 
-	// generate Movie type pointer to new movie for the purpose of passing as argument to customer borrow function ("addToCustomersBorrowList")
-	Movie *classicsMoviePointer = classicsMovie;
+	// genre code and sorting criteria of every title the batch names
+	set<string> titles;
+	string title;
+	int counts[3] = {0, 0, 0};
+	const string actions = "+=-";
+	for(size_t i = 0; i < batch.size(); i++) {
 
-	// if borrow command and inventory successfully decremented, else if return command and
-	// inventory successfully incremented, else one of the inventory changes failed
-	if(borrowOrReturn && classicsMovieInventory.changeMediaStock(*classicsMovie, false)) {
+		if(!applyMovieDeltaLine(batch[i], false, title) || !titles.insert(title).second) {
 
-		// if failed to add to customer borrow list, then backtrack inventory change - increment stock
-		if(!addToCustomersBorrowList(classicsMoviePointer, custID)) {
+			if(title != "" && titles.count(title) > 0) {
 
-			cout << "Borrow failed...backtracking..." << endl;
-			classicsMovieInventory.changeMediaStock(*classicsMovie, true);
-			delete(classicsMoviePointer);
-			classicsMoviePointer = nullptr;
-			classicsMovie = nullptr;
+				cout << "Title named twice in movie delta batch: " << batch[i] << endl;
+			}
+			cout << "Movie delta batch " << batchNumber << " rejected. No change was made." << endl;
 			return false;
 		}
-		string transaction = "Borrowed classics DVD movie with sorting criteria: " + classicsMovie->getSortingCriteria();
-		addTransaction(transaction, custID);
-		return true;
+		counts[actions.find(batch[i][0])]++;
 	}
-	else if(!borrowOrReturn && classicsMovieInventory.changeMediaStock(*classicsMovie, true)) {
 
-		// if failed to remove from customer borrow list, then backtrack inventory change - decrement stock
-		if(!removeFromCustomerList(classicsMoviePointer, custID)) {
+	// additions first, undone if the inventory refuses one
+	for(size_t i = 0; i < batch.size(); i++) {
 
-			cout << "Return failed...backtracking..." << endl;
-			classicsMovieInventory.changeMediaStock(*classicsMovie, false);
-			delete(classicsMoviePointer);
-			classicsMoviePointer = nullptr;
-			classicsMovie = nullptr;
+		if(batch[i][0] == '+' && !applyMovieDeltaLine(batch[i], true, title)) {
+
+			for(size_t j = 0; j < i; j++) {
+
+				if(batch[j][0] == '+') {
+
+					applyMovieDeltaLine("-" + batch[j].substr(1), true, title);
+				}
+			}
+			cout << "Movie delta batch " << batchNumber << " rejected. No change was made." << endl;
 			return false;
 		}
-		string transaction = "Returned classics DVD movie with sorting criteria: " + classicsMovie->getSortingCriteria();
-		delete(classicsMoviePointer);
-		classicsMoviePointer = nullptr;
-		classicsMovie = nullptr;
-		addTransaction(transaction, custID);
-		return true;
+	}
+
+	// restocks and retirements were validated, and cannot fail
+	for(size_t i = 0; i < batch.size(); i++) {
+
+		if(batch[i][0] != '+') {
+
+			applyMovieDeltaLine(batch[i], true, title);
+		}
+	}
+	cout << "Movie delta batch " << batchNumber << " applied: " << counts[0] << " added, " << counts[1] << " restocked, "
+		<< counts[2] << " retired." << endl;
+	return true;
+}
+
+/**
+  * Validates or applies one line of a movie delta file.
+  *
+  * @param line - The delta line: an action ('+', '=' or '-'), a space and a movie file line
+  * @param apply - Whether the line is applied; otherwise it is only validated against the inventory
+  * @param title - The genre code and sorting criteria of the line's title, assigned (empty if the line is invalid)
+  *
+  * @return Whether the line is valid (when validating) or was applied
+  */
+bool MovieRentalStore::applyMovieDeltaLine(const string &line, bool apply, string &title) {
+
+	title = "";
+	if(line.size() < 3 || (line[0] != '+' && line[0] != '=' && line[0] != '-') || line[1] != ' ') {
+
+		cout << "Invalid movie delta line: " << line << endl;
+		return false;
+	}
+	char action = line[0];
+	string movieLine = line.substr(2);
+	char genre = movieLine[0];
+	bool succeeded = false;
+	if(!catalog.carriesGenre(genre) || !StoreGenres::visit(genre, [&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		InventoryTree<MovieType> &inventory = this->*GenreTraits<MovieType>::inventory;
+		MovieType movie;
+		int formatStock[CatalogConfig::maxFormats];
+		if(!GenreTraits<MovieType>::parseMovieLine(movieLine, catalog, movie, formatStock)) {
+
+			return;
+		}
+		title = string(1, genre) + movie.getSortingCriteria();
+		if(apply) {
+
+			succeeded = action == '+' ? inventory.Insert(movie, formatStock) :
+				action == '=' ? inventory.restock(movie, formatStock) : inventory.Remove(movie);
+			if(succeeded && action != '=') {
+
+				indexMovie(movie, action == '+');
+			}
+
+			// copies restocked go to the customers waiting for them first
+			for(int format = 0; succeeded && action == '=' && format < catalog.getFormatCount(); format++) {
+
+				serveWaitlist(movie, format);
+			}
+		}
+		else if(action == '+' && inventory.contains(movie)) {
+
+			cout << "Movie delta adds a movie already in the inventory: " << movieLine << endl;
+		}
+		else if(action != '+' && !inventory.contains(movie)) {
+
+			cout << "Movie delta names a movie not found within the inventory: " << movieLine << endl;
+		}
+		else if(action == '-' && inventory.hasBorrowedCopies(movie)) {
+
+			cout << "Movie delta retires a movie with copies borrowed: " << movieLine << endl;
+		}
+		else if(action == '=' && inventory.restocksBelowBorrowed(movie, formatStock)) {
+
+			cout << "Movie delta restocks a movie below its copies borrowed: " << movieLine << endl;
+		}
+		else {
+
+			succeeded = true;
+		}
+	})) {
+
+		cout << "Invalid genre code provided: No genre associated with code '" << genre << "'" << ". Movie delta line: " << line << endl;
+		return false;
+	}
+	return succeeded;
+}
+
+/**
+  * Enables secondary indexes, e.g. for a deployment whose clerks look titles up by director. Each
+  * index is built from the titles already in inventory, then kept up to date as titles are added and
+  * retired.
+  *
+  * @param attributes - The attributes indexed, comma separated: "director", "year", "actor" and/or "title"
+  *
+  * @return Whether every attribute listed is known
+  */
+bool MovieRentalStore::enableSecondaryIndexes(string attributes) {
+
+	stringstream attributeList(attributes);
+	string name;
+	bool known = true;
+	vector<int> added;
+	while(getline(attributeList, name, ',')) {
+
+		int attribute = SecondaryIndexes::parseAttribute(name);
+		if(attribute < 0) {
+
+			cout << "Unknown secondary index attribute: " << name << endl;
+			known = false;
+		}
+		else if(!secondaryIndexes.isEnabled(attribute)) {
+
+			secondaryIndexes.enable(attribute);
+			added.push_back(attribute);
+		}
+	}
+
+	// index the titles already carried under the attributes just enabled
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		(this->*GenreTraits<MovieType>::inventory).forEachMovie([&](const MovieType &movie) {
+
+			string command = getMovieCommand(movie);
+			for(int attribute : added) {
+
+				secondaryIndexes.add(attribute, movie, command, GenreTraits<MovieType>::getMajorActor(movie));
+			}
+		});
+	});
+	return known;
+}
+
+/**
+  * Finds the titles holding a value of an attribute: through the attribute's secondary index when
+  * enabled, else by scanning every inventory.
+  *
+  * @param attribute - The attribute
+  * @param value - The value, e.g. "Nora Ephron" or "1988"
+  *
+  * @return The movie portions of the titles' borrow commands (genre code first), sorted
+  */
+vector<string> MovieRentalStore::findMovies(int attribute, const string &value) {
+
+	if(secondaryIndexes.isEnabled(attribute)) {
+
+		return secondaryIndexes.find(attribute, value);
+	}
+	vector<string> commands;
+	string key = SecondaryIndexes::getKey(value);
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		(this->*GenreTraits<MovieType>::inventory).forEachMovie([&](const MovieType &movie) {
+
+			if(key != "" && SecondaryIndexes::getMovieKey(attribute, movie, GenreTraits<MovieType>::getMajorActor(movie)) == key) {
+
+				commands.push_back(getMovieCommand(movie));
+			}
+		});
+	});
+	sort(commands.begin(), commands.end());
+	return commands;
+}
+
+/**
+  * Prints the titles holding a value of an attribute, each with its stock as the inventory prints
+  * it, and whether they were found through a secondary index or by a scan.
+  *
+  * @param attributeName - "director", "year", "actor" or "title"
+  * @param value - The value, e.g. "Nora Ephron"
+  *
+  * @return Whether a title was found
+  */
+bool MovieRentalStore::lookupMovies(string attributeName, string value) {
+
+	int attribute = SecondaryIndexes::parseAttribute(attributeName);
+	if(attribute < 0) {
+
+		cout << "Unknown lookup attribute: " << attributeName << endl;
+		return false;
+	}
+	vector<string> commands = findMovies(attribute, value);
+	if(commands.empty()) {
+
+		cout << "No titles with " << attributeName << ": " << value << endl;
+		return false;
+	}
+	cout << "Titles with " << attributeName << ": " << value << (secondaryIndexes.isEnabled(attribute) ? " (indexed)" : " (scanned)") << endl;
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		StoreGenres::visit(commands[i][0], [&](auto genreTag) {
+
+			typedef typename decltype(genreTag)::Movie MovieType;
+			MovieType movie;
+			bool carried = false;
+			GenreTraits<MovieType>::parseCommand(string_view(commands[i]).substr(2), movie, carried);
+			cout << "  " << commands[i][0] << " " << (this->*GenreTraits<MovieType>::inventory).describe(movie) << endl;
+		});
+	}
+	return true;
+}
+
+/**
+  * Prints the titles of a genre with a copy in stock (in any format) in a range, in inventory order,
+  * each with its stock, and how many titles of the genre are in stock. The genre's availability
+  * index reads the titles in stock in the range alone.
+  *
+  * @param genre - The genre code
+  * @param query - The range: a title prefix (comedies), a director prefix (dramas) or a year or
+  * range of years (classics, e.g. "1940-1949"); empty for every title
+  *
+  * @return Whether the genre and query were valid
+  */
+bool MovieRentalStore::printAvailability(string genre, string query) {
+
+	bool valid = false;
+	if(genre.size() != 1 || !catalog.carriesGenre(genre[0]) || !StoreGenres::visit(genre[0], [&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		InventoryTree<MovieType> &inventory = this->*GenreTraits<MovieType>::inventory;
+		SortKeyRange range;
+		if(!GenreTraits<MovieType>::parseAvailabilityRange(query, range)) {
+
+			cout << "Invalid availability query for genre " << genre << ": " << query << endl;
+			return;
+		}
+		valid = true;
+		cout << "Titles in stock: " << genre << (query != "" ? " " + query : "") << endl;
+		int found = inventory.forEachInStock(range, [&](const MovieType &movie) {
+
+			MovieType title = movie;
+			cout << "  " << inventory.describe(title) << endl;
+		});
+		cout << found << " in range, " << inventory.countInStock() << " of " << inventory.getSize() << " " << GenreTraits<MovieType>::name
+			<< " titles in stock" << endl;
+	})) {
+
+		cout << "Unknown genre for availability: " << genre << endl;
+	}
+	return valid;
+}
+
+/**
+  * Prints the titles closest to a query (the title search index tolerates typos, case and
+  * punctuation), each with the movie portion of the borrow command naming it.
+  *
+  * @param query - The text searched, e.g. "youve got mial"
+  *
+  * @return Whether a title was found
+  */
+bool MovieRentalStore::searchTitles(string query) {
+
+	vector<TitleSearchIndex::Match> matches = titleIndex.search(query, titleSearchResults);
+	if(matches.empty()) {
+
+		cout << "No titles match: " << query << endl;
+		return false;
+	}
+	cout << "Titles matching: " << query << endl;
+	for(size_t i = 0; i < matches.size(); i++) {
+
+		cout << "  " << matches[i].command << " (" << matches[i].description << ") score " << fixed << setprecision(2)
+			<< matches[i].score << defaultfloat << endl;
+	}
+	return true;
+}
+
+/**
+  * Prints the titles a borrow/return command may have meant when the movie it names is not in
+  * inventory: the titles of the genre equal to it once case and punctuation are ignored, else the
+  * titles of the genre closest to it.
+  *
+  * @param genre - The genre code of the command
+  * @param sortingCriteria - The sorting criteria of the movie the command names
+  */
+void MovieRentalStore::suggestTitles(char genre, const string &sortingCriteria) {
+
+	// below this score a title shares too little with the command to be worth suggesting
+	const double minimumScore = 0.4;
+	vector<TitleSearchIndex::Match> matches = titleIndex.findNormalized(string(1, genre) + " " + sortingCriteria);
+	if(matches.empty()) {
+
+		matches = titleIndex.search(sortingCriteria, titleSuggestions, genre, minimumScore);
+	}
+	for(size_t i = 0; i < matches.size(); i++) {
+
+		cout << "Did you mean: " << matches[i].command << "?" << endl;
+	}
+}
+
+/**
+  * Scans the customer file, holding the list of all customers. Add each customer (with formatting: custID, last name, first name)
+  * to the customer hash table via helper function. Lines whose customer ID is not a positive number are reported with their line
+  * number and skipped, and the number skipped is printed at the end of the file.
+  *
+  * @param customerFile - The directory of the customer file
+  *
+  * @return Whether the file was successfully read
+  */
+bool MovieRentalStore::scanCustomerFile(string customerFile) {
+
+	// reads the customer list file line by line
+	LineScanner readFile;
+
+	// holds a given line holding customer information
+	string_view line;
+
+	// opens customer list file and line to cout printed for formatting purposes
+	bool opened = readFile.open(customerFile);
+	cout << endl;
+
+	// if file has not successfully opened, terminate function, return false, and notify user in console
+	if(opened) {
+
+		cout << "----------------Customer file read successfully!-----------------" << endl << endl;
 	}
 	else {
 
-		cout << "Could not execute command. Inventory stock not changed successfully!" << endl;
-		delete(classicsMoviePointer);
-		classicsMoviePointer = nullptr;
-		classicsMovie = nullptr;
+		cout << "Customer file failed to be read successfully!" << endl << endl;
 		return false;
 	}
+
+	// the number of the line read, and the lines skipped as malformed
+	long long lineNumber = 0;
+	long long malformedLines = 0;
+
+	// read each line of customer list file, construct customer object then invoke helper function to add to customer hash table
+	while(readFile.next(line)) {
+
+		lineNumber++;
+		if(line == "") {
+
+			continue;
+		}
+
+		// the space delimited parameter tokens of the customer line (any following the first name are ignored)
+		string_view customerParameters[3];
+		size_t count = splitFields(line, ' ', customerParameters, 3);
+
+		// holds the various customer parameters
+		int custID = 0;
+		string firstName;
+		string lastName;
+
+		// the customer ID is parsed without allocating or throwing; a line without a valid one is skipped
+		if(!parseIntegerField(customerParameters[0], custID) || custID <= 0) {
+
+			cout << "Line " << lineNumber << " of the customer file was skipped (malformed customer ID): " << line << endl;
+			malformedLines++;
+			continue;
+		}
+
+		// parse each parameter token of the customer line
+		for(size_t counter = 1; counter < count; counter++) {
+
+			if(counter == 1) {
+
+				lastName = customerParameters[counter];
+			}
+			else if(counter == 2) {
+
+				firstName = customerParameters[counter];
+			}
+		}
+		if(line != "") {
+
+			// generate customer object then add it to the customer hash table
+			Customer *customer = customerPool.create<Customer>(custID, firstName, lastName);
+			if(statistics.enabled) {
+
+				statistics.customerAllocations++;
+			}
+			addCustomer(customer);
+		}
+	}
+
+	// close file, report the lines skipped, print for aesthetic formatting purposes, then return true to indicate file read successfully
+	readFile.close();
+	if(malformedLines > 0) {
+
+		statistics.malformedLines += malformedLines;
+		cout << "Skipped " << malformedLines << " malformed lines of the customer file." << endl;
+	}
+	cout << endl;
+	return true;
 }
 
 /**
-  * Constructs a drama movie object from a given line from the movie file, passed as a
-  * stringstream argument. The drama movie is constructed from its sorting criteria exclusively.
-  * The stock of the movie, if found, is decremented if a borrow command, or increments if a return command.
-  * The borrow list for the given customer is also modified accordingly.
-  * 
-  * @param movieParameters - The file line that holds the borrow or return command's information
-  * @param custID - The customer conducting a command
-  * @param borrowOrReturn - Whether the command being processed is a movie borrow or return
+  * Scans the command file, holding the list of all commands executed on the store. 
+  *
+  * @param commandFile - The directory of the command file
   *
-  * @return The success state of whether the drama movie specified in stringstream had it's stock changed appropriately and customer's borrow list was updated
+  * @return Whether the file was successfully read
   */
-bool MovieRentalStore::borrowReturnCommandDramaHelper(stringstream &movieParameters, int custID, bool borrowOrReturn) {
+bool MovieRentalStore::scanCommandFile(string commandFile) {
 
-	// loop counter
-	int counter = 0;
+	// reads the command file line by line
+	LineScanner readFile;
 
-	// holds a token for the movie portion of a given borrow/return line
-	string parameter;
+	// holds an individual line read from the file
+	string_view line;
 
-	// holds the inputted movie data from borrow/return line
-	string director;
-	string title;
+	// verifies file opened successfully, if fails notify user and terminate function
+	if(readFile.open(commandFile)) {
 
-	// assigns drama movie constructor parameters holders to space delimited tokens
-	// expected movie format: Gore Verbinski, Pirate of the Caribbean, (director, title)
-	while(getline(movieParameters, parameter, ',')) {
+		cout << "Command file read successfully!" << endl << endl;
+	}
+	else {
 
-		switch(counter) {
+		cout << "Command file failed to be read successfully!" << endl << endl;
+		return false;
+	}
 
-			case 0:
-				director = parameter;
+	// processes each command line
+	while(readFile.next(line)) {
+
+		executeCommand(string(line));
+	}
+	// close opened file and return true, indicating file was succesfully read
+	readFile.close();
+	return true;
+}
+
+/**
+  * Re-executes the borrow and return commands recorded in a journal file, restoring the state the
+  * store had when the journal was last written. Output of the replayed commands is discarded.
+  *
+  * @param journalFile - The directory of the journal file
+  *
+  * @return Whether the journal file was read (a missing journal holds nothing to replay)
+  */
+bool MovieRentalStore::replayJournal(string journalFile) {
+
+	vector<string> records;
+	if(!DurableLog::readRecords(journalFile, records)) {
+
+		return false;
+	}
+	DurableLog *activeJournal = journal;
+	journal = nullptr;
+
+	// the journal's time records set a simulated clock, so commands are stamped as they were
+	StoreClock *activeClock = clock;
+	SimulatedClock replayClock(activeClock->isSimulated() ? activeClock->now() : 0);
+	clock = &replayClock;
+	ofstream discardedOutput;
+	streambuf *standardOutput = cout.rdbuf(discardedOutput.rdbuf());
+	for(size_t i = 0; i < records.size(); i++) {
+
+		executeCommand(records[i]);
+	}
+	cout.rdbuf(standardOutput);
+	cout.clear();
+	journal = activeJournal;
+	clock = activeClock;
+	clock->setTime(replayClock.now());
+	cout << "Replayed " << records.size() << " journal records from: " << journalFile << endl;
+	return true;
+}
+
+/**
+  * Executes a single command line (borrow, return, borrow or wait, history, inventory, statistics, movie delta (file or lines), title search, lookup or availability) on the store. Lines that
+  * are empty are ignored. Results and errors are printed to standard output.
+  *
+  * @param line - The command line to be executed
+  *
+  * @return Whether the command succeeded (false for an empty line)
+  */
+bool MovieRentalStore::executeCommand(string_view line) {
+
+	// splits the first token of the line (its action code) from the rest of the line, the command's parameters
+	string_view actionParameter;
+	string_view commandParameters;
+	int counter = splitFields(line, ' ', &actionParameter, 1, &commandParameters);
+
+	// holds tokens from a given line
+	string_view commandParameter;
+
+	// holds the customer ID and transaction count of a history command, and the count (all unless given)
+	string_view historyFields[2];
+	size_t historyCount = SIZE_MAX;
+
+	// holds the value looked up by a lookup or availability command
+	string_view lookupValue;
+
+	// holds the lines of a movie delta command
+	vector<string> deltaLines;
+
+	// cutomer id
+	int custID = 0;
+
+	// command type
+	char action = '\0';
+
+	// whether the command succeeded
+	bool succeeded = false;
+
+	// the result of the command, filled as it executes
+	commandResult = CommandResult();
+
+	// start time of the command (taken only while statistics are enabled)
+	steady_clock::time_point commandStart;
+	if(statistics.enabled) {
+
+		commandStart = steady_clock::now();
+	}
+
+	// read the first character indicating the command type, then execute command
+	if(counter > 0) {
+
+		// a line starting with a space holds an empty action code
+		if(actionParameter.empty()) {
+
+			statistics.malformedLines++;
+			commandResult.status = CommandStatus::MalformedCommand;
+			cout << "The action code was missing: the line starts with a space." << endl;
+			cout << "The following command failed: " << line << "."<< endl;
+			cout << endl;
+			return false;
+		}
+
+		// holds the char that represents the command indicated by the character read
+                                // from the first letter of command line
+		action = actionParameter[0];
+		commandResult.action = action;
+
+		// determine which command to execute based on value of variable "action"
+		succeeded = true;
+		switch(action) {
+
+			// movie borrow command selected
+			case 'B':
+				succeeded = handleBorrowReturnCommand(commandParameters, 1);
+				if(printingResults) {
+
+					printCommandResult(commandResult);
+				}
+				if(!succeeded) {
+
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+				}
+				else if(journal != nullptr && !journalCommand(line)) {
+
+					succeeded = false;
+				}
 				break;
-			case 1:
-				title = parameter.substr(1);
+
+			// movie return command selected
+			case 'R':
+				succeeded = handleBorrowReturnCommand(commandParameters, 0);
+				if(printingResults) {
+
+					printCommandResult(commandResult);
+				}
+				if(!succeeded) {
+
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+				}
+				else if(journal != nullptr && !journalCommand(line)) {
+
+					succeeded = false;
+				}
 				break;
-			default:
+
+			// movie borrow command selected, waiting for the movie if it is out of stock
+			case 'W':
+				succeeded = handleBorrowReturnCommand(commandParameters, 1, true);
+				if(printingResults) {
+
+					printCommandResult(commandResult);
+				}
+				if(!succeeded) {
+
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+				}
+				else if(journal != nullptr && !journalCommand(line)) {
+
+					succeeded = false;
+				}
+				break;
+
+			// customer transaction history command selected - gets transaction history for specific customer indicated,
+			// the newest transactions up to the count following the customer ID if one does
+			case 'H':
+				historyCount = SIZE_MAX;
+				if(splitFields(commandParameters, ' ', historyFields, 2) == 2 && (!parseIntegerField(historyFields[1], historyCount) || historyCount == 0)) {
+
+					succeeded = false;
+					statistics.malformedLines++;
+					commandResult.status = CommandStatus::MalformedCommand;
+					commandResult.argument = historyFields[1];
+					cout << "Malformed transaction count in history command: " << historyFields[1] << "." << endl;
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+					break;
+				}
+				commandParameter = historyFields[0];
+				if(!parseIntegerField(commandParameter, custID) || custID <= 0) {
+
+					succeeded = false;
+					statistics.malformedLines++;
+					commandResult.status = CommandStatus::MalformedCommand;
+					commandResult.argument = commandParameter;
+					cout << "Malformed customer ID in history command: " << commandParameter << "." << endl;
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+					break;
+				}
+				succeeded = printCustomerTransHistory(custID, historyCount);
+				cout << endl;
+				break;
+
+			// movie inventory print command selected
+			case 'I':
+				outputStoreInventory();
+				cout << endl;
 				break;
+
+			// movie delta command selected - applies the movie delta file named by the rest of the line. The
+			// journal records the lines read rather than the file, which may have changed by the time it is
+			// replayed: as a movie delta lines command
+			case 'U':
+				if(!readMovieDelta(string(commandParameters), deltaLines)) {
+
+					succeeded = false;
+					cout << "The following command failed: " << line << "."<< endl;
+				}
+				else {
+
+					applyMovieDeltaLines(deltaLines);
+					string deltaCommand = "V ";
+					for(size_t i = 0; i < deltaLines.size(); i++) {
+
+						deltaCommand += (i > 0 ? "\t" : "") + deltaLines[i];
+					}
+					if(journal != nullptr && !journalCommand(deltaCommand)) {
+
+						succeeded = false;
+					}
+				}
+				cout << endl;
+				break;
+
+			// movie delta lines command selected - applies the movie delta lines of the rest of the line, tab
+			// separated
+			case 'V':
+				{
+					stringstream deltaLineList{string(commandParameters)};
+					string deltaLine;
+					while(getline(deltaLineList, deltaLine, '\t')) {
+
+						// an empty piece is skipped, as a blank line of a delta file is
+						if(deltaLine != "") {
+
+							deltaLines.push_back(deltaLine);
+						}
+					}
+				}
+				applyMovieDeltaLines(deltaLines);
+				if(journal != nullptr && !journalCommand(line)) {
+
+					succeeded = false;
+				}
+				cout << endl;
+				break;
+
+			// title search command selected - prints the titles closest to the rest of the line
+			case 'Q':
+				succeeded = searchTitles(string(commandParameters));
+				cout << endl;
+				break;
+
+			// lookup command selected - prints the titles whose attribute (next word) holds the rest of the line
+			case 'L':
+				splitFields(commandParameters, ' ', &commandParameter, 1, &lookupValue);
+				succeeded = lookupMovies(string(commandParameter), string(lookupValue));
+				cout << endl;
+				break;
+
+			// availability command selected - prints the titles of a genre (next word) in stock, in the range named by the rest of the line
+			case 'A':
+				splitFields(commandParameters, ' ', &commandParameter, 1, &lookupValue);
+				succeeded = printAvailability(string(commandParameter), string(lookupValue));
+				cout << endl;
+				break;
+
+			// time command selected - sets the simulated store clock to the rest of the line
+			case 'T':
+				if(!setStoreTime(string(commandParameters))) {
+
+					succeeded = false;
+					cout << "The following command failed: " << line << "."<< endl;
+					cout << endl;
+				}
+				else if(journal != nullptr && !journalCommand(line)) {
+
+					succeeded = false;
+				}
+				break;
+
+			// overdue command selected - prints the rentals overdue now and their late fees
+			case 'O':
+				printOverdueRentals();
+				cout << endl;
+				break;
+
+			// statistics print command selected
+			case 'S':
+				printStatistics();
+				cout << endl;
+				break;
+
+			// action not recognized. error printing occurs to cout.
+			default:
+				succeeded = false;
+				commandResult.status = CommandStatus::InvalidAction;
+				if(statistics.enabled) {
+
+					statistics.invalidCommand++;
+				}
+				string actionString(1, action);
+				cout << "The action code provided was invalid. Do not recognize: " << actionString << ". Command terminated." << endl;
+				cout << "The following command failed: " << line << "."<< endl;
+				cout << endl;
 		}
-		counter++;
 	}
+	if(succeeded && commandResult.status == CommandStatus::Failed) {
 
-	// generate drama movie object
-	Drama *dramaMovie = new Drama(director, title);
-
-	// generate Movie type pointer to new movie for the purpose of passing as argument to customer borrow function ("addToCustomersBorrowList")
-	Movie *dramaMoviePointer = dramaMovie;
+		commandResult.status = CommandStatus::Ok;
+	}
 
-	// if borrow command and inventory successfully decremented, else if return command and
-	// inventory successfully incremented, else one of the inventory changes failed
-	if(borrowOrReturn && dramaMovieInventory.changeMediaStock(*dramaMovie, false)) {
+	// record the latency of the command by its type
+	if(statistics.enabled && counter > 0) {
 
-		// if failed to add to customer borrow list, then backtrack inventory change - increment stock
-		if(!addToCustomersBorrowList(dramaMoviePointer, custID)) {
+		long long elapsed = duration_cast<nanoseconds>(steady_clock::now() - commandStart).count();
+		switch(action) {
 
-			cout << "Borrow failed...backtracking..." << endl;
-			dramaMovieInventory.changeMediaStock(*dramaMovie, true);
-			delete(dramaMoviePointer);
-			dramaMoviePointer = nullptr;
-			dramaMovie = nullptr;
-			return false;
+			case 'B':
+				statistics.borrowLatency.record(elapsed);
+				break;
+			case 'R':
+				statistics.returnLatency.record(elapsed);
+				break;
+			case 'H':
+				statistics.historyLatency.record(elapsed);
+				break;
+			case 'I':
+				statistics.inventoryLatency.record(elapsed);
+				break;
+			default:
+				break;
 		}
-		string transaction = "Borrowed drama DVD movie with sorting criteria: " + dramaMovie->getSortingCriteria();
-		addTransaction(transaction, custID);
-		return true;
 	}
-	else if(!borrowOrReturn && dramaMovieInventory.changeMediaStock(*dramaMovie, true)) {
+	return succeeded;
+}
+
+/**
+  * Reads the movie file into inventory, without printing: the messages of the file scan (movies added
+  * and lines rejected) are discarded.
+  *
+  * @param movieFile - The directory of the movie file
+  *
+  * @return Whether the file was read
+  */
+bool MovieRentalStore::loadMovies(string movieFile) {
+
+	DiscardedOutput discardedOutput;
+	streambuf *standardOutput = cout.rdbuf(&discardedOutput);
+	bool loaded = scanMovieFile(movieFile);
+	cout.rdbuf(standardOutput);
+	return loaded;
+}
+
+/**
+  * Reads the customer file into the customer hash table, without printing: the messages of the file
+  * scan are discarded.
+  *
+  * @param customerFile - The directory of the customer file
+  *
+  * @return Whether the file was read
+  */
+bool MovieRentalStore::loadCustomers(string customerFile) {
+
+	DiscardedOutput discardedOutput;
+	streambuf *standardOutput = cout.rdbuf(&discardedOutput);
+	bool loaded = scanCustomerFile(customerFile);
+	cout.rdbuf(standardOutput);
+	return loaded;
+}
 
-		// if failed to remove from customer borrow list, then backtrack inventory change - decrement stock
-		if(!removeFromCustomerList(dramaMoviePointer, custID)) {
+/**
+  * Executes a single command line, as "executeCommand" does, and returns its result instead of
+  * writing to standard output. A borrow/return command's outcome is reported by the fields of the
+  * result (nothing is formatted, and the result allocates nothing unless the command fails); the text
+  * the other commands print is returned in the result's output.
+  *
+  * @param line - The command line to be executed
+  *
+  * @return The result of the command
+  */
+CommandResult MovieRentalStore::execute(string_view line) {
 
-			cout << "Return failed...backtracking..." << endl;
-			dramaMovieInventory.changeMediaStock(*dramaMovie, false);
-			delete(dramaMovie);
-			dramaMoviePointer = nullptr;
-			dramaMovie = nullptr;
-		}
-		string transaction = "Returned drama DVD movie with sorting criteria: " + dramaMovie->getSortingCriteria();
-		delete(dramaMoviePointer);
-		dramaMoviePointer = nullptr;
-		dramaMovie = nullptr;
-		addTransaction(transaction, custID);
-		return true;
+	printingResults = false;
+	if(!line.empty() && (line[0] == 'B' || line[0] == 'R' || line[0] == 'W')) {
+
+		// late fees and copies lent to waiting customers are printed as they happen: the result has them
+		DiscardedOutput discardedOutput;
+		streambuf *standardOutput = cout.rdbuf(&discardedOutput);
+		executeCommand(line);
+		cout.rdbuf(standardOutput);
 	}
 	else {
 
-		cout << "Could not execute command. Inventory stock not changed successfully!" << endl;
-		delete(dramaMoviePointer);
-		dramaMoviePointer = nullptr;
-		dramaMovie = nullptr;
-		return false;
+		stringstream commandOutput;
+		streambuf *standardOutput = cout.rdbuf(commandOutput.rdbuf());
+		executeCommand(line);
+		cout.rdbuf(standardOutput);
+		commandResult.output = commandOutput.str();
 	}
+	printingResults = true;
+	return commandResult;
 }
 
+// the fields of the records of the state files (see "exportState"), and their indexes
+static const vector<string> inventoryFields = {"genre", "media", "director", "title", "year", "month", "actor", "stock", "startingStock"};
+static const vector<string> customerFields = {"custID", "lastName", "firstName"};
+static const vector<string> rentalFields = {"custID", "media", "genre", "movie", "borrowTime", "dueTime"};
+static const vector<string> historyFields = {"custID", "transaction"};
+enum InventoryField {InventoryGenre, InventoryMedia, InventoryDirector, InventoryTitle, InventoryYear, InventoryMonth, InventoryActor,
+	InventoryStock, InventoryStartingStock};
+enum CustomerField {CustomerID, CustomerLastName, CustomerFirstName};
+enum RentalField {RentalCustomerID, RentalMedia, RentalGenre, RentalMovie, RentalBorrowTime, RentalDueTime};
+enum HistoryField {HistoryCustomerID, HistoryTransaction};
+
 /**
-  * Constructs a comedy movie object from a given line from the movie file, passed as a
-  * stringstream argument. The comedy movie is constructed from its sorting criteria exclusively.
-  * The stock of the movie, if found, is decremented if a borrow command, or increments if a return command.
-  * The borrow list for the given customer is also modified accordingly.
-  * 
-  * @param movieParameters - The file line that holds the borrow or return command's information
-  * @param custID - The customer conducting a command
-  * @param borrowOrReturn - Whether the command being processed is a movie borrow or return
+  * Writes the state of the store to a directory, one file per table, as JSON lines or CSV (see
+  * RecordFormat.h) - for analytics, or to be read back by "importState":
+  *   inventory   genre, media, director, title, year, month, actor, stock, startingStock
+  *               one record per title and media format, titles in order per genre (month and actor are
+  *               0 and empty for the genres without them)
+  *   customers   custID, lastName, firstName, in customer hash table order
+  *   rentals     custID, media, genre, movie, borrowTime, dueTime
+  *               the copies held by the borrow lists, by customer ID; movie is the sorting criteria a
+  *               borrow command names, times are seconds since the epoch
+  *   history     custID, transaction, every customer's transactions oldest first
+  * The files are written through a buffer, with no allocation per record but for customer names.
+  *
+  * @param directory - The directory written to (created if missing)
+  * @param format - The format of the files
   *
-  * @return The success state of whether the comedy movie specified in stringstream had it's stock changed appropriately and customer's borrow list was updated
+  * @return Whether every file was written
   */
-bool MovieRentalStore::borrowReturnCommandComedyHelper(stringstream &movieParameters, int custID, bool borrowOrReturn) {
-
-	// loop counter
-	int counter = 0;
+bool MovieRentalStore::exportState(string directory, RecordFormat format) {
 
-	// holds a token for the movie portion of a given borrow/return line
-	string parameter;
+	mkdir(directory.c_str(), 0755);
+	string extension = string(".") + getRecordExtension(format);
+	RecordWriter writer(format);
+	if(!writer.open(directory + "/inventory" + extension, inventoryFields)) {
 
-	// holds the inputted movie data from borrow/return line
-	string title;
-	short int releaseYear;
+		return false;
+	}
+	const string &formatCodes = catalog.getFormatCodes();
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		typedef GenreTraits<MovieType> Traits;
+		InventoryTree<MovieType> &inventory = this->*Traits::inventory;
+		const char genre = MovieType::code;
+		inventory.forEachSlotInOrder([&](int slot) {
+
+			const MovieType &movie = inventory.getMovieAt(slot);
+			for(int format = 0; format < catalog.getFormatCount(); format++) {
+
+				writer.writeText(string_view(&genre, 1));
+				writer.writeText(string_view(&formatCodes[format], 1));
+				writer.writeText(movie.getDirector());
+				writer.writeText(movie.getTitle());
+				writer.writeInteger(movie.getReleaseYear());
+				writer.writeInteger(Traits::getReleaseMonth(movie));
+				writer.writeText(Traits::getMajorActor(movie));
+				writer.writeInteger(inventory.getStockAt(slot, format));
+				writer.writeInteger(inventory.getStartingStockAt(slot, format));
+				writer.endRecord();
+			}
+		});
+	});
+	long long records = writer.getRecordCount();
+	if(!writer.close() || !writer.open(directory + "/customers" + extension, customerFields)) {
 
-	// assigns comedy movie constructor parameters holders to space delimited tokens
-	// expected movie format: Pirate of the Caribbean, 2003 (title, release year)
-	while(getline(movieParameters, parameter, ',')) {
+		return false;
+	}
+	for(int i = 0; i < maxNumberofCustomers; i++) {
 
-		switch(counter) {
+		for(Customer *customer = customers[i].isEmpty() ? nullptr : &customers[i]; customer != nullptr; customer = customer->getNextCustomer()) {
 
-			case 0:
-				title = parameter;
-				break;
-			case 1:
-				releaseYear = stoi(parameter.substr(1));
-				break;
-			default:
-				break;
+			writer.writeInteger(customer->getCustomerID());
+			writer.writeText(customer->getLastName());
+			writer.writeText(customer->getFirstName());
+			writer.endRecord();
 		}
-		counter++;
 	}
+	records += writer.getRecordCount();
+	if(!writer.close() || !writer.open(directory + "/rentals" + extension, rentalFields)) {
 
-	// generate comedy movie object
-	Comedy *comedyMovie = new Comedy(releaseYear, title);
-
-	// generate Movie type pointer to new movie for the purpose of passing as argument to customer borrow function ("addToCustomersBorrowList")
-	Movie *comedyMoviePointer = comedyMovie;
+		return false;
+	}
+	for(map<int, Movie**>::iterator it = moviesBorrowedByCustomers.begin(); it != moviesBorrowedByCustomers.end(); it++) {
 
-	// if borrow command and inventory successfully decremented, else if return command and
-	// inventory successfully incremented, else one of the inventory changes failed
-	if(borrowOrReturn && comedyMovieInventory.changeMediaStock(*comedyMovie, false)) {
+		for(int i = 0; i < defaultMaxCustMovieLimit; i++) {
 
-		// if failed to add to customer borrow list, then backtrack inventory change - increment stock
-		if(!addToCustomersBorrowList(comedyMoviePointer, custID)) {
+			const Movie *copy = it->second[i];
+			DueDates::Rental rental;
+			if(copy == nullptr || !dueDates.find(copy, rental)) {
 
-			cout << "Borrow failed...backtracking..." << endl;
-			comedyMovieInventory.changeMediaStock(*comedyMovie, true);
-			delete(comedyMovie);
-			comedyMoviePointer = nullptr;
-			comedyMovie = nullptr;
-			return false;
+				continue;
+			}
+			const char genre = copy->getGenreCode();
+			writer.writeInteger(it->first);
+			writer.writeText(string_view(&formatCodes[copy->getFormat()], 1));
+			writer.writeText(string_view(&genre, 1));
+			writer.writeText(copy->getSortingCriteria());
+			writer.writeInteger(rental.borrowTime);
+			writer.writeInteger(rental.dueTime);
+			writer.endRecord();
 		}
-		string transaction = "Borrowed comedy DVD movie with sorting criteria: " + comedyMovie->getSortingCriteria();
-		addTransaction(transaction, custID);
-		return true;
 	}
-	else if(!borrowOrReturn && comedyMovieInventory.changeMediaStock(*comedyMovie, true)) {
+	records += writer.getRecordCount();
+	if(!writer.close() || !writer.open(directory + "/history" + extension, historyFields)) {
 
-		// if failed to remove from customer borrow list, then backtrack inventory change - decrement stock
-		if(!removeFromCustomerList(comedyMoviePointer, custID)) {
+		return false;
+	}
+	for(int i = 0; i < maxNumberofCustomers; i++) {
 
-			cout << "Return failed...backtracking..." << endl;
-			comedyMovieInventory.changeMediaStock(*comedyMovie, false);
-			delete(comedyMovie);
-			comedyMoviePointer = nullptr;
-			comedyMovie = nullptr;
-			return false;
+		for(Customer *customer = customers[i].isEmpty() ? nullptr : &customers[i]; customer != nullptr; customer = customer->getNextCustomer()) {
+
+			customer->getTransactions().forEachOldestFirst([&](string_view transaction) {
+
+				writer.writeInteger(customer->getCustomerID());
+				writer.writeText(transaction);
+				writer.endRecord();
+			});
 		}
-		string transaction = "Returned comedy DVD movie with sorting criteria: " + comedyMovie->getSortingCriteria();
-		delete(comedyMoviePointer);
-		comedyMoviePointer = nullptr;
-		comedyMovie = nullptr;
-		addTransaction(transaction, custID);
-		return true;
 	}
-	else {
+	records += writer.getRecordCount();
+	if(!writer.close()) {
 
-		cout << "Could not execute command. Inventory stock not changed successfully!" << endl;
-		delete(comedyMoviePointer);
-		comedyMoviePointer = nullptr;
-		comedyMovie = nullptr;
 		return false;
 	}
+	cout << "State exported to " << directory << " (" << getRecordExtension(format) << "): " << records << " records." << endl;
+	return true;
 }
 
 /**
-  * Utilizes helper functions to process borrow and return commands. Borrow commands decrement a given movie's stock in
-  * inventory. Return commands increment a given movie's stock in inventory. Determine genre of film via stringstream
-  * and call appropriate helper function.
-  * 
-  * @param borrowReturnCommand - The borrow or return command line
-  * @param borrowOrReturn - Whether the stringstream command represents a borrow or return (1 - borrow, 0 - return)
+  * Finds the state file of a table in a directory: JSON lines if present, else CSV.
   *
-  * @return The success state of the execution of the stringstream command
+  * @param directory - The directory
+  * @param table - The name of the table, e.g. "inventory"
+  *
+  * @return The directory of the file, empty if neither exists
   */
-bool MovieRentalStore::handleBorrowReturnCommand(stringstream& borrowReturnCommand, bool borrowOrReturn) {
-
-	// holds a token for the movie portion of a given borrow/return line
-	string parameter;
-
-	// loop counter
-	int counter = 0;
-
-	// holds the inputted data/parameters from borrow/return line
-	int custID;
-
-	// holds the media type (DVD - D is the only type supported currently)
-	char videoCode;
-	char genre;
-
-	// parse through tokens of the borrow/return command and assign parameter variables of command to tokens
-	while(getline(borrowReturnCommand, parameter, ' ')) {
-
-		switch(counter) {
+static string findStateFile(const string &directory, const string &table) {
 
-			case 0:
-				custID = stoi(parameter);
-				if(!findCustomer(custID)) {
-
-					cout << "Customer ID was invalid. No customer found with ID: " << parameter << "." << endl;
-					return false;
-				}
-				break;
-			case 1:
-				videoCode = parameter.at(0);
-				if(videoCode != 'D') {
-
-					string videoCodeString(1, videoCode);
-					cout << "Invalid video code provided. Do not recognize video code: " << videoCodeString << endl;
-					return false;
-				}
-				break;
-			case 2:
+	for(RecordFormat format : {RecordFormat::JsonLines, RecordFormat::Csv}) {
 
-				// based on genre specified, call designated helper function for command processing
-				genre = parameter.at(0);
-				switch(genre) {
-
-					case 'F':
-						return borrowReturnCommandComedyHelper(borrowReturnCommand, custID, borrowOrReturn);
-					case 'D':
-						return borrowReturnCommandDramaHelper(borrowReturnCommand, custID, borrowOrReturn);
-					case 'C':
-						return borrowReturnCommandClassicsHelper(borrowReturnCommand, custID, borrowOrReturn);
-					default:
-						string genreString(1, genre);
-						cout << "The genre code was invalid. Do not recognize code: " << genreString << "." << endl;
-						return false;
-				}
-			default:
-				if(borrowOrReturn) {
+		string file = directory + "/" + table + "." + getRecordExtension(format);
+		if(access(file.c_str(), F_OK) == 0) {
 
-					cout << "Undefined error occured processing borrow command." << endl;
-					return false;
-				}
-				cout << "Undefined error occured processing return command." << endl;
-				return false;
+			return file;
 		}
-		counter++;
-	}
-	if(borrowOrReturn) {
-
-		cout << "Undefined error occured processing borrow command." << endl;
-		return false;
 	}
-	cout << "Undefined error occured processing return command." << endl;
-	return false;
+	return "";
 }
 
 /**
-  * Scans the movie inventory file, holding the list of all movies. Add each valid movie (one of the 3 supported genres: Comedy, Drama, Classics)
-  * to the corresponding inventory.
+  * Reads the state files of a directory, as "exportState" writes them (in either format, or written by
+  * another program), into an empty store. The inventory and customers files are required, the rentals
+  * and history files optional. Nothing is printed but why the import failed; a store whose import
+  * failed holds what was read before the failure, and is best discarded.
   *
-  * @param movieFile - The directory of the movie inventory file
+  * @param directory - The directory of the state files
   *
-  * @return Whether the file was successfully read
+  * @return Whether the state was imported
   */
-bool MovieRentalStore::scanMovieFile(string movieFile) {
+bool MovieRentalStore::importState(string directory) {
 
-	// ifstream reads the movie inventory file
-	ifstream readFile;
+	bool empty = comedyMovieInventory.getSize() == 0 && dramaMovieInventory.getSize() == 0 && classicsMovieInventory.getSize() == 0;
+	for(int i = 0; empty && i < maxNumberofCustomers; i++) {
 
-	// holds a given line parsed within ifstream
-	string line;
+		empty = customers[i].isEmpty();
+	}
+	string inventoryFile = findStateFile(directory, "inventory");
+	string customerFile = findStateFile(directory, "customers");
+	string rentalFile = findStateFile(directory, "rentals");
+	string historyFile = findStateFile(directory, "history");
+	string error = !empty ? "the store is not empty." : inventoryFile == "" ? "no inventory file (inventory.jsonl or inventory.csv) in " + directory
+		: customerFile == "" ? "no customers file (customers.jsonl or customers.csv) in " + directory : "";
+
+	// the messages of the movies and customers added are discarded
+	DiscardedOutput discardedOutput;
+	streambuf *standardOutput = cout.rdbuf(&discardedOutput);
+	bool imported = error == "" && importInventory(inventoryFile, error) && importCustomers(customerFile, error)
+		&& (rentalFile == "" || importRentals(rentalFile, error)) && (historyFile == "" || importHistories(historyFile, error));
+	cout.rdbuf(standardOutput);
+	if(!imported) {
+
+		cout << "State import failed: " << error << endl;
+	}
+	return imported;
+}
 
-	// ifstream opens movie inventory file
-	readFile.open(movieFile);
+// the titles of a genre read from an inventory state file, with the stock of every format of each
+template <typename MovieType>
+struct ImportedInventory {
 
-	// if file has not successfully opened, terminate function, return false, and notify user
-	if(readFile) {
+	vector<MovieType> movies;
+	vector<FormatStockTable::FormatStock> stock;
+};
 
-		cout << "-----------------Movie file read successfully-----------------!" << endl << endl;
-	}
-	else {
+/**
+  * Reads an inventory state file into the genre inventories (which must be empty). The records of a
+  * title (one per format) follow each other; the titles of each genre are placed in its inventory at
+  * once, balanced (see ArrayBasedBSTree::load), then indexed.
+  *
+  * @param file - The directory of the file
+  * @param error - Receives why the file was rejected
+  *
+  * @return Whether the file was read
+  */
+bool MovieRentalStore::importInventory(const string &file, string &error) {
 
-		cout << "Movie file failed to be read successfully!" << endl << endl;
+	RecordReader reader;
+	if(!reader.open(file, inventoryFields)) {
+
+		error = reader.getError();
 		return false;
 	}
-	char genre;
-
-	// read each line of movie inventory file, construct movie object via designated helper functions, then add to inventory
-	while(readFile) {
+	int formats = catalog.getFormatCount();
+	StoreGenres::Tuple<ImportedInventory> imported;
+	while(reader.next()) {
+
+		long long releaseYear;
+		long long releaseMonth;
+		long long stock;
+		long long startingStock;
+		if(!reader.getInteger(InventoryYear, releaseYear) || !reader.getInteger(InventoryMonth, releaseMonth) || !reader.getInteger(InventoryStock, stock)
+			|| !reader.getInteger(InventoryStartingStock, startingStock)) {
+
+			break;
+		}
+		string_view genre = reader.getText(InventoryGenre);
+		string_view media = reader.getText(InventoryMedia);
+		int format = media.size() == 1 ? catalog.getFormatIndex(media[0]) : -1;
+		string rejection = genre.size() != 1 || !catalog.carriesGenre(genre[0]) ? "genre not carried: \"" + string(genre) + "\""
+			: format < 0 ? "media format not carried: \"" + string(media) + "\""
+			: stock < 0 || stock > startingStock || startingStock > INT_MAX ? "invalid stock: " + to_string(stock) + " of " + to_string(startingStock) : "";
+		if(rejection == "" && !StoreGenres::visit(genre[0], [&](auto genreTag) {
+
+			typedef typename decltype(genreTag)::Movie MovieType;
+			ImportedInventory<MovieType> &inventory = get<ImportedInventory<MovieType>>(imported);
+			MovieType movie = GenreTraits<MovieType>::makeMovie(string(reader.getText(InventoryDirector)), string(reader.getText(InventoryTitle)),
+				releaseYear, releaseMonth, string(reader.getText(InventoryActor)), stock);
+			if(inventory.movies.empty() || !(inventory.movies.back().getSortKey() == movie.getSortKey())) {
+
+				inventory.movies.push_back(movie);
+				inventory.stock.resize(inventory.stock.size() + formats, {0, 0});
+			}
+			inventory.stock[(inventory.movies.size() - 1) * formats + format] = {(int) stock, (int) startingStock};
+		})) {
 
-		// reads and stores line in variable "line" then creates a stringstream out of it
-		getline(readFile, line);
-		if(line == "") {
+			rejection = "genre not supported: \"" + string(genre) + "\"";
+		}
+		if(rejection != "") {
 
-			continue;
+			error = file + " line " + to_string(reader.getLine()) + ": " + rejection;
+			return false;
 		}
-		stringstream movieParameters(line);
+	}
+	if(reader.getError() != "") {
 
-		// gets the genre and creates the designated movie object
-		genre = line.at(0);
-		if(genre != 'C' && genre != 'D' && genre != 'F') {
+		error = reader.getError();
+		return false;
+	}
+	StoreGenres::forEach([&](auto genreTag) {
 
-			cout << "Invalid genre code provided: No genre associated with code '" << genre << "'" << ". Movie was not added to inventory: " << line << endl;
-		}
-		else if(genre == 'D' || genre == 'F') {
+		typedef typename decltype(genreTag)::Movie MovieType;
+		ImportedInventory<MovieType> &inventory = get<ImportedInventory<MovieType>>(imported);
+		if(error != "") {
 
-			// constructs comedy and drama movies
-			DefaultMovieFactory(movieParameters, genre);
+			return;
 		}
-		else if(genre == 'C') {
+		if(!(this->*GenreTraits<MovieType>::inventory).load(inventory.movies, inventory.stock)) {
 
-			// constructs classics movies
-			ClassicMovieFactory(movieParameters);
+			error = file + ": the " + GenreTraits<MovieType>::name + " titles are listed twice, or are more than the inventory holds";
+			return;
 		}
-	}
+		for(size_t i = 0; i < inventory.movies.size(); i++) {
 
-	// close ifstream and return true indicating all present valid movie lines were read and added to inventory
-	readFile.close();
-	return true;
+			indexMovie(inventory.movies[i], true);
+		}
+	});
+	return error == "";
 }
 
 /**
-  * Scans the customer file, holding the list of all customers. Add each customer (with formatting: custID, last name, first name)
-  * to the customer hash table via helper function.
+  * Reads a customers state file into the customer hash table.
   *
-  * @param customerFile - The directory of the customer file
+  * @param file - The directory of the file
+  * @param error - Receives why the file was rejected
   *
-  * @return Whether the file was successfully read
+  * @return Whether the file was read
   */
-bool MovieRentalStore::scanCustomerFile(string customerFile) {
-
-	// ifstream reads the customer list file
-	ifstream readFile;
-
-	// holds a given line holding customer information parsed within ifstream
-	string line;
-
-	// ifstream opens customer list file and line to cout printed for formatting purposes
-	readFile.open(customerFile);
-	cout << endl;
-
-	// if file has not successfully opened, terminate function, return false, and notify user in console
-	if(readFile) {
+bool MovieRentalStore::importCustomers(const string &file, string &error) {
 
-		cout << "----------------Customer file read successfully!-----------------" << endl << endl;
-	}
-	else {
+	RecordReader reader;
+	if(!reader.open(file, customerFields)) {
 
-		cout << "Customer file failed to be read successfully!" << endl << endl;
+		error = reader.getError();
 		return false;
 	}
+	while(reader.next()) {
 
-	// read each line of customer list file, construct customer object then invoke helper function to add to customer hash table
-	while(readFile) {
+		long long custID;
+		if(!reader.getInteger(CustomerID, custID)) {
 
-		// reads and stores line in variable "line" then creates a stringstream out of it
-		getline(readFile, line);
-		if(line == "") {
+			break;
+		}
+		if(custID <= 0 || custID > INT_MAX || findCustomer(custID)) {
 
-			continue;
+			error = file + " line " + to_string(reader.getLine()) + ": " + (custID <= 0 || custID > INT_MAX ? "invalid" : "duplicate") + " customer ID " + to_string(custID);
+			return false;
 		}
-		stringstream customerParameters(line);
+		Customer *customer = customerPool.create<Customer>(custID, string(reader.getText(CustomerFirstName)), string(reader.getText(CustomerLastName)));
+		if(statistics.enabled) {
 
-		// holds a particular parameter for the customer in the loop parsing
-		string customerParameter;
+			statistics.customerAllocations++;
+		}
+		addCustomer(customer);
+	}
+	error = reader.getError();
+	return error == "";
+}
 
-		// holds the various customer parameters
-		int custID;
-		string firstName;
-		string lastName;
+/**
+  * Reads a rentals state file into the borrow lists and due dates. The movies rented must be in
+  * inventory; their stock is not changed (the inventory file holds the stock left).
+  *
+  * @param file - The directory of the file
+  * @param error - Receives why the file was rejected
+  *
+  * @return Whether the file was read
+  */
+bool MovieRentalStore::importRentals(const string &file, string &error) {
 
-		// loop counter
-		int counter = 0;
+	RecordReader reader;
+	if(!reader.open(file, rentalFields)) {
 
-		// parse each parameter token of the customer line
-		while(getline(customerParameters, customerParameter, ' ')) {
+		error = reader.getError();
+		return false;
+	}
+	while(reader.next()) {
 
-			if(counter == 0) {
+		long long custID;
+		long long borrowTime;
+		long long dueTime;
+		if(!reader.getInteger(RentalCustomerID, custID) || !reader.getInteger(RentalBorrowTime, borrowTime) || !reader.getInteger(RentalDueTime, dueTime)) {
 
-				custID = stoi(customerParameter);
+			break;
+		}
+		string_view genre = reader.getText(RentalGenre);
+		string_view media = reader.getText(RentalMedia);
+		int format = media.size() == 1 ? catalog.getFormatIndex(media[0]) : -1;
+		string rejection = custID <= 0 || custID > INT_MAX || !findCustomer(custID) ? "unknown customer " + to_string(custID)
+			: genre.size() != 1 || !catalog.carriesGenre(genre[0]) ? "genre not carried: \"" + string(genre) + "\""
+			: format < 0 ? "media format not carried: \"" + string(media) + "\"" : "";
+		if(rejection == "" && !StoreGenres::visit(genre[0], [&](auto genreTag) {
+
+			typedef typename decltype(genreTag)::Movie MovieType;
+			MovieType parsedMovie;
+			bool carried = false;
+			if(!GenreTraits<MovieType>::parseCommand(reader.getText(RentalMovie), parsedMovie, carried)) {
+
+				rejection = "malformed movie: \"" + string(reader.getText(RentalMovie)) + "\"";
+				return;
 			}
-			else if(counter == 1) {
+			if(!carried) {
 
-				lastName = customerParameter;
+				rejection = "movie not in inventory: \"" + string(reader.getText(RentalMovie)) + "\"";
+				return;
 			}
-			else if(counter == 2) {
+			MovieType *copy = movieRecordPool.create<MovieType>(move(parsedMovie));
+			copy->setFormat(format);
+			CommandStatus status = (this->*GenreTraits<MovieType>::inventory).contains(*copy) ? addToCustomersBorrowList(copy, custID) : CommandStatus::MovieNotFound;
+			if(status != CommandStatus::Ok) {
 
-				firstName = customerParameter;
+				movieRecordPool.destroy(copy);
+				rejection = string(status == CommandStatus::MovieNotFound ? "movie not in inventory: \"" : "borrow limit reached: \"") + string(reader.getText(RentalMovie)) + "\"";
+				return;
 			}
-			counter++;
+
+			// the rental opened as of now takes the times of the record
+			DueDates::Rental opened;
+			dueDates.remove(copy, opened);
+			dueDates.add(copy, custID, borrowTime, dueTime);
+		})) {
+
+			rejection = "genre not supported: \"" + string(genre) + "\"";
 		}
-		if(line != "") {
+		if(rejection != "") {
 
-			// generate customer object then add it to the customer hash table
-			Customer *customer = new Customer(custID, firstName, lastName);
-			addCustomer(customer);
+			error = file + " line " + to_string(reader.getLine()) + ": " + rejection;
+			return false;
 		}
 	}
-
-	// close ifstream, print for aesthetic formatting purposes, then return true to indicate file read successfully
-	readFile.close();
-	cout << endl;
-	return true;
+	error = reader.getError();
+	return error == "";
 }
 
 /**
-  * Scans the command file, holding the list of all commands executed on the store. 
+  * Reads a history state file into the customers' transaction histories, appended in the order of
+  * the file.
   *
-  * @param commandFile - The directory of the command file
+  * @param file - The directory of the file
+  * @param error - Receives why the file was rejected
   *
-  * @return Whether the file was successfully read
+  * @return Whether the file was read
   */
-bool MovieRentalStore::scanCommandFile(string commandFile) {
-
-	// the input file stream (reads a file)
-	ifstream readFile;
-
-	// holds an individual line read from the ifstream
-	string line;
-
-	// opens file
-	readFile.open(commandFile);
-
-	// verifies file opened successfully, if fails notify user and terminate function
-	if(readFile) {
+bool MovieRentalStore::importHistories(const string &file, string &error) {
 
-		cout << "Command file read successfully!" << endl << endl;
-	}
-	else {
+	RecordReader reader;
+	if(!reader.open(file, historyFields)) {
 
-		cout << "Command file failed to be read successfully!" << endl << endl;
+		error = reader.getError();
 		return false;
 	}
+	while(reader.next()) {
 
-	// processes each command line
-	while(readFile) {
-
-		// reads the current line of ifstream and stores it in string "line", increments cursor to next line
-		getline(readFile, line);
-
-		// generates a stringstream of the line to allow the parsing of tokens
-		stringstream commandParameters(line);
+		long long custID;
+		if(!reader.getInteger(HistoryCustomerID, custID)) {
 
-		// holds tokens from a given line
-		string commandParameter;
-
-		// cutomer id
-		int custID;
-
-		// command type
-		char action;
-
-		// loop counter
-		int counter = 0;
-
-		// iterates through a given command line
-		while(getline(commandParameters, commandParameter, ' ')) {
-
-			// read the first character indicating the command type, execute command, then exit loop
-			if(counter == 0) {
-
-				// holds the char that represents the command indicated by the character read
-                                // from the first letter of command line
-				action = commandParameter.at(0);
-
-				// determine which command to execute based on value of variable "action"
-				switch(action) {
-
-					// movie borrow command selected
-					case 'B':
-						if(!handleBorrowReturnCommand(commandParameters, 1)) {
-
-							cout << "The following command failed: " << line << "."<< endl;
-							cout << endl;
-						}
-						break;
-
-					// movie return command selected
-					case 'R':
-						if(!handleBorrowReturnCommand(commandParameters, 0)) {
-
-							cout << "The following command failed: " << line << "."<< endl;
-							cout << endl;
-						}
-						break;
-
-					// customer transaction history command selected - gets transaction history for specific customer indicated
-					case 'H':
-						getline(commandParameters, commandParameter, ' ');
-						custID = stoi(commandParameter);
-						printCustomerTransHistory(custID);
-						cout << endl;
-						break;
-
-					// movie inventory print command selected
-					case 'I':
-						outputStoreInventory();
-						cout << endl;
-						break;
-
-					// action not recognized. error printing occurs to cout.
-					default:
-						string actionString(1, action);
-						cout << "The action code provided was invalid. Do not recognize: " << actionString << ". Command terminated." << endl;
-						cout << "The following command failed: " << line << "."<< endl;
-						cout << endl;
-				}
-			}
-			else {
+			break;
+		}
+		if(custID <= 0 || custID > INT_MAX || !findCustomer(custID)) {
 
-				break;
-			}
-			counter++;
+			error = file + " line " + to_string(reader.getLine()) + ": unknown customer " + to_string(custID);
+			return false;
 		}
+		addTransaction(string(reader.getText(HistoryTransaction)), custID);
 	}
-	// close opened file and return true, indicating file was succesfully read
-	readFile.close();
-	return true;
+	error = reader.getError();
+	return error == "";
 }
 
 /**
@@ -1250,11 +2647,133 @@ bool MovieRentalStore::printCustomerBorrowList(int custID) {
 	return false;
 }
 
-int main() {
+/**
+  * Prints the rentals overdue now, earliest due first: the customer, the format code and movie
+  * returned, the due time, the days late and the late fee charged if returned now, then the late
+  * fees of every rental overdue. Rentals become overdue as their due time passes (only the rentals
+  * expiring since the last query are looked at), so the cost follows the rentals overdue rather
+  * than the rentals open.
+  */
+void MovieRentalStore::printOverdueRentals() {
+
+	long long now = getCurrentTime();
+	dueDates.advance(now);
+	vector<DueDates::Rental> overdue;
+	overdue.reserve(dueDates.getOverdueCount());
+	dueDates.forEachOverdue([&](const DueDates::Rental &rental) {
+
+		overdue.push_back(rental);
+	});
+	if(overdue.empty()) {
+
+		cout << "No rentals are overdue (" << dueDates.getOpenCount() << " open)." << endl;
+		return;
+	}
+	sort(overdue.begin(), overdue.end(), [](const DueDates::Rental &first, const DueDates::Rental &second) {
+
+		return first.dueTime != second.dueTime ? first.dueTime < second.dueTime : first.custID < second.custID;
+	});
+	long long totalFees = 0;
+	cout << "Overdue rentals (" << overdue.size() << " of " << dueDates.getOpenCount() << " open):" << endl;
+	for(const DueDates::Rental &rental : overdue) {
+
+		long long daysLate = DueDates::getDaysLate(rental, now);
+		totalFees += daysLate * lateFeeCentsPerDay;
+		cout << "  Customer " << rental.custID << " - " << catalog.getFormatCodes()[rental.copy->getFormat()] << " " << rental.copy->getGenreCode()
+			<< " " << rental.copy->getSortingCriteria() << ": due " << StoreClock::formatTime(rental.dueTime) << ", " << daysLate << " day(s) late, late fee "
+			<< formatCents(daysLate * lateFeeCentsPerDay) << endl;
+	}
+	cout << "Late fees due: " << formatCents(totalFees) << endl;
+}
+
+/**
+  * Starts collecting statistics: command latency histograms, inventory and customer table probe
+  * counters, allocation counts and failure reasons. Until called, collection costs a single branch
+  * per hook.
+  */
+void MovieRentalStore::enableStatistics() {
+
+	statistics.enabled = true;
+	comedyMovieInventory.setCounters(&statistics.comedyInventory);
+	dramaMovieInventory.setCounters(&statistics.dramaInventory);
+	classicsMovieInventory.setCounters(&statistics.classicsInventory);
+}
+
+/**
+  * Prints to standard output the collected statistics, followed by the occupancy and chain lengths
+  * of the customer hash table (computed when called) and, when memory accounting is enabled, the
+  * bytes held by every subsystem.
+  */
+void MovieRentalStore::printStatistics() {
+
+	if(!statistics.enabled) {
+
+		if(MemoryAccounting::isEnabled()) {
+
+			printMemoryUsage();
+			return;
+		}
+		cout << "Statistics are disabled." << endl;
+		return;
+	}
+	cout << "----------Statistics----------" << endl;
+	statistics.print(cout);
+
+	// walk the customer hash table to find the chain length of every occupied slot
+	int occupiedSlots = 0;
+	int customerCount = 0;
+	int longestChain = 0;
+	for(int i = 0; i < maxNumberofCustomers; i++) {
+
+		if(customers[i].isEmpty()) {
+
+			continue;
+		}
+		int chainLength = 0;
+		for(Customer *customer = &customers[i]; customer != nullptr; customer = customer->getNextCustomer()) {
+
+			chainLength++;
+		}
+		occupiedSlots++;
+		customerCount += chainLength;
+		longestChain = max(longestChain, chainLength);
+	}
+	cout << "----------Customer Table----------" << endl;
+	cout << "  customers=" << customerCount << " occupied slots=" << occupiedSlots << "/" << maxNumberofCustomers
+		<< " mean chain length=" << (occupiedSlots == 0 ? 0 : (double) customerCount / occupiedSlots)
+		<< " longest chain=" << longestChain << endl;
+	if(MemoryAccounting::isEnabled()) {
+
+		printMemoryUsage();
+	}
+}
 
-	cout << "-------------------------------Movie Rental Store-------------------------------" << endl << endl;
-	string movieFile = "data_files/data4movies.txt";
-	string customerFile = "data_files/data4customers2.txt";
-	string commandFile = "data_files/data4commands2.txt";
-	MovieRentalStore store(movieFile, customerFile, commandFile);
-}
\ No newline at end of file
+/**
+  * Prints to standard output the bytes held by every subsystem, by the string table the movie
+  * names are interned in, by the title search index, the availability indexes, the waitlists and every secondary index enabled.
+  */
+void MovieRentalStore::printMemoryUsage() {
+
+	MemoryAccounting::print(cout);
+	cout << "  Interned strings: count=" << StringTable::getCount() << " bytes=" << StringTable::getBytes() << endl;
+	cout << "  Title search index: titles=" << titleIndex.getSize() << " bytes=" << titleIndex.getBytes() << endl;
+	int titlesInStock = 0;
+	long long availabilityBytes = 0;
+	StoreGenres::forEach([&](auto genreTag) {
+
+		typedef typename decltype(genreTag)::Movie MovieType;
+		titlesInStock += (this->*GenreTraits<MovieType>::inventory).countInStock();
+		availabilityBytes += (this->*GenreTraits<MovieType>::inventory).getAvailabilityBytes();
+	});
+	cout << "  Availability index (in inventory): titles in stock=" << titlesInStock << " bytes=" << availabilityBytes << endl;
+	cout << "  Due dates: rentals=" << dueDates.getOpenCount() << " overdue=" << dueDates.getOverdueCount() << " bytes=" << dueDates.getBytes() << endl;
+	cout << "  Waitlists: titles=" << waitlists.getTitleCount() << " waiting=" << waitlists.getWaiterCount() << " bytes=" << waitlists.getBytes() << endl;
+	for(int attribute = 0; attribute < SecondaryIndexes::AttributeCount; attribute++) {
+
+		if(secondaryIndexes.isEnabled(attribute)) {
+
+			cout << "  Secondary index " << SecondaryIndexes::getAttributeName(attribute) << ": titles=" << secondaryIndexes.getEntryCount(attribute)
+				<< " bytes=" << secondaryIndexes.getBytes(attribute) << endl;
+		}
+	}
+}
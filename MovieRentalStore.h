@@ -1,9 +1,35 @@
+#ifndef MOVIERENTALSTORE_H
+#define MOVIERENTALSTORE_H
+
 #include "BSTArray.h"
 #include "Movie.h"
 #include "Customer.h"
+#include "DurableLog.h"
+#include "StoreStatistics.h"
+#include "SlabPool.h"
+#include "CatalogConfig.h"
+#include "TitleSearchIndex.h"
+#include "SecondaryIndexes.h"
+#include "Waitlists.h"
+#include "DueDates.h"
+#include "StoreClock.h"
+#include "CommandResult.h"
+#include "RecordFormat.h"
+#include "DelimiterScanner.h"
+#include <set>
 
 using namespace std;
 
+// storage layout of the genre inventories: whole movie objects, or hot/cold columns when built
+// with -DCOLUMN_INVENTORY (see InventoryStorage.h). both behave identically.
+#ifdef COLUMN_INVENTORY
+template <typename MovieType>
+using InventoryTree = ArrayBasedBSTree<MovieType, ColumnStorage<MovieType>>;
+#else
+template <typename MovieType>
+using InventoryTree = ArrayBasedBSTree<MovieType>;
+#endif
+
 // A movie rental store system
 class MovieRentalStore {
 
@@ -17,19 +43,78 @@ public:
 	const int maxNumberofCustomers = 5000;
 
 	// the customer hash table
-	Customer *customers = new Customer[maxNumberofCustomers];
+	Customer *customers = allocateCustomerTable(maxNumberofCustomers);
+
+	// block size of the movie record pool: the largest genre movie class
+	static constexpr size_t movieRecordSize = max({sizeof(Comedy), sizeof(Drama), sizeof(Classics)});
+
+	// slab pools holding the customers read from the customer file (chained customers stay in it) and
+	// the movie records of borrow/return commands (borrowed ones stay in it, held by the borrow lists)
+	SlabPool<Customer> customerPool;
+	SlabPool<Movie, movieRecordSize> movieRecordPool;
 
 	// the maximum number of borrowed movies allowed for a given customer at a given point of time
 	const int defaultMaxCustMovieLimit = 13;
 
+	// the days a borrowed movie may be kept, and the late fee (in cents) of every day started past them
+	const int loanPeriodDays = 3;
+	const int lateFeeCentsPerDay = 100;
+
+	// write-ahead log receiving every successful borrow/return command (optional, not owned)
+	DurableLog *journal = nullptr;
+
+	// sequence number of the last record appended to the journal
+	unsigned long long lastJournalSequence = 0;
+
+	// the time last recorded in the journal ahead of a command, -1 if none is (see "journalCommand")
+	long long lastJournalTime = -1;
+
+	// the clock borrows and due dates are stamped with: the system clock unless "setClock" installs
+	// another (not owned)
+	SystemClock systemClock;
+	StoreClock *clock = &systemClock;
+
+	// latency histograms and counters, collected only after "enableStatistics" is called
+	StoreStatistics statistics;
+
+	// the media formats and genres carried (DVDs of every genre unless a configuration is loaded)
+	CatalogConfig catalog;
+
 	// movie inventories for each of the genres supported/carried
-	ArrayBasedBSTree<Comedy> comedyMovieInventory;
-	ArrayBasedBSTree<Drama> dramaMovieInventory;
-	ArrayBasedBSTree<Classics> classicsMovieInventory;
+	InventoryTree<Comedy> comedyMovieInventory;
+	InventoryTree<Drama> dramaMovieInventory;
+	InventoryTree<Classics> classicsMovieInventory;
+
+	// approximate and case insensitive search over the titles of every inventory (kept up to date as
+	// titles are added and retired; borrow/return commands only consult it when their movie is not found)
+	TitleSearchIndex titleIndex;
+
+	// optional indexes of the titles by director, release year, major actor and title (enabled per
+	// deployment with "enableSecondaryIndexes"; lookups scan the inventories otherwise)
+	SecondaryIndexes secondaryIndexes;
+
+	// the customers waiting for titles out of stock ("W"/Wait command), handed copies as they are
+	// returned or restocked
+	Waitlists waitlists;
+
+	// the borrow and due times of the movies in the borrow lists, by due time, and the rentals overdue
+	DueDates dueDates;
+
+	// the result of the command being executed (see "execute"), filled by the command handlers; borrow
+	// and return commands print their result unless "execute" runs them
+	CommandResult commandResult;
+	bool printingResults = true;
+
+	// the number of titles printed by the "Q"/Query command, and suggested when a movie is not found
+	const int titleSearchResults = 5;
+	const int titleSuggestions = 3;
 
 	// generates a hash code (via digit folding) for a given customer ID passed as first argument
 	int getHashCode(int, int);
 
+	// allocates the customer hash table of the given size (attributed to the customer table by memory accounting)
+	static Customer *allocateCustomerTable(int);
+
 	// adds a customer to the customer hash table
 	void addCustomer(Customer *);
 
@@ -39,21 +124,49 @@ public:
 	// adds a customer transaction to their customer transaction history
 	bool addTransaction(string, int);
 
-	// prints all transactions a given customer (via their ID) has executed
-	bool printCustomerTransHistory(int);
+	// prints the transactions a given customer (via their ID) has executed, newest first, up to the
+	// count argument (all unless given)
+	bool printCustomerTransHistory(int, size_t = SIZE_MAX);
 
 	// initialize a customer's (via their ID) borrow list. generates an entry in the map for the
 	// customer and allocates movie pointer array of size "defaultMaxCustMovieLimit"
 	bool initializeCustomerBorrowList(int);
 
-	// add to customer's (via their ID) borrow list in the event they execute a borrow command
-	bool addToCustomersBorrowList(Movie *, int);
+	// add to customer's (via their ID) borrow list in the event they execute a borrow command; gets the
+	// outcome (Ok, UnknownCustomer or BorrowLimitReached)
+	template <typename MovieType>
+	CommandStatus addToCustomersBorrowList(MovieType *, int);
 
 	// evaluates whether a given customer's (via their ID) borrow list is empty
 	bool customerBorrowListEmpty(int);
 
-	// remove from customer's (via their ID) borrow list in the event they execute a return command
-	bool removeFromCustomerList(Movie *, int);
+	// remove from customer's (via their ID) borrow list in the event they execute a return command; gets
+	// the outcome (Ok, NothingBorrowed or NotBorrowed)
+	template <typename MovieType>
+	CommandStatus removeFromCustomerList(MovieType *, int);
+
+	// gets the current time of the store (from its clock), in seconds since the epoch
+	long long getCurrentTime();
+
+	// installs the clock argument (not owned) as the store's clock
+	void setClock(StoreClock *);
+
+	// sets the time of a simulated store clock to the argument (a time, or "+" and seconds to move it
+	// by) - executed when "T"/Time command is executed
+	bool setStoreTime(string);
+
+	// appends a command line to the journal; unless the clock is simulated, preceded by a "T"/Time
+	// command holding the current time when it changed, so a replay stamps the command as it was;
+	// false (the command reported not durable) once the journal has failed
+	bool journalCommand(string_view);
+
+	// opens the rental of a movie record (first argument) added to a customer's (via their ID) borrow
+	// list: its borrow time is now and its due time "loanPeriodDays" later
+	void openRental(const Movie *, int);
+
+	// closes the rental of a movie record (first argument) removed from a customer's (via their ID)
+	// borrow list, charging a late fee if it is returned past its due time
+	void closeRental(const Movie *, int);
 
 	// clear customer's (via their ID) borrow list
 	void clearCustMovieBorrowData();
@@ -61,11 +174,53 @@ public:
 	// prints to cout each genre's movie inventory - executed when "I"/Inventory command is executed
 	void outputStoreInventory();
 
-	// constructs a movie of Comedy and Drama type from stringstream parameters
-	bool DefaultMovieFactory(stringstream&, char);
+	// constructs a movie of the genre from a movie file line and adds it to the genre's inventory
+	template <typename MovieType>
+	bool MovieFactory(string_view);
+
+	// applies a movie delta file (argument is its directory): titles added, restocked and retired,
+	// atomically per batch - executed when "U"/Update command is executed
+	bool applyMovieDelta(string);
 
-	// constructs a movie of Classics type from stringstream parameters
-	bool ClassicMovieFactory(stringstream&);
+	// reads the delta lines and "COMMIT" lines of a movie delta file (first argument) into a list
+	bool readMovieDelta(string, vector<string> &);
+
+	// applies movie delta lines, batch by batch
+	void applyMovieDeltaLines(const vector<string> &);
+
+	// validates, then applies, one batch of movie delta lines (second argument is the batch's number)
+	bool applyMovieDeltaBatch(const vector<string> &, int);
+
+	// validates (second argument false) or applies one movie delta line; the third argument receives the
+	// genre code and sorting criteria of its title
+	bool applyMovieDeltaLine(const string &, bool, string &);
+
+	// adds a movie of the genre to (second argument true) or removes it from the title search index and secondary indexes
+	template <typename MovieType>
+	void indexMovie(const MovieType &, bool);
+
+	// enables the secondary indexes of the attributes listed in the argument (comma separated, e.g.
+	// "director,year"), built from the titles already in inventory
+	bool enableSecondaryIndexes(string);
+
+	// gets the commands (genre code and sorting criteria) of the titles whose attribute (first argument)
+	// holds the value argument, sorted - from the attribute's secondary index if enabled, else by a scan
+	vector<string> findMovies(int, const string &);
+
+	// prints the titles whose attribute (first argument, its name) holds the value argument - executed
+	// when "L"/Lookup command is executed
+	bool lookupMovies(string, string);
+
+	// prints the titles of a genre (first argument, its code) with a copy in stock in the range the
+	// query argument names, and their count - executed when "A"/Availability command is executed
+	bool printAvailability(string, string);
+
+	// prints the titles closest to the query argument - executed when "Q"/Query command is executed
+	bool searchTitles(string);
+
+	// prints the titles a borrow/return command of the genre code (first argument) may have meant,
+	// when the movie it names (second argument, its sorting criteria) is not in inventory
+	void suggestTitles(char, const string &);
 
 	// fills the customer hash table with all existing customers as listed from customer text file.
 	// argument is directory to customer text file.
@@ -79,27 +234,111 @@ public:
 	// argument is directory to command text file.
 	bool scanCommandFile(string);
 
-	// helper function for borrow/return commands - initiates modification of inventory/borrow list (specifically for Classics movies)
-	bool borrowReturnCommandClassicsHelper(stringstream &, int, bool);
+	// read a state file (first argument is its directory) of the inventory, the customers, the open
+	// rentals or the transaction histories into the store (see "importState"); the second argument
+	// receives why the file was rejected
+	bool importInventory(const string &, string &);
+	bool importCustomers(const string &, string &);
+	bool importRentals(const string &, string &);
+	bool importHistories(const string &, string &);
+
+	// reads the catalog configuration file (argument is its directory) - the media formats and genres
+	// carried. must be called before any movie is added to inventory.
+	bool loadCatalogConfig(string);
+
+	// reads the movie and customer files, then executes the command file (arguments are their directories)
+	bool processFiles(string, string, string);
+
+	// executes a single command line (B, R, W, H, I, S, U, Q, L, A, O or T) on database (MovieRentalStore data);
+	// gets whether it succeeded
+	bool executeCommand(string_view);
+
+	// re-executes, without output, the borrow/return commands recorded in a journal file, on a
+	// simulated clock set by the journal's "T"/Time records. argument is directory to journal file.
+	bool replayJournal(string);
+
+	// helper function for borrow/return commands - initiates modification of inventory/borrow list
+	// (instantiated per genre from its traits, see GenreTraits.h); a borrow whose last argument is
+	// true joins the title's waitlist when it is out of stock
+	template <typename MovieType>
+	bool borrowReturnCommandHelper(string_view, int, int, bool, bool = false);
+
+	// executes borrow/return command when invoked by command handling function (first argument: the
+	// command line following the action code; last argument: a borrow waits for a title out of stock);
+	// its outcome is reported in "commandResult"
+	bool handleBorrowReturnCommand(string_view, bool, bool = false);
+
+	// prints the result of a borrow/return command (why it failed, or the waitlist it joined)
+	void printCommandResult(const CommandResult &);
+
+	// gets the name of the waitlist of a movie (first argument) in a format (second argument, its index)
+	template <typename MovieType>
+	string getWaitlistTitle(const MovieType &, int);
+
+	// builds the transaction of a movie (second argument) borrowed, returned or waitlisted (first
+	// argument, e.g. "Borrowed") in a format (third argument, its index), ended by a note (fourth)
+	template <typename MovieType>
+	string makeTransaction(const char *, const MovieType &, int, const char * = "");
+
+	// lends the copies in stock of a movie (first argument) in a format (second argument, its index)
+	// to the customers waiting for it, first come first served; gets the number of copies lent, the
+	// ID of the last customer lent one into the third argument if given
+	template <typename MovieType>
+	int serveWaitlist(MovieType &, int, int * = nullptr);
+
+	// prints all movies borrowed by a given customer (via their ID)
+	bool printCustomerBorrowList(int);
 
-	// helper function for borrow/return commands - initiates modification of inventory/borrow list (specifically for Drama movies)
-	bool borrowReturnCommandDramaHelper(stringstream &, int, bool);
+	// prints the rentals overdue now, their days late and late fees - executed when "O"/Overdue
+	// command is executed
+	void printOverdueRentals();
 
-	// helper function for borrow/return commands - initiates modification of inventory/borrow list (specifically for Comedy movies)
-	bool borrowReturnCommandComedyHelper(stringstream &, int, bool);
+	// starts collecting latency histograms and counters
+	void enableStatistics();
 
-	// executes borrow/return command when invoked by command handling function
-	bool handleBorrowReturnCommand(stringstream&, bool);
+	// prints the collected statistics and the chain lengths of the customer hash table - executed
+	// when "S"/Statistics command is executed
+	void printStatistics();
 
-	// prints all movies borrowed by a given customer (via their ID)
-	bool printCustomerBorrowList(int);
+	// prints the bytes held by every subsystem and the string table (memory accounting must be enabled)
+	void printMemoryUsage();
 
 public:
 
+	// MovieRentalStore default constructor - builds an empty store
+	MovieRentalStore();
+
 	// MovieRentalStore constructor - calls the three file processing functions to set up database
 	// and execute commands on said database
 	MovieRentalStore(string, string, string);
 
+	// MovieRentalStore constructor - calls the movie and customer file processing functions to set up
+	// database. commands are executed afterwards via "executeCommand" (used by server mode)
+	MovieRentalStore(string, string);
+
 	// MovieRentalStore destructor - deletes customer hash table and borrow lists within map if present
 	~MovieRentalStore();
-};
\ No newline at end of file
+
+	// the API of a store embedded in another program (linked from libmoviestore.a): an empty store is
+	// constructed, its movies and customers loaded, then commands executed one at a time
+
+	// reads the movie file (argument is its directory) into inventory, without printing
+	bool loadMovies(string);
+
+	// reads the customer file (argument is its directory) into the customer hash table, without printing
+	bool loadCustomers(string);
+
+	// executes a single command line; gets its result: the outcome of a borrow/return command, the
+	// text printed by the others (nothing is written to cout; see CommandResult.h for the formatters)
+	CommandResult execute(string_view);
+
+	// writes the state of the store (inventory, customers, open rentals and transaction histories) to a
+	// directory (first argument, created if missing) as JSON lines or CSV files, one per table
+	bool exportState(string, RecordFormat);
+
+	// reads the state files of a directory (argument), as "exportState" writes them in either format,
+	// into an empty store, without printing but for errors
+	bool importState(string);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "MovieRentalStore.h"
+#include "StoreServer.h"
+#include "CommandStream.h"
+
+#include <unistd.h>
+
+/**
+  * Runs the store in server or streaming mode: loads the movie and customer files, replays and opens
+  * the journal if one is given, then answers commands sent by clients until interrupted, or executes
+  * the commands read from standard input (or a descriptor) until its end.
+  *
+  * @param argc - The number of arguments (statistics, memory, configuration and index options removed)
+  * @param argv - The arguments: mode, socket path, port or descriptor (none for "--stream"), then
+  * data files and "--wal <journal file>"
+  * @param movieFile - The movie file loaded when none is given in the arguments
+  * @param customerFile - The customer file loaded when none is given in the arguments
+  * @param collectStatistics - Whether statistics are collected and printed at exit
+  * @param configFile - The catalog configuration file, empty for the default catalog
+  * @param indexAttributes - The attributes secondary indexes are enabled for (comma separated), empty for none
+  * @param clock - The store clock, nullptr for the system clock
+  * @param resultFormat - The format results are written in by streaming mode
+  * @param importDirectory - The directory of a state read instead of the movie and customer files, empty for none
+  *
+  * @return The exit status of the program (failing if the port is not one of 1-65535, the descriptor is negative or the state could not be imported)
+  */
+int runServer(int argc, char *argv[], string movieFile, string customerFile, bool collectStatistics, string configFile, string indexAttributes,
+	StoreClock *clock, CommandStream::ResultFormat resultFormat, string importDirectory) {
+
+	string journalFile;
+	vector<string> dataFiles;
+	bool streaming = string(argv[1]) == "--stream" || string(argv[1]) == "--stream-fd";
+	for(int i = string(argv[1]) == "--stream" ? 2 : 3; i < argc; i++) {
+
+		if(string(argv[i]) == "--wal" && i + 1 < argc) {
+
+			journalFile = argv[++i];
+		}
+		else {
+
+			dataFiles.push_back(argv[i]);
+		}
+	}
+	// the port and descriptor are parsed without throwing: a malformed or out of range one is reported with the usage
+	int port = 0;
+	if(string(argv[1]) == "--serve-tcp" && (!parseIntegerField(string_view(argv[2]), port) || port < 1 || port > 65535)) {
+
+		cout << "Usage: " << argv[0] << " --serve-tcp <port 1-65535> [Movie File] [Customer File] [--wal <journal file>]" << endl;
+		return 1;
+	}
+	int inputDescriptor = STDIN_FILENO;
+	if(string(argv[1]) == "--stream-fd" && (!parseIntegerField(string_view(argv[2]), inputDescriptor) || inputDescriptor < 0)) {
+
+		cout << "Usage: " << argv[0] << " --stream-fd <descriptor> [Movie File] [Customer File] [--wal <journal file>]" << endl;
+		return 1;
+	}
+	if(dataFiles.size() >= 2) {
+
+		movieFile = dataFiles[0];
+		customerFile = dataFiles[1];
+	}
+	// the results written as JSON lines or binary frames are all standard output holds: the messages of
+	// the files loaded go to standard error
+	streambuf *standardOutput = cout.rdbuf();
+	if(streaming && resultFormat != CommandStream::ResultFormat::Text) {
+
+		cout.rdbuf(cerr.rdbuf());
+	}
+	MovieRentalStore store;
+	if(collectStatistics) {
+
+		store.enableStatistics();
+	}
+	if(clock != nullptr) {
+
+		store.setClock(clock);
+	}
+	if(configFile != "" && !store.loadCatalogConfig(configFile)) {
+
+		return 1;
+	}
+	if(indexAttributes != "" && !store.enableSecondaryIndexes(indexAttributes)) {
+
+		return 1;
+	}
+	if(importDirectory != "") {
+
+		if(!store.importState(importDirectory)) {
+
+			return 1;
+		}
+	}
+	else if(store.scanMovieFile(movieFile)) {
+
+		store.scanCustomerFile(customerFile);
+	}
+	DurableLog journal;
+	if(journalFile != "") {
+
+		store.replayJournal(journalFile);
+		if(!journal.open(journalFile)) {
+
+			return 1;
+		}
+		store.journal = &journal;
+	}
+	cout.rdbuf(standardOutput);
+	if(streaming) {
+
+		CommandStream stream(store, resultFormat);
+		if(!stream.run(inputDescriptor, STDOUT_FILENO)) {
+
+			return 1;
+		}
+	}
+	else {
+
+		StoreServer server(store);
+		bool listening;
+		if(string(argv[1]) == "--serve") {
+
+			listening = server.listenUnixSocket(argv[2]);
+		}
+		else {
+
+			listening = server.listenLoopbackPort(port);
+		}
+		if(!listening || !server.run()) {
+
+			return 1;
+		}
+	}
+	if(collectStatistics || MemoryAccounting::isEnabled()) {
+
+		store.printStatistics();
+	}
+	return 0;
+}
+
+/**
+  * Runs the store. Without arguments the default data files are loaded and the command file executed;
+  * "[Movie File] [Customer File] [Command File]" (any leading part of them) replaces the defaults.
+  * Server mode ("--serve <socket path>" or "--serve-tcp <port>") loads the movie and customer files,
+  * optionally given after the mode arguments, and then answers commands sent by clients until
+  * interrupted. Streaming mode ("--stream", or "--stream-fd <descriptor>"), also optionally followed by
+  * the movie and customer files, executes the commands read from standard input (or the descriptor)
+  * as they arrive, until its end, so the store can run in a pipeline (see CommandStream.h);
+  * "--format jsonl" or "--format binary" writes the result of every command as a JSON line or a binary
+  * frame instead of its text (see CommandResult.h).
+  * "--wal <journal file>" makes every borrow/return durable in the journal before it is
+  * answered; the journal is replayed at startup. "--stats" collects latency histograms and counters
+  * (also printed by the "S" command) and prints them when the store exits. "--memory" attributes the
+  * bytes allocated by the store to its subsystems, prints them along with the statistics and reports
+  * any subsystem still holding memory once the store is destroyed. "--config <file>" reads the catalog
+  * configuration: the media formats stock is kept for and the genres carried (see CatalogConfig.h).
+  * "--index <attributes>" enables secondary indexes for "L"/Lookup commands, e.g. "director,year"
+  * (attributes not indexed are looked up by scanning the inventories). "--clock <clock>" selects the
+  * clock borrows and due dates are stamped with: "system" (the default), "monotonic", or "simulated"
+  * or "simulated:<start time>", set by the "T"/Time commands of the command file (see StoreClock.h).
+  * "--export <directory>" (JSON lines) or "--export-csv <directory>" writes the state of the store once
+  * the command file is executed: inventory, customers, open rentals and transaction histories; "--import
+  * <directory>" reads such a state instead of the movie and customer files, the only file then given
+  * being the command file (see MovieRentalStore::exportState), in server and streaming modes as well;
+  * a state that cannot be imported fails the run.
+  */
+int main(int argc, char *argv[]) {
+
+	string movieFile = "data_files/data4movies.txt";
+	string customerFile = "data_files/data4customers2.txt";
+	string commandFile = "data_files/data4commands2.txt";
+	bool collectStatistics = false;
+	string configFile;
+	string indexAttributes;
+	StoreClock *clock = nullptr;
+	CommandStream::ResultFormat resultFormat = CommandStream::ResultFormat::Text;
+	string exportDirectory;
+	RecordFormat exportFormat = RecordFormat::JsonLines;
+	string importDirectory;
+	vector<char*> arguments;
+	for(int i = 0; i < argc; i++) {
+
+		if(string(argv[i]) == "--stats") {
+
+			collectStatistics = true;
+		}
+		else if(string(argv[i]) == "--memory") {
+
+			MemoryAccounting::enable();
+		}
+		else if(string(argv[i]) == "--config" && i + 1 < argc) {
+
+			configFile = argv[++i];
+		}
+		else if(string(argv[i]) == "--index" && i + 1 < argc) {
+
+			indexAttributes = argv[++i];
+		}
+		else if(string(argv[i]) == "--clock" && i + 1 < argc) {
+
+			delete clock;
+			clock = StoreClock::create(argv[++i]);
+			if(clock == nullptr) {
+
+				cout << "Unknown clock: " << argv[i] << " (expected system, monotonic, simulated or simulated:<start time>)" << endl;
+				return 1;
+			}
+		}
+		else if((string(argv[i]) == "--export" || string(argv[i]) == "--export-csv") && i + 1 < argc) {
+
+			exportFormat = string(argv[i]) == "--export" ? RecordFormat::JsonLines : RecordFormat::Csv;
+			exportDirectory = argv[++i];
+		}
+		else if(string(argv[i]) == "--import" && i + 1 < argc) {
+
+			importDirectory = argv[++i];
+		}
+		else if(string(argv[i]) == "--format" && i + 1 < argc) {
+
+			string format = argv[++i];
+			if(format == "jsonl") {
+
+				resultFormat = CommandStream::ResultFormat::JsonLines;
+			}
+			else if(format == "binary") {
+
+				resultFormat = CommandStream::ResultFormat::Binary;
+			}
+			else if(format != "text") {
+
+				cout << "Unknown result format: " << format << " (expected text, jsonl or binary)" << endl;
+				delete clock;
+				return 1;
+			}
+		}
+		else {
+
+			arguments.push_back(argv[i]);
+		}
+	}
+	argc = arguments.size();
+	argv = arguments.data();
+	if(resultFormat == CommandStream::ResultFormat::Text) {
+
+		cout << "-------------------------------Movie Rental Store-------------------------------" << endl << endl;
+	}
+	int status = 0;
+	bool serving = (argc >= 3 && (string(argv[1]) == "--serve" || string(argv[1]) == "--serve-tcp" || string(argv[1]) == "--stream-fd"))
+		|| (argc >= 2 && string(argv[1]) == "--stream");
+	if(!serving && argc > (importDirectory == "" ? 4 : 2)) {
+
+		cout << "Usage: " << argv[0] << (importDirectory == "" ? " [Movie File] [Customer File] [Command File]" : " --import <directory> [Command File]") << endl;
+		delete clock;
+		return 1;
+	}
+	if(serving) {
+
+		status = runServer(argc, argv, movieFile, customerFile, collectStatistics, configFile, indexAttributes, clock, resultFormat, importDirectory);
+	}
+	else {
+
+		if(importDirectory != "") {
+
+			commandFile = argc > 1 ? argv[1] : commandFile;
+		}
+		else {
+
+			movieFile = argc > 1 ? argv[1] : movieFile;
+			customerFile = argc > 2 ? argv[2] : customerFile;
+			commandFile = argc > 3 ? argv[3] : commandFile;
+		}
+		MovieRentalStore store;
+		if(collectStatistics) {
+
+			store.enableStatistics();
+		}
+		if(clock != nullptr) {
+
+			store.setClock(clock);
+		}
+		if((configFile == "" || store.loadCatalogConfig(configFile)) && (indexAttributes == "" || store.enableSecondaryIndexes(indexAttributes))) {
+
+			if(importDirectory != "") {
+
+				status = store.importState(importDirectory) && store.scanCommandFile(commandFile) ? 0 : 1;
+			}
+			else {
+
+				status = store.processFiles(movieFile, customerFile, commandFile) ? 0 : 1;
+			}
+			if(status == 0 && exportDirectory != "" && !store.exportState(exportDirectory, exportFormat)) {
+
+				status = 1;
+			}
+		}
+		else {
+
+			status = 1;
+		}
+		if(collectStatistics || MemoryAccounting::isEnabled()) {
+
+			store.printStatistics();
+		}
+	}
+	delete clock;
+	if(MemoryAccounting::isEnabled()) {
+
+		MemoryAccounting::printLeaks(cout);
+	}
+	return status;
+}
@@ -0,0 +1,872 @@
+#include "RecordFormat.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+  * Gets the file extension of a format.
+  *
+  * @param format - The format
+  *
+  * @return "jsonl" or "csv"
+  */
+const char *getRecordExtension(RecordFormat format) {
+
+	return format == RecordFormat::Csv ? "csv" : "jsonl";
+}
+
+/**
+  * Constructor allocates the buffer. "open" must be called before records are written.
+  *
+  * @param recordFormat - The format records are written in
+  * @param bufferSize - The size of the buffer
+  */
+RecordWriter::RecordWriter(RecordFormat recordFormat, size_t bufferSize) : format(recordFormat), buffer(max(bufferSize, (size_t) 64)) {}
+
+/**
+  * Destructor writes out the buffer and closes the file, if open.
+  */
+RecordWriter::~RecordWriter() {
+
+	close();
+}
+
+/**
+  * Creates (or truncates) a file to write records to. A CSV file starts with a header row holding the
+  * names of the fields.
+  *
+  * @param filePath - The directory of the file
+  * @param fieldNames - The names of the fields of every record, in the order they are written
+  *
+  * @return The success status of the open
+  */
+bool RecordWriter::open(const string &filePath, const vector<string> &fieldNames) {
+
+	close();
+	fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(fd == -1) {
+
+		cout << "Could not open record file " << filePath << ": " << strerror(errno) << endl;
+		return false;
+	}
+	path = filePath;
+	used = 0;
+	field = 0;
+	failed = false;
+	bytes = 0;
+	fieldPrefixes.clear();
+	for(size_t i = 0; i < fieldNames.size(); i++) {
+
+		if(format == RecordFormat::Csv) {
+
+			fieldPrefixes.push_back(i == 0 ? "" : ",");
+		}
+		else {
+
+			fieldPrefixes.push_back((i == 0 ? "{\"" : ",\"") + fieldNames[i] + "\":");
+		}
+	}
+	if(format == RecordFormat::Csv) {
+
+		for(size_t i = 0; i < fieldNames.size(); i++) {
+
+			writeText(fieldNames[i]);
+		}
+		endRecord();
+	}
+	records = 0;
+	return true;
+}
+
+/**
+  * Writes the buffer out to the file. A failed write is reported by "close".
+  */
+void RecordWriter::flush() {
+
+	const char *next = buffer.data();
+	const char *last = buffer.data() + used;
+	while(fd != -1 && !failed && next < last) {
+
+		ssize_t written = write(fd, next, last - next);
+		if(written == -1 && errno == EINTR) {
+
+			continue;
+		}
+		if(written <= 0) {
+
+			cout << "Could not write record file " << path << ": " << strerror(errno) << endl;
+			failed = true;
+			break;
+		}
+		next += written;
+	}
+	bytes += used;
+	used = 0;
+}
+
+/**
+  * Makes room at the end of the buffer: the buffer is written out when too full, and only grown for
+  * a field larger than the whole buffer.
+  *
+  * @param size - The number of bytes about to be appended
+  *
+  * @return Where they are appended
+  */
+char *RecordWriter::reserve(size_t size) {
+
+	if(buffer.size() - used < size) {
+
+		flush();
+		if(buffer.size() < size) {
+
+			buffer.resize(size);
+		}
+	}
+	return buffer.data() + used;
+}
+
+/**
+  * Appends what precedes the next field: its key, or the separator from the field before it.
+  */
+void RecordWriter::beginField() {
+
+	const string &prefix = fieldPrefixes[min(field, fieldPrefixes.size() - 1)];
+	char *position = reserve(prefix.size());
+	memcpy(position, prefix.data(), prefix.size());
+	used += prefix.size();
+}
+
+/**
+  * Appends the next field of the record, an integer (formatted with "to_chars").
+  *
+  * @param value - The integer
+  */
+void RecordWriter::writeInteger(long long value) {
+
+	beginField();
+	char *position = reserve(20);
+	used = to_chars(position, position + 20, value).ptr - buffer.data();
+	field++;
+}
+
+/**
+  * Appends the next field of the record, text. JSON strings escape quotes, backslashes and control
+  * characters; CSV fields holding a comma, a quote or a line break are quoted, their quotes doubled.
+  * Other text is copied as is.
+  *
+  * @param text - The text
+  */
+void RecordWriter::writeText(string_view text) {
+
+	beginField();
+	if(format == RecordFormat::Csv) {
+
+		bool quoted = false;
+		for(char character : text) {
+
+			quoted |= character == ',' || character == '"' || character == '\n' || character == '\r';
+		}
+		if(!quoted) {
+
+			char *position = reserve(text.size());
+			memcpy(position, text.data(), text.size());
+			used += text.size();
+		}
+		else {
+
+			char *first = reserve(2 * text.size() + 2);
+			char *position = first;
+			*position++ = '"';
+			for(char character : text) {
+
+				*position++ = character;
+				if(character == '"') {
+
+					*position++ = '"';
+				}
+			}
+			*position++ = '"';
+			used += position - first;
+		}
+		field++;
+		return;
+	}
+	static const char hexDigits[] = "0123456789abcdef";
+	char *first = reserve(6 * text.size() + 2);
+	char *position = first;
+	*position++ = '"';
+	for(char character : text) {
+
+		unsigned char code = character;
+		if(code >= 0x20 && code != '"' && code != '\\') {
+
+			*position++ = character;
+		}
+		else if(code == '"' || code == '\\') {
+
+			*position++ = '\\';
+			*position++ = character;
+		}
+		else if(code == '\n') {
+
+			*position++ = '\\';
+			*position++ = 'n';
+		}
+		else if(code == '\t') {
+
+			*position++ = '\\';
+			*position++ = 't';
+		}
+		else {
+
+			memcpy(position, "\\u00", 4);
+			position[4] = hexDigits[code >> 4];
+			position[5] = hexDigits[code & 15];
+			position += 6;
+		}
+	}
+	*position++ = '"';
+	used += position - first;
+	field++;
+}
+
+/**
+  * Ends the record: a JSON object is closed, and the line ended.
+  */
+void RecordWriter::endRecord() {
+
+	char *position = reserve(3);
+	if(format == RecordFormat::JsonLines) {
+
+		*position++ = field == 0 ? '{' : '}';
+		if(field == 0) {
+
+			*position++ = '}';
+		}
+	}
+	*position++ = '\n';
+	used = position - buffer.data();
+	field = 0;
+	records++;
+}
+
+/**
+  * Writes out the buffer and closes the file.
+  *
+  * @return Whether every record was written to the file
+  */
+bool RecordWriter::close() {
+
+	if(fd == -1) {
+
+		return !failed;
+	}
+	flush();
+	if(::close(fd) != 0 && !failed) {
+
+		cout << "Could not write record file " << path << ": " << strerror(errno) << endl;
+		failed = true;
+	}
+	fd = -1;
+	return !failed;
+}
+
+/**
+  * Calls a visitor with the fields of a CSV record: the index of the column, the field's text without
+  * its quotes, and whether it holds doubled quotes (to be decoded).
+  *
+  * @param record - The record, without its line break
+  * @param visitor - Callable taking an "int", a "string_view" and a "bool"
+  *
+  * @return Whether the record is valid (every quoted field is closed, and followed by a separator)
+  */
+template <typename Visitor>
+static bool visitCsvFields(string_view record, Visitor &&visitor) {
+
+	size_t position = 0;
+	for(int column = 0; ; column++) {
+
+		if(position < record.size() && record[position] == '"') {
+
+			size_t first = position + 1;
+			size_t last = first;
+			bool doubledQuotes = false;
+			while(true) {
+
+				if(last >= record.size()) {
+
+					return false;
+				}
+				if(record[last] == '"') {
+
+					if(last + 1 < record.size() && record[last + 1] == '"') {
+
+						doubledQuotes = true;
+						last += 2;
+						continue;
+					}
+					break;
+				}
+				last++;
+			}
+			visitor(column, record.substr(first, last - first), doubledQuotes);
+			position = last + 1;
+			if(position < record.size() && record[position] != ',') {
+
+				return false;
+			}
+		}
+		else {
+
+			size_t separator = min(record.find(',', position), record.size());
+			visitor(column, record.substr(position, separator - position), false);
+			position = separator;
+		}
+		if(position >= record.size()) {
+
+			return true;
+		}
+		position++;
+	}
+}
+
+/**
+  * Constructor leaves the reader closed. "open" must be called before records are read.
+  */
+RecordReader::RecordReader() {}
+
+/**
+  * Destructor closes the file, if open.
+  */
+RecordReader::~RecordReader() {
+
+	if(fd != -1) {
+
+		close(fd);
+	}
+}
+
+/**
+  * Evaluates whether a file name ends in the extension of a format.
+  *
+  * @param filePath - The file name
+  * @param format - The format
+  *
+  * @return Whether the name ends in "." and the format's extension
+  */
+bool RecordReader::hasExtension(const string &filePath, RecordFormat format) {
+
+	string extension = string(".") + getRecordExtension(format);
+	return filePath.size() >= extension.size() && filePath.compare(filePath.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+  * Opens a file of records: its format is known from its extension (".csv", else JSON lines). The
+  * header row of a CSV file is read, and must name every field asked for.
+  *
+  * @param filePath - The directory of the file
+  * @param names - The names of the fields read from every record
+  *
+  * @return The success status of the open (see "getError")
+  */
+bool RecordReader::open(const string &filePath, const vector<string> &names) {
+
+	if(fd != -1) {
+
+		close(fd);
+	}
+	path = filePath;
+	format = hasExtension(filePath, RecordFormat::Csv) ? RecordFormat::Csv : RecordFormat::JsonLines;
+	buffer.resize(bufferSize);
+	start = 0;
+	end = 0;
+	endOfFile = false;
+	fieldNames = names;
+	columnFields.clear();
+	fields.assign(names.size(), string_view());
+	decodedFields.assign(names.size(), "");
+	line = 0;
+	nextLine = 1;
+	error = "";
+	fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd == -1) {
+
+		error = "Could not open " + filePath + ": " + strerror(errno);
+		return false;
+	}
+	if(format == RecordFormat::JsonLines) {
+
+		return true;
+	}
+	string_view header;
+	if(!readRecord(header)) {
+
+		return error.empty() ? fail("the header row is missing") : false;
+	}
+	string decodedName;
+	vector<bool> found(names.size(), false);
+	if(!visitCsvFields(header, [&](int, string_view name, bool doubledQuotes) {
+
+		if(doubledQuotes) {
+
+			decodedName.clear();
+			for(size_t i = 0; i < name.size(); i += 1 + (name[i] == '"')) {
+
+				decodedName += name[i];
+			}
+			name = decodedName;
+		}
+		int field = findField(name, columnFields.size());
+		if(field >= 0) {
+
+			found[field] = true;
+		}
+		columnFields.push_back(field);
+	})) {
+
+		return fail("malformed header row");
+	}
+	for(size_t field = 0; field < names.size(); field++) {
+
+		if(!found[field]) {
+
+			return fail("the header row has no field \"" + names[field] + "\"");
+		}
+	}
+	return true;
+}
+
+/**
+  * Records an error, prefixed by the file and line it was found on.
+  *
+  * @param message - The error
+  *
+  * @return false
+  */
+bool RecordReader::fail(const string &message) {
+
+	error = path + " line " + to_string(line) + ": " + message;
+	return false;
+}
+
+/**
+  * Reads more of the file into the buffer. The bytes of the record being parsed are moved to the
+  * start of the buffer first, and the buffer doubled when the record fills it.
+  *
+  * @return Whether the file could be read (its end is reached when nothing more is)
+  */
+bool RecordReader::fill() {
+
+	memmove(buffer.data(), buffer.data() + start, end - start);
+	end -= start;
+	start = 0;
+	if(end == buffer.size()) {
+
+		buffer.resize(2 * buffer.size());
+	}
+	while(true) {
+
+		ssize_t bytesRead = read(fd, buffer.data() + end, buffer.size() - end);
+		if(bytesRead == -1 && errno == EINTR) {
+
+			continue;
+		}
+		if(bytesRead < 0) {
+
+			error = "Could not read " + path + ": " + strerror(errno);
+			return false;
+		}
+		endOfFile = bytesRead == 0;
+		end += bytesRead;
+		return true;
+	}
+}
+
+/**
+  * Finds the end of the record starting at "start": its line break, outside of quotes in CSV (a
+  * quoted field may span lines). More of the file is read until it is found; the last record of the
+  * file may have none.
+  *
+  * @return The length of the record, -1 at the end of the file, -2 if the file could not be read
+  */
+long long RecordReader::findRecordEnd() {
+
+	size_t scanned = start;
+	bool quoted = false;
+	while(true) {
+
+		if(format == RecordFormat::JsonLines) {
+
+			const void *lineBreak = memchr(buffer.data() + scanned, '\n', end - scanned);
+			if(lineBreak != nullptr) {
+
+				return (const char*) lineBreak - (buffer.data() + start);
+			}
+			scanned = end;
+		}
+		else {
+
+			for(; scanned < end; scanned++) {
+
+				if(buffer[scanned] == '"') {
+
+					quoted = !quoted;
+				}
+				else if(buffer[scanned] == '\n' && !quoted) {
+
+					return scanned - start;
+				}
+			}
+		}
+		if(endOfFile) {
+
+			return start < end ? (long long) (end - start) : -1;
+		}
+		size_t scannedLength = scanned - start;
+		if(!fill()) {
+
+			return -2;
+		}
+		scanned = start + scannedLength;
+	}
+}
+
+/**
+  * Reads the next record of the file that is not blank.
+  *
+  * @param record - Receives the record, without its line break (valid until the buffer is read into again)
+  *
+  * @return Whether a record was read (false at the end of the file, or if it could not be read)
+  */
+bool RecordReader::readRecord(string_view &record) {
+
+	while(true) {
+
+		long long length = findRecordEnd();
+		if(length < 0) {
+
+			return false;
+		}
+		record = string_view(buffer.data() + start, length);
+		start = min(start + (size_t) length + 1, end);
+		line = nextLine;
+		nextLine += 1 + (format == RecordFormat::Csv ? count(record.begin(), record.end(), '\n') : 0);
+		if(!record.empty() && record.back() == '\r') {
+
+			record.remove_suffix(1);
+		}
+		if(!record.empty()) {
+
+			return true;
+		}
+	}
+}
+
+/**
+  * Reads the next record, its fields then read by "getText" and "getInteger".
+  *
+  * @return Whether a record was read: false at the end of the file, or on an error (see "getError")
+  */
+bool RecordReader::next() {
+
+	string_view record;
+	if(fd == -1 || !error.empty() || !readRecord(record)) {
+
+		return false;
+	}
+	fill_n(fields.begin(), fields.size(), string_view());
+	return format == RecordFormat::Csv ? parseCsvRecord(record) : parseJsonRecord(record);
+}
+
+/**
+  * Gets the index of a field asked for, checking the field expected next first (records usually list
+  * their fields in the same order).
+  *
+  * @param name - The name of the field
+  * @param expected - The index of the field expected
+  *
+  * @return The index of the field, -1 if it is not asked for
+  */
+int RecordReader::findField(string_view name, size_t expected) const {
+
+	if(expected < fieldNames.size() && fieldNames[expected] == name) {
+
+		return expected;
+	}
+	for(size_t field = 0; field < fieldNames.size(); field++) {
+
+		if(fieldNames[field] == name) {
+
+			return field;
+		}
+	}
+	return -1;
+}
+
+/**
+  * Parses a CSV record into the fields asked for, by the columns of the header row.
+  *
+  * @param record - The record
+  *
+  * @return Whether the record is valid
+  */
+bool RecordReader::parseCsvRecord(string_view record) {
+
+	if(!visitCsvFields(record, [&](int column, string_view value, bool doubledQuotes) {
+
+		if(column >= (int) columnFields.size() || columnFields[column] < 0) {
+
+			return;
+		}
+		int field = columnFields[column];
+		if(doubledQuotes) {
+
+			string &decoded = decodedFields[field];
+			decoded.clear();
+			for(size_t i = 0; i < value.size(); i += 1 + (value[i] == '"')) {
+
+				decoded += value[i];
+			}
+			value = decoded;
+		}
+		fields[field] = value;
+	})) {
+
+		return fail("malformed CSV record");
+	}
+	return true;
+}
+
+/**
+  * Appends a character code to text, encoded as UTF-8.
+  *
+  * @param text - The text
+  * @param code - The character code
+  */
+static void appendUtf8(string &text, unsigned int code) {
+
+	if(code < 0x80) {
+
+		text += (char) code;
+	}
+	else if(code < 0x800) {
+
+		text += (char) (0xc0 | code >> 6);
+		text += (char) (0x80 | (code & 0x3f));
+	}
+	else if(code < 0x10000) {
+
+		text += (char) (0xe0 | code >> 12);
+		text += (char) (0x80 | ((code >> 6) & 0x3f));
+		text += (char) (0x80 | (code & 0x3f));
+	}
+	else {
+
+		text += (char) (0xf0 | code >> 18);
+		text += (char) (0x80 | ((code >> 12) & 0x3f));
+		text += (char) (0x80 | ((code >> 6) & 0x3f));
+		text += (char) (0x80 | (code & 0x3f));
+	}
+}
+
+/**
+  * Parses a JSON string. A string without escapes is viewed in place; one with escapes is decoded
+  * into the buffer of its field (or of keys).
+  *
+  * @param record - The record
+  * @param position - The position of the opening quote, moved past the closing quote
+  * @param field - The field the string is the value of (-1 for a key, or a field not asked for)
+  * @param text - Receives the text of the string
+  *
+  * @return Whether the string is valid
+  */
+bool RecordReader::parseJsonString(string_view record, size_t &position, int field, string_view &text) {
+
+	size_t first = ++position;
+	while(position < record.size() && record[position] != '"' && record[position] != '\\') {
+
+		position++;
+	}
+	if(position < record.size() && record[position] == '"') {
+
+		text = record.substr(first, position - first);
+		position++;
+		return true;
+	}
+	string &decoded = field >= 0 ? decodedFields[field] : decodedKey;
+	decoded.assign(record.data() + first, position - first);
+	while(position < record.size() && record[position] != '"') {
+
+		if(record[position] != '\\') {
+
+			decoded += record[position++];
+			continue;
+		}
+		if(++position >= record.size()) {
+
+			break;
+		}
+		char escaped = record[position++];
+		switch(escaped) {
+
+			case 'b':
+				decoded += '\b';
+				break;
+			case 'f':
+				decoded += '\f';
+				break;
+			case 'n':
+				decoded += '\n';
+				break;
+			case 'r':
+				decoded += '\r';
+				break;
+			case 't':
+				decoded += '\t';
+				break;
+			case 'u':
+				{
+				unsigned int code = 0;
+				if(position + 4 > record.size() || from_chars(record.data() + position, record.data() + position + 4, code, 16).ptr != record.data() + position + 4) {
+
+					return fail("malformed \\u escape");
+				}
+				position += 4;
+
+				// a surrogate pair encodes a character beyond the basic plane
+				unsigned int low = 0;
+				if(code >= 0xd800 && code < 0xdc00 && position + 6 <= record.size() && record[position] == '\\' && record[position + 1] == 'u'
+					&& from_chars(record.data() + position + 2, record.data() + position + 6, low, 16).ptr == record.data() + position + 6
+					&& low >= 0xdc00 && low < 0xe000) {
+
+					code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+					position += 6;
+				}
+				appendUtf8(decoded, code);
+				break;
+				}
+			default:
+				decoded += escaped;
+				break;
+		}
+	}
+	if(position >= record.size()) {
+
+		return fail("unterminated string");
+	}
+	text = decoded;
+	position++;
+	return true;
+}
+
+/**
+  * Parses a JSON lines record, a flat object, into the fields asked for. Values are strings, numbers,
+  * booleans or null (read as empty); nested objects and arrays are not supported.
+  *
+  * @param record - The record
+  *
+  * @return Whether the record is valid
+  */
+bool RecordReader::parseJsonRecord(string_view record) {
+
+	size_t position = 0;
+	auto skipSpace = [&]() {
+
+		while(position < record.size() && (record[position] == ' ' || record[position] == '\t')) {
+
+			position++;
+		}
+	};
+	skipSpace();
+	if(position >= record.size() || record[position] != '{') {
+
+		return fail("expected a JSON object");
+	}
+	position++;
+	skipSpace();
+	bool closed = position < record.size() && record[position] == '}';
+	position += closed;
+	size_t expected = 0;
+	while(!closed) {
+
+		string_view key;
+		if(position >= record.size() || record[position] != '"' || !parseJsonString(record, position, -1, key)) {
+
+			return error.empty() ? fail("expected a key") : false;
+		}
+		skipSpace();
+		if(position >= record.size() || record[position] != ':') {
+
+			return fail("expected ':' after the key \"" + string(key) + "\"");
+		}
+		position++;
+		skipSpace();
+		int field = findField(key, expected);
+		string_view value;
+		if(position < record.size() && record[position] == '"') {
+
+			if(!parseJsonString(record, position, field, value)) {
+
+				return false;
+			}
+		}
+		else {
+
+			size_t first = position;
+			while(position < record.size() && record[position] != ',' && record[position] != '}' && record[position] != ' ' && record[position] != '\t') {
+
+				position++;
+			}
+			value = record.substr(first, position - first);
+			if(value.empty() || value[0] == '{' || value[0] == '[') {
+
+				return fail("the value of \"" + string(key) + "\" is not a string, number, boolean or null");
+			}
+			if(value == "null") {
+
+				value = string_view();
+			}
+		}
+		if(field >= 0) {
+
+			fields[field] = value;
+			expected = field + 1;
+		}
+		skipSpace();
+		if(position >= record.size() || (record[position] != ',' && record[position] != '}')) {
+
+			return fail("expected ',' or '}' after the value of \"" + string(key) + "\"");
+		}
+		closed = record[position++] == '}';
+		skipSpace();
+	}
+	if(position != record.size()) {
+
+		return fail("text after the JSON object");
+	}
+	return true;
+}
+
+/**
+  * Parses a field of the current record as an integer (with "from_chars").
+  *
+  * @param field - The index of the field
+  * @param value - Receives the integer
+  *
+  * @return Whether the whole field is an integer (an error is recorded otherwise)
+  */
+bool RecordReader::getInteger(int field, long long &value) {
+
+	string_view text = fields[field];
+	from_chars_result parsed = from_chars(text.data(), text.data() + text.size(), value);
+	if(text.empty() || parsed.ec != errc() || parsed.ptr != text.data() + text.size()) {
+
+		return fail("the field \"" + fieldNames[field] + "\" is not an integer: \"" + string(text) + "\"");
+	}
+	return true;
+}
@@ -0,0 +1,202 @@
+#ifndef RECORDFORMAT_H
+#define RECORDFORMAT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// the formats records (rows of named fields: text or integers) are written in and read from:
+// JSON lines, one object per line ({"custID":1000,"lastName":"Mouse",...}), or CSV (RFC 4180) with a
+// header row naming the fields
+enum class RecordFormat { JsonLines, Csv };
+
+// gets the file extension of a format ("jsonl" or "csv")
+const char *getRecordExtension(RecordFormat);
+
+// writes records to a file through a preallocated buffer, written out whenever it fills: integers are
+// formatted with "to_chars", text is copied whole unless it holds characters to escape (JSON) or
+// quote (CSV), so writing a record allocates nothing
+class RecordWriter {
+
+private:
+
+	RecordFormat format;
+	int fd = -1;
+	string path;
+
+	// the buffer, and the bytes of it written to since it was last written out
+	vector<char> buffer;
+	size_t used = 0;
+
+	// what precedes each field of a record: its key ("{\"name\":" for the first field, ",\"name\":" for
+	// the others) in JSON lines, the separator in CSV
+	vector<string> fieldPrefixes;
+
+	// the field of the record written next
+	size_t field = 0;
+
+	bool failed = false;
+	long long records = 0;
+	long long bytes = 0;
+
+	// writes the buffer out to the file
+	void flush();
+
+	// makes room for the number of bytes argument at the end of the buffer (written out, or grown)
+	char *reserve(size_t);
+
+	// appends the prefix of the next field
+	void beginField();
+
+public:
+
+	// the size of the buffer unless the constructor is given another
+	static const size_t defaultBufferSize = 1 << 20;
+
+	// RecordWriter constructor - the format and the size of the buffer
+	RecordWriter(RecordFormat, size_t = defaultBufferSize);
+
+	// RecordWriter destructor - closes the file
+	~RecordWriter();
+
+	RecordWriter(const RecordWriter&) = delete;
+	RecordWriter &operator=(const RecordWriter&) = delete;
+
+	// creates (or truncates) the file at the path argument, whose records hold the fields named in the
+	// list argument, in order; a CSV file starts with their names
+	bool open(const string &, const vector<string> &);
+
+	// appends the next field of the record, an integer
+	void writeInteger(long long);
+
+	// appends the next field of the record, text
+	void writeText(string_view);
+
+	// ends the record (its fields must all have been written)
+	void endRecord();
+
+	// writes out the buffer and closes the file; gets whether every record was written
+	bool close();
+
+	long long getRecordCount() const {
+
+		return records;
+	}
+
+	long long getByteCount() const {
+
+		return bytes;
+	}
+};
+
+// reads the records of a file written by "RecordWriter", or by any other program, block by block. the
+// fields are found by name: in CSV from the header row, in JSON lines from the keys of each object
+// (keys not asked for are skipped, fields missing read as empty). fields are views into the block
+// read, valid until the next record; a field holding escapes or quotes is decoded into a buffer the
+// reader reuses.
+class RecordReader {
+
+private:
+
+	int fd = -1;
+	string path;
+
+	// the format, known from the file's extension
+	RecordFormat format = RecordFormat::JsonLines;
+
+	// the block read: the record being parsed starts at "start", and the bytes read end at "end"
+	vector<char> buffer;
+	size_t start = 0;
+	size_t end = 0;
+	bool endOfFile = false;
+
+	// the names of the fields asked for, the field of every CSV column (-1 for the columns not asked
+	// for), and the fields of the current record
+	vector<string> fieldNames;
+	vector<int> columnFields;
+	vector<string_view> fields;
+
+	// the decoded text of the fields (and of a key) holding escapes or quotes
+	vector<string> decodedFields;
+	string decodedKey;
+
+	// the line the current record starts on, and the line after it
+	long long line = 0;
+	long long nextLine = 1;
+	string error;
+
+	// reads more of the file into the buffer, keeping the bytes from "start"
+	bool fill();
+
+	// finds the end of the record starting at "start" (its newline), reading more of the file as needed;
+	// gets the record's length, -1 at the end of the file, -2 if the file could not be read
+	long long findRecordEnd();
+
+	// reads the next record that is not blank into the argument, without its newline; false at the end
+	// of the file or if it could not be read
+	bool readRecord(string_view &);
+
+	// parses a record (first argument, its text) into "fields"
+	bool parseCsvRecord(string_view);
+	bool parseJsonRecord(string_view);
+
+	// parses a JSON string starting at the position argument (its opening quote) of the record argument;
+	// the position is moved past the string, and the field argument (-1 for a key) receives its text
+	bool parseJsonString(string_view, size_t &, int, string_view &);
+
+	// gets the index of the field named by the argument, -1 if it is not asked for
+	int findField(string_view, size_t) const;
+
+	// records the error argument, as found on the current line
+	bool fail(const string &);
+
+public:
+
+	// the size of the buffer, grown for longer records
+	static const size_t bufferSize = 1 << 20;
+
+	// RecordReader constructor - no file is opened
+	RecordReader();
+
+	// RecordReader destructor - closes the file
+	~RecordReader();
+
+	RecordReader(const RecordReader&) = delete;
+	RecordReader &operator=(const RecordReader&) = delete;
+
+	// opens the file at the path argument (".jsonl" or ".csv") to read the fields named in the list
+	// argument; a CSV file must hold every field in its header
+	bool open(const string &, const vector<string> &);
+
+	// reads the next record; false at the end of the file, or on an error (see "getError")
+	bool next();
+
+	// gets a field (argument, its index in the list given to "open") of the current record
+	string_view getText(int field) const {
+
+		return fields[field];
+	}
+
+	// parses a field (first argument) of the current record as an integer into the second argument;
+	// gets whether it is one (an error is recorded otherwise)
+	bool getInteger(int, long long &);
+
+	// gets the error that stopped reading, empty if none did
+	const string &getError() const {
+
+		return error;
+	}
+
+	// gets the line the current record started on
+	long long getLine() const {
+
+		return line;
+	}
+
+	// gets whether the file ends in the extension of a format
+	static bool hasExtension(const string &, RecordFormat);
+};
+
+#endif
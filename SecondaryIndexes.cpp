@@ -0,0 +1,234 @@
+#include "SecondaryIndexes.h"
+#include "MemoryAccounting.h"
+#include "TitleSearchIndex.h"
+
+#include <algorithm>
+
+// names of the attributes, in enum order
+static const char *attributeNames[] = {"director", "year", "actor", "title"};
+
+/**
+  * Gets the attribute a name refers to.
+  *
+  * @param name - "director", "year", "actor" or "title"
+  *
+  * @return The attribute, -1 if the name refers to none
+  */
+int SecondaryIndexes::parseAttribute(const string &name) {
+
+	for(int attribute = 0; attribute < AttributeCount; attribute++) {
+
+		if(name == attributeNames[attribute]) {
+
+			return attribute;
+		}
+	}
+	return -1;
+}
+
+/**
+  * Gets the name of an attribute.
+  *
+  * @param attribute - The attribute
+  *
+  * @return The attribute's name
+  */
+const char *SecondaryIndexes::getAttributeName(int attribute) {
+
+	return attributeNames[attribute];
+}
+
+/**
+  * Gets the key a value is stored under: names are compared without case or punctuation (as the
+  * title search index compares them), years as their digits.
+  *
+  * @param value - The value
+  *
+  * @return The key
+  */
+string SecondaryIndexes::getKey(string_view value) {
+
+	return TitleSearchIndex::normalize(value);
+}
+
+/**
+  * Gets the key of a movie's value of an attribute (an empty key is not indexed).
+  *
+  * @param attribute - The attribute
+  * @param movie - The movie
+  * @param majorActor - The movie's major actor, empty if it has none
+  *
+  * @return The key
+  */
+string SecondaryIndexes::getMovieKey(int attribute, const Movie &movie, string_view majorActor) {
+
+	switch(attribute) {
+
+		case Director:
+			return getKey(movie.getDirector());
+		case ReleaseYear:
+			return to_string(movie.getReleaseYear());
+		case Actor:
+			return getKey(majorActor);
+		default:
+			return getKey(movie.getTitle());
+	}
+}
+
+/**
+  * Enables the index of an attribute. The index starts empty: the titles already carried must be
+  * added to it.
+  *
+  * @param attribute - The attribute
+  */
+void SecondaryIndexes::enable(int attribute) {
+
+	enabled[attribute] = true;
+}
+
+/**
+  * Evaluates whether an attribute is indexed.
+  *
+  * @param attribute - The attribute
+  *
+  * @return Whether its index is enabled
+  */
+bool SecondaryIndexes::isEnabled(int attribute) const {
+
+	return enabled[attribute];
+}
+
+/**
+  * Evaluates whether any attribute is indexed.
+  *
+  * @return Whether an index is enabled
+  */
+bool SecondaryIndexes::anyEnabled() const {
+
+	return find_if(enabled, enabled + AttributeCount, [](bool attributeEnabled) { return attributeEnabled; }) != enabled + AttributeCount;
+}
+
+/**
+  * Indexes a movie under every attribute enabled.
+  *
+  * @param movie - The movie
+  * @param command - The movie portion of its borrow command (genre code and sorting criteria)
+  * @param majorActor - Its major actor, empty if it has none
+  */
+void SecondaryIndexes::add(const Movie &movie, const string &command, string_view majorActor) {
+
+	for(int attribute = 0; attribute < AttributeCount; attribute++) {
+
+		if(enabled[attribute]) {
+
+			add(attribute, movie, command, majorActor);
+		}
+	}
+}
+
+/**
+  * Indexes a movie under one attribute, e.g. as its index is built from the titles already carried.
+  *
+  * @param attribute - The attribute
+  * @param movie - The movie
+  * @param command - The movie portion of its borrow command (genre code and sorting criteria)
+  * @param majorActor - Its major actor, empty if it has none
+  */
+void SecondaryIndexes::add(int attribute, const Movie &movie, const string &command, string_view majorActor) {
+
+	string key = getMovieKey(attribute, movie, majorActor);
+	if(key != "") {
+
+		titles[attribute][key].push_back(command);
+		entryCounts[attribute]++;
+	}
+}
+
+/**
+  * Removes a movie from every attribute enabled.
+  *
+  * @param movie - The movie
+  * @param command - The movie portion of its borrow command (genre code and sorting criteria)
+  * @param majorActor - Its major actor, empty if it has none
+  */
+void SecondaryIndexes::remove(const Movie &movie, const string &command, string_view majorActor) {
+
+	for(int attribute = 0; attribute < AttributeCount; attribute++) {
+
+		if(!enabled[attribute]) {
+
+			continue;
+		}
+		unordered_map<string, vector<string>>::iterator found = titles[attribute].find(getMovieKey(attribute, movie, majorActor));
+		if(found == titles[attribute].end()) {
+
+			continue;
+		}
+		vector<string>::iterator title = std::find(found->second.begin(), found->second.end(), command);
+		if(title == found->second.end()) {
+
+			continue;
+		}
+		found->second.erase(title);
+		entryCounts[attribute]--;
+		if(found->second.empty()) {
+
+			titles[attribute].erase(found);
+		}
+	}
+}
+
+/**
+  * Finds the titles holding a value of an attribute.
+  *
+  * @param attribute - The attribute (must be enabled)
+  * @param value - The value, e.g. "Nora Ephron" or "1988"
+  *
+  * @return The commands of the titles, sorted
+  */
+vector<string> SecondaryIndexes::find(int attribute, const string &value) const {
+
+	vector<string> commands;
+	unordered_map<string, vector<string>>::const_iterator found = titles[attribute].find(getKey(value));
+	if(found != titles[attribute].end()) {
+
+		commands = found->second;
+	}
+	sort(commands.begin(), commands.end());
+	return commands;
+}
+
+/**
+  * Gets the number of titles indexed under an attribute.
+  *
+  * @param attribute - The attribute
+  *
+  * @return The number of titles
+  */
+size_t SecondaryIndexes::getEntryCount(int attribute) const {
+
+	return entryCounts[attribute];
+}
+
+/**
+  * Gets the bytes held by the index of an attribute: its hash map (nodes and buckets,
+  * approximately), the values and the commands listed under them.
+  *
+  * @param attribute - The attribute
+  *
+  * @return The bytes held
+  */
+size_t SecondaryIndexes::getBytes(int attribute) const {
+
+	const size_t nodeOverhead = 2 * sizeof(void*);
+	size_t bytes = titles[attribute].bucket_count() * sizeof(void*);
+	for(const pair<const string, vector<string>> &value : titles[attribute]) {
+
+		bytes += sizeof(value) + nodeOverhead + MemoryAccounting::stringHeapBytes(value.first) + value.second.capacity() * sizeof(string);
+		for(const string &command : value.second) {
+
+			bytes += MemoryAccounting::stringHeapBytes(command);
+		}
+	}
+	return bytes;
+}
@@ -0,0 +1,89 @@
+#ifndef SECONDARYINDEXES_H
+#define SECONDARYINDEXES_H
+
+#include "Movie.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// optional indexes of the titles of every genre by attributes the genre inventories are not ordered
+// by: director, release year, major actor (classics) and title. each index maps a value (names
+// compared without case or punctuation) to the titles holding it, every title named by the movie
+// portion of its borrow command (e.g. "F You've Got Mail, 1998"). indexes are off unless enabled
+// for a deployment; lookups on an attribute whose index is off are answered by the store scanning
+// its inventories instead.
+class SecondaryIndexes {
+
+public:
+
+	// the attributes titles can be indexed by
+	enum Attribute {
+
+		Director,
+		ReleaseYear,
+		Actor,
+		Title,
+
+		// number of attributes (not an attribute)
+		AttributeCount
+	};
+
+private:
+
+	// whether every attribute is indexed, and its titles by value
+	bool enabled[AttributeCount] = {};
+	unordered_map<string, vector<string>> titles[AttributeCount];
+
+	// number of titles indexed under every attribute
+	size_t entryCounts[AttributeCount] = {};
+
+public:
+
+	// gets the attribute named by the argument ("director", "year", "actor" or "title"), -1 if none is
+	static int parseAttribute(const string &);
+
+	// gets the name of the attribute argument
+	static const char *getAttributeName(int);
+
+	// gets the key a value is stored under (names without case or punctuation)
+	static string getKey(string_view);
+
+	// gets the key of the value of an attribute (first argument) of a movie, whose major actor is
+	// the last argument (empty if none)
+	static string getMovieKey(int, const Movie &, string_view);
+
+	// enables the index of the attribute argument; titles must then be added to it
+	void enable(int);
+
+	// evaluates whether the attribute argument is indexed
+	bool isEnabled(int) const;
+
+	// evaluates whether any attribute is indexed
+	bool anyEnabled() const;
+
+	// indexes a movie (first argument) under every attribute enabled; the second argument is its
+	// command (genre code and sorting criteria) and the third its major actor (empty if none)
+	void add(const Movie &, const string &, string_view);
+
+	// indexes a movie under the attribute (first argument) alone, whether or not enabled otherwise;
+	// the other arguments are those of "add"
+	void add(int, const Movie &, const string &, string_view);
+
+	// removes a movie (same arguments as "add") from every attribute enabled
+	void remove(const Movie &, const string &, string_view);
+
+	// gets the commands of the titles whose attribute (first argument) holds the value argument, sorted
+	vector<string> find(int, const string &) const;
+
+	// gets the number of titles indexed under the attribute argument
+	size_t getEntryCount(int) const;
+
+	// gets the bytes held by the index of the attribute argument
+	size_t getBytes(int) const;
+};
+
+#endif
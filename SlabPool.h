@@ -0,0 +1,178 @@
+#ifndef SLABPOOL_H
+#define SLABPOOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// a pool of fixed size blocks carved out of large slabs, holding objects of type "Base" or of any
+// class derived from it that fits in "blockSize" bytes. freed blocks are kept on a free list and
+// handed out again before a new slab is allocated; slabs double in size (up to "maxSlabBlocks"
+// blocks), so a million records cost a few dozen allocations. the pool does not track which
+// blocks are in use: its owner destroys the objects it created, and the pool frees every slab at
+// once when it is destroyed.
+template <class Base, size_t blockSize = sizeof(Base)>
+class SlabPool {
+
+private:
+
+	// a block on the free list
+	struct FreeBlock {
+
+		FreeBlock *next;
+	};
+
+	// size of a block, rounded up so every block is suitably aligned for any object
+	static const size_t storedSize = blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize;
+	static const size_t alignedBlockSize = (storedSize + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+
+	// number of blocks in the first slab, and the largest number of blocks in a slab
+	static const size_t minSlabBlocks = 64;
+	static const size_t maxSlabBlocks = 65536;
+
+	// every slab allocated, and the number of blocks in the next one
+	vector<char*> slabs;
+	size_t nextSlabBlocks = minSlabBlocks;
+
+	// blocks available for reuse
+	FreeBlock *freeList = nullptr;
+
+	// blocks of the newest slab not yet handed out
+	char *unusedBlocks = nullptr;
+	size_t unusedBlockCount = 0;
+
+	// number of objects currently alive in the pool
+	size_t liveObjects = 0;
+
+	/**
+	 * Gets a block for a new object: a freed block if there is one, otherwise the next unused
+	 * block of the newest slab, allocating a new slab when that one is used up.
+	 *
+	 * @return The block
+	 */
+	void *allocateBlock() {
+
+		if(freeList != nullptr) {
+
+			FreeBlock *block = freeList;
+			freeList = block->next;
+			return block;
+		}
+		if(unusedBlockCount == 0) {
+
+			unusedBlocks = static_cast<char*>(::operator new(nextSlabBlocks * alignedBlockSize));
+			unusedBlockCount = nextSlabBlocks;
+			slabs.push_back(unusedBlocks);
+			if(nextSlabBlocks < maxSlabBlocks) {
+
+				nextSlabBlocks *= 2;
+			}
+		}
+		void *block = unusedBlocks;
+		unusedBlocks += alignedBlockSize;
+		unusedBlockCount--;
+		return block;
+	}
+
+public:
+
+	SlabPool() {}
+
+	SlabPool(const SlabPool&) = delete;
+	SlabPool &operator=(const SlabPool&) = delete;
+
+	/**
+	 * Frees every slab. Objects still alive are not destroyed.
+	 */
+	~SlabPool() {
+
+		for(size_t i = 0; i < slabs.size(); i++) {
+
+			::operator delete(slabs[i]);
+		}
+	}
+
+	/**
+	 * Constructs an object in a block of the pool.
+	 *
+	 * @param arguments - The arguments passed to the object's constructor
+	 *
+	 * @return The constructed object
+	 */
+	template <class Type, class... Arguments>
+	Type *create(Arguments&&... arguments) {
+
+		static_assert(sizeof(Type) <= blockSize, "type does not fit in the pool's blocks");
+		void *block = allocateBlock();
+		Type *object = new(block) Type(forward<Arguments>(arguments)...);
+		liveObjects++;
+		return object;
+	}
+
+	/**
+	 * Destroys an object created by the pool and puts its block on the free list. The destructor
+	 * of "Type" is called, so passing the object as its final class avoids a virtual call.
+	 *
+	 * @param object - The object, nullptr is ignored
+	 */
+	template <class Type>
+	void destroy(Type *object) {
+
+		static_assert(is_base_of<Base, Type>::value, "type is not held by the pool");
+		if(object == nullptr) {
+
+			return;
+		}
+		object->~Type();
+		FreeBlock *block = reinterpret_cast<FreeBlock*>(object);
+		block->next = freeList;
+		freeList = block;
+		liveObjects--;
+	}
+
+	/**
+	 * Gets the number of objects currently alive in the pool.
+	 *
+	 * @return The number of live objects
+	 */
+	size_t getLiveObjects() const {
+
+		return liveObjects;
+	}
+
+	/**
+	 * Gets the number of slabs allocated by the pool.
+	 *
+	 * @return The number of slabs
+	 */
+	size_t getSlabCount() const {
+
+		return slabs.size();
+	}
+
+	/**
+	 * Gets the bytes held by the pool's slabs.
+	 *
+	 * @return The bytes of every slab
+	 */
+	size_t getReservedBytes() const {
+
+		size_t bytes = 0;
+		size_t slabBlocks = minSlabBlocks;
+		for(size_t i = 0; i < slabs.size(); i++) {
+
+			bytes += slabBlocks * alignedBlockSize;
+			if(slabBlocks < maxSlabBlocks) {
+
+				slabBlocks *= 2;
+			}
+		}
+		return bytes;
+	}
+};
+
+#endif
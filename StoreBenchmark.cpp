@@ -0,0 +1,2150 @@
+#include "MovieRentalStore.h"
+#include "GenreTraits.h"
+#include "WorkloadGenerator.h"
+#include "CommandStream.h"
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+// benchmark suite for the movie rental store. generates a synthetic workload (see WorkloadGenerator.h),
+// times the file loaders and individual commands, prints a summary and appends the results as CSV
+// rows to an output file so they can be compared across releases.
+
+// a stream buffer discarding everything written to it; the store's console output is sent here
+// while it is being timed
+class DiscardBuffer : public streambuf {
+
+protected:
+
+	int overflow(int c) {
+
+		return c;
+	}
+
+	streamsize xsputn(const char *, streamsize count) {
+
+		return count;
+	}
+};
+
+// heap allocations made by the calling thread, counted by the replaced "operator new" so a benchmark
+// can check what a path allocates (the operators are not inlined, so the compiler does not pair the
+// "free" of a delete with the "new" expression it sees)
+thread_local long long heapAllocations = 0;
+
+__attribute__((noinline)) void *operator new(size_t size) {
+
+	heapAllocations++;
+	void *block = malloc(size == 0 ? 1 : size);
+	if(block == nullptr) {
+
+		throw bad_alloc();
+	}
+	return block;
+}
+
+__attribute__((noinline)) void operator delete(void *block) noexcept {
+
+	free(block);
+}
+
+__attribute__((noinline)) void operator delete(void *block, size_t) noexcept {
+
+	free(block);
+}
+
+// a single benchmark measurement
+struct BenchmarkResult {
+
+	// name of the measured operation
+	string name;
+
+	// number of items (lines, commands, lookups) processed
+	long long items;
+
+	// wall time spent, in seconds
+	double seconds;
+
+	// free form details (e.g. number of movies accepted into inventory)
+	string note;
+};
+
+// a hardware event counter of the calling thread, read through perf_event_open. counters that
+// cannot be opened (no kernel support or insufficient permission) read as -1.
+class PerfCounter {
+
+private:
+
+	int fd = -1;
+
+public:
+
+	/**
+	 * Opens a counter of a hardware event, stopped.
+	 *
+	 * @param type - The perf event type (e.g. PERF_TYPE_HARDWARE)
+	 * @param config - The event (e.g. PERF_COUNT_HW_CACHE_MISSES)
+	 */
+	PerfCounter(unsigned int type, unsigned long long config) {
+
+		perf_event_attr attributes = {};
+		attributes.size = sizeof(attributes);
+		attributes.type = type;
+		attributes.config = config;
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		fd = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+	}
+
+	~PerfCounter() {
+
+		if(fd >= 0) {
+
+			close(fd);
+		}
+	}
+
+	// resets and starts the counter
+	void start() {
+
+		if(fd >= 0) {
+
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	/**
+	 * Stops the counter and reads it.
+	 *
+	 * @return The number of events since "start", -1 if the counter is unavailable
+	 */
+	long long stop() {
+
+		long long count = -1;
+		if(fd < 0) {
+
+			return count;
+		}
+		ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		if(read(fd, &count, sizeof(count)) != sizeof(count)) {
+
+			return -1;
+		}
+		return count;
+	}
+};
+
+// settings of a benchmark run that are not workload settings
+struct BenchmarkSettings {
+
+	string dataDirectory = "benchmark_data";
+	string outputFile = "benchmark_results.csv";
+	string label = "unlabeled";
+	string orderingName = "balanced";
+
+	// number of movies in the catalog the movie classes are measured on (0 skips the measurement)
+	int catalogSize = 0;
+};
+
+/**
+  * Prints the command line usage of the benchmark.
+  */
+void printUsage() {
+
+	cout << "Usage: StoreBenchmark [--movies N] [--customers N] [--commands N] [--ordering random|sorted|balanced]" << endl;
+	cout << "                      [--genre-mix comedy,drama,classics] [--zipf S] [--seed N] [--data-dir DIR]" << endl;
+	cout << "                      [--output FILE] [--label NAME] [--catalog N]" << endl;
+}
+
+/**
+  * Parses the command line arguments into workload and benchmark settings.
+  *
+  * @return Whether every argument was recognized
+  */
+bool parseArguments(int argc, char *argv[], WorkloadSettings &workload, BenchmarkSettings &benchmark) {
+
+	for(int i = 1; i < argc; i += 2) {
+
+		string option = argv[i];
+		if(i + 1 >= argc) {
+
+			return false;
+		}
+		string value = argv[i + 1];
+		if(option == "--movies") {
+
+			workload.movieCount = stoi(value);
+		}
+		else if(option == "--customers") {
+
+			workload.customerCount = stoi(value);
+		}
+		else if(option == "--commands") {
+
+			workload.commandCount = stoi(value);
+		}
+		else if(option == "--ordering") {
+
+			if(!WorkloadGenerator::parseOrdering(value, workload.ordering)) {
+
+				return false;
+			}
+			benchmark.orderingName = value;
+		}
+		else if(option == "--genre-mix") {
+
+			if(sscanf(value.c_str(), "%lf,%lf,%lf", &workload.comedyWeight, &workload.dramaWeight, &workload.classicsWeight) != 3) {
+
+				return false;
+			}
+		}
+		else if(option == "--zipf") {
+
+			workload.zipfExponent = stod(value);
+		}
+		else if(option == "--seed") {
+
+			workload.seed = stoul(value);
+		}
+		else if(option == "--data-dir") {
+
+			benchmark.dataDirectory = value;
+		}
+		else if(option == "--output") {
+
+			benchmark.outputFile = value;
+		}
+		else if(option == "--label") {
+
+			benchmark.label = value;
+		}
+		else if(option == "--catalog") {
+
+			benchmark.catalogSize = stoi(value);
+		}
+		else {
+
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * Reads every line of a file.
+  *
+  * @param path - The directory of the file
+  *
+  * @return The lines of the file
+  */
+vector<string> readLines(string path) {
+
+	vector<string> lines;
+	ifstream readFile(path);
+	string line;
+	while(getline(readFile, line)) {
+
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+// the checks failed during the run (see "check"); the run exits with a failing status if any did
+int failedChecks = 0;
+
+/**
+  * Records a check of a benchmark's results against a reference (e.g. an export read back, or the
+  * parsing a faster path replaces): a failed check is reported on standard error, which the store's
+  * console output is not sent to, and fails the run once the results are written.
+  *
+  * @param passed - Whether the check passed
+  * @param description - What was checked, reported if it failed
+  */
+void check(bool passed, string description) {
+
+	if(!passed) {
+
+		failedChecks++;
+		cerr << "Check failed: " << description << endl;
+	}
+}
+
+/**
+  * Gets the number of seconds elapsed since a start time.
+  *
+  * @param start - The start time
+  *
+  * @return The elapsed seconds
+  */
+double secondsSince(steady_clock::time_point start) {
+
+	return duration_cast<duration<double>>(steady_clock::now() - start).count();
+}
+
+/**
+  * Appends the results as CSV rows to the output file, writing the header row if the file is new.
+  *
+  * @return Whether the rows were written
+  */
+bool writeResults(vector<BenchmarkResult> &results, WorkloadSettings &workload, BenchmarkSettings &benchmark) {
+
+	ifstream existing(benchmark.outputFile);
+	bool writeHeader = !existing || existing.peek() == ifstream::traits_type::eof();
+	existing.close();
+	ofstream writeFile(benchmark.outputFile, ios::app);
+	if(!writeFile) {
+
+		return false;
+	}
+	if(writeHeader) {
+
+		writeFile << "label,timestamp,benchmark,movies,customers,commands,ordering,zipf,items,seconds,ns_per_item,items_per_second,note\n";
+	}
+	long long timestamp = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+	for(size_t i = 0; i < results.size(); i++) {
+
+		BenchmarkResult &result = results[i];
+		double nsPerItem = result.items > 0 ? result.seconds * 1e9 / result.items : 0;
+		double itemsPerSecond = result.seconds > 0 ? result.items / result.seconds : 0;
+		writeFile << benchmark.label << "," << timestamp << "," << result.name << "," << workload.movieCount << ","
+			<< workload.customerCount << "," << workload.commandCount << "," << benchmark.orderingName << ","
+			<< workload.zipfExponent << "," << result.items << "," << result.seconds << "," << nsPerItem << ","
+			<< itemsPerSecond << "," << result.note << "\n";
+	}
+	return (bool) writeFile;
+}
+
+/**
+  * Gets the number of movies held by all genre inventories of a store.
+  *
+  * @param store - The store
+  *
+  * @return The number of movies in inventory
+  */
+int inventorySize(MovieRentalStore &store) {
+
+	return store.comedyMovieInventory.getSize() + store.dramaMovieInventory.getSize() + store.classicsMovieInventory.getSize();
+}
+
+/**
+  * Builds the movies of a generated catalog, split by genre.
+  *
+  * @param movies - The generated catalog
+  * @param comedies - The comedies, appended to
+  * @param dramas - The dramas, appended to
+  * @param classics - The classics, appended to
+  */
+void buildMovies(const vector<GeneratedMovie> &movies, vector<Comedy> &comedies, vector<Drama> &dramas, vector<Classics> &classics) {
+
+	for(size_t i = 0; i < movies.size(); i++) {
+
+		const GeneratedMovie &movie = movies[i];
+		if(movie.genre == 'F') {
+
+			comedies.emplace_back(movie.releaseYear, movie.title, movie.director, 10);
+		}
+		else if(movie.genre == 'D') {
+
+			dramas.emplace_back(movie.director, movie.title, movie.releaseYear, 10);
+		}
+		else {
+
+			classics.emplace_back(movie.releaseYear, movie.releaseMonth, movie.majorActor, movie.director, movie.title, 10);
+		}
+	}
+}
+
+/**
+  * Measures lookups and stock updates on one genre inventory: every operation borrows and returns a
+  * random movie of the genre (two searches and two stock changes). Cache misses and L1 data cache
+  * misses are read from the hardware counters when available.
+  *
+  * @param name - The name of the result
+  * @param movies - The movies of the genre, inserted in order
+  * @param operations - The number of borrow/return pairs
+  * @param seed - The random seed
+  *
+  * @return The measurement
+  */
+template <typename Tree, typename MovieType>
+BenchmarkResult benchmarkStockUpdates(string name, vector<MovieType> &movies, long long operations, unsigned int seed) {
+
+	Tree tree;
+	for(size_t i = 0; i < movies.size(); i++) {
+
+		tree.Insert(movies[i]);
+	}
+	mt19937_64 random(seed);
+	vector<int> picks(operations);
+	for(long long i = 0; i < operations; i++) {
+
+		picks[i] = random() % movies.size();
+	}
+	PerfCounter cacheMisses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	PerfCounter dataCacheMisses(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+	long long changed = 0;
+	cacheMisses.start();
+	dataCacheMisses.start();
+	steady_clock::time_point start = steady_clock::now();
+	for(long long i = 0; i < operations; i++) {
+
+		MovieType &movie = movies[picks[i]];
+		changed += tree.changeMediaStock(movie, false) >= 0;
+		changed += tree.changeMediaStock(movie, true) >= 0;
+	}
+	double seconds = secondsSince(start);
+	long long misses = dataCacheMisses.stop();
+	long long llcMisses = cacheMisses.stop();
+	string note = "changed=" + to_string(changed) + " inventory=" + to_string(tree.getSize());
+	note += misses < 0 ? " perf=unavailable" : " l1d_misses/op=" + to_string((double) misses / operations)
+		+ " cache_misses/op=" + to_string((double) llcMisses / operations);
+	return {name, operations, seconds, note};
+}
+
+/**
+  * Measures lookups and stock updates on every genre inventory, with the object and the column
+  * storage layouts.
+  *
+  * @param movies - The generated catalog
+  * @param seed - The random seed
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkInventoryStorage(const vector<GeneratedMovie> &movies, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	vector<Comedy> comedies;
+	vector<Drama> dramas;
+	vector<Classics> classics;
+	buildMovies(movies, comedies, dramas, classics);
+	const long long operations = 2000000;
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Comedy, ObjectStorage<Comedy>>>("stock_objects_F", comedies, operations, seed));
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Comedy, ColumnStorage<Comedy>>>("stock_columns_F", comedies, operations, seed));
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Drama, ObjectStorage<Drama>>>("stock_objects_D", dramas, operations, seed));
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Drama, ColumnStorage<Drama>>>("stock_columns_D", dramas, operations, seed));
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Classics, ObjectStorage<Classics>>>("stock_objects_C", classics, operations, seed));
+	results.push_back(benchmarkStockUpdates<ArrayBasedBSTree<Classics, ColumnStorage<Classics>>>("stock_columns_C", classics, operations, seed));
+}
+
+/**
+  * Measures the availability index (counts of titles in stock per subtree) of a comedy inventory. Borrow/return pairs (a decrement and an
+  * increment of a random title's stock) are timed with the index turned off and on: with one copy
+  * per title every pair takes the title out of stock and back, the worst case for the index, and
+  * with ten copies no pair does. Then half the titles are taken out of stock, and queries for the
+  * titles in stock starting with the first six characters of a random title are timed by traversing the
+  * tree and through the index; every indexed query doubles as a check that it lists the same titles
+  * as the traversal.
+  *
+  * @param movies - The generated catalog, whose comedies are measured
+  * @param seed - The random seed
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkAvailability(const vector<GeneratedMovie> &movies, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	vector<Comedy> comedies;
+	vector<Drama> dramas;
+	vector<Classics> classics;
+	buildMovies(movies, comedies, dramas, classics);
+	if(comedies.empty()) {
+
+		return;
+	}
+	const long long operations = 1000000;
+	const int queries = 2000;
+	const size_t prefixLength = 6;
+	mt19937_64 random(seed);
+	vector<int> picks(operations);
+	for(long long i = 0; i < operations; i++) {
+
+		picks[i] = random() % comedies.size();
+	}
+	for(int copies : {1, 10}) {
+
+		for(bool tracking : {false, true}) {
+
+			ArrayBasedBSTree<Comedy> tree;
+			tree.setAvailabilityTracking(tracking);
+			for(size_t i = 0; i < comedies.size(); i++) {
+
+				tree.Insert(comedies[i], &copies);
+			}
+			long long changed = 0;
+			steady_clock::time_point start = steady_clock::now();
+			for(long long i = 0; i < operations; i++) {
+
+				changed += tree.changeMediaStock(comedies[picks[i]], false) >= 0;
+				changed += tree.changeMediaStock(comedies[picks[i]], true) >= 0;
+			}
+			results.push_back({"avail_stock" + to_string(copies) + (tracking ? "_on" : "_off"), operations, secondsSince(start),
+				"changed=" + to_string(changed) + " in_stock=" + to_string(tree.countInStock())});
+		}
+	}
+
+	// queries over a tree with every other title out of stock, the prefixes drawn from the titles
+	int copies = 1;
+	ArrayBasedBSTree<Comedy> tree;
+	for(size_t i = 0; i < comedies.size(); i++) {
+
+		tree.Insert(comedies[i], &copies);
+	}
+	for(size_t i = 0; i < comedies.size(); i += 2) {
+
+		tree.changeMediaStock(comedies[i], false);
+	}
+	vector<SortKeyRange> ranges(queries);
+	for(int i = 0; i < queries; i++) {
+
+		ranges[i].lastNumber = 0;
+		ranges[i].textPrefix = string(comedies[random() % comedies.size()].getTitle()).substr(0, prefixLength);
+	}
+	vector<vector<string>> traversed(queries);
+	tree.setAvailabilityTracking(false);
+	steady_clock::time_point start = steady_clock::now();
+	for(int i = 0; i < queries; i++) {
+
+		tree.forEachInStock(ranges[i], [&](const Comedy &movie) { traversed[i].push_back(movie.getSortingCriteria()); });
+	}
+	results.push_back({"avail_query_scan", queries, secondsSince(start), "titles=" + to_string(tree.getSize())});
+	tree.setAvailabilityTracking(true);
+	long long listed = 0;
+	long long mismatches = 0;
+	start = steady_clock::now();
+	for(int i = 0; i < queries; i++) {
+
+		vector<string> indexed;
+		listed += tree.forEachInStock(ranges[i], [&](const Comedy &movie) { indexed.push_back(movie.getSortingCriteria()); });
+		mismatches += indexed != traversed[i];
+	}
+	results.push_back({"avail_query_index", queries, secondsSince(start), "in_stock=" + to_string(tree.countInStock()) + " listed="
+		+ to_string(listed) + " mismatches=" + to_string(mismatches) + " index_bytes=" + to_string(tree.getAvailabilityBytes())});
+}
+
+/**
+  * Measures a comedy inventory under churn: every round retires titles and adds new ones at the
+  * same rate, so the number of titles stays steady while the tree is reshaped by removals. At
+  * checkpoints the lookup latency over the titles present (a borrow and a return of each) and the
+  * inventory's memory are recorded; the lookups double as a check that no title present was lost.
+  * Finally most titles are retired, and the array is expected to shrink.
+  *
+  * @param movies - The generated catalog, whose comedies are the pool of titles
+  * @param seed - The random seed
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkChurn(const vector<GeneratedMovie> &movies, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	vector<Comedy> comedies;
+	vector<Drama> dramas;
+	vector<Classics> classics;
+	buildMovies(movies, comedies, dramas, classics);
+	mt19937_64 random(seed);
+	shuffle(comedies.begin(), comedies.end(), random);
+	const size_t steadyTitles = comedies.size() / 3;
+	const size_t titlesPerRound = steadyTitles / 4;
+	const int rounds = 20;
+	const int checkpointRounds = 4;
+	const int lookupPasses = 50;
+	long long baseBytes = MemoryAccounting::getAccount(MemorySubsystem::Inventory).liveBytes;
+
+	// titles in the tree are the first "present" of the pool, retired titles are swapped past them
+	ArrayBasedBSTree<Comedy> tree;
+	size_t present = 0;
+	long long failedInserts = 0;
+	for(; present < steadyTitles; present++) {
+
+		failedInserts += !tree.Insert(comedies[present]);
+	}
+	for(int round = 1; round <= rounds; round++) {
+
+		for(size_t i = 0; i < titlesPerRound; i++) {
+
+			size_t retired = random() % present;
+			tree.Remove(comedies[retired]);
+			swap(comedies[retired], comedies[present - 1]);
+			size_t added = present + random() % (comedies.size() - present);
+			swap(comedies[present - 1], comedies[added]);
+			failedInserts += !tree.Insert(comedies[present - 1]);
+		}
+		if(round % checkpointRounds != 0) {
+
+			continue;
+		}
+		long long lookups = 0;
+		long long missing = 0;
+		steady_clock::time_point start = steady_clock::now();
+		for(int pass = 0; pass < lookupPasses; pass++) {
+
+			for(size_t i = 0; i < present; i++) {
+
+				missing += tree.changeMediaStock(comedies[i], false) < 0;
+				tree.changeMediaStock(comedies[i], true);
+				lookups += 2;
+			}
+		}
+		double seconds = secondsSince(start);
+		results.push_back({"churn_round" + to_string(round), lookups, seconds, "titles=" + to_string(tree.getSize()) + " capacity="
+			+ to_string(tree.getCapacity()) + " inventory_bytes=" + to_string(MemoryAccounting::getAccount(MemorySubsystem::Inventory).liveBytes - baseBytes)
+			+ " failed_inserts=" + to_string(failedInserts) + " missing=" + to_string(missing)});
+	}
+
+	// retire all but a few titles: the array is compacted along the way
+	int capacityBefore = tree.getCapacity();
+	steady_clock::time_point start = steady_clock::now();
+	long long removals = 0;
+	while(present > steadyTitles / 10) {
+
+		removals += tree.Remove(comedies[--present]);
+	}
+	results.push_back({"churn_drain", removals, secondsSince(start), "titles=" + to_string(tree.getSize()) + " capacity="
+		+ to_string(capacityBefore) + "->" + to_string(tree.getCapacity()) + " inventory_bytes="
+		+ to_string(MemoryAccounting::getAccount(MemorySubsystem::Inventory).liveBytes - baseBytes)});
+}
+
+/**
+  * Measures borrow and return commands as the number of media formats carried grows. For each
+  * format count a workload is generated whose movies are stocked in every format and whose rentals
+  * are of random formats, loaded into a store configured with those formats, and its borrow and
+  * return commands are timed one by one. The command streams only differ by their format codes, and
+  * the stock of a title is split evenly between its formats so every run carries the same copies.
+  *
+  * @param workload - The workload settings
+  * @param dataDirectory - The directory the workload and configuration files are written to
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkFormats(WorkloadSettings workload, string dataDirectory, vector<BenchmarkResult> &results) {
+
+	const string formatCodes = "DBKVEGHJ";
+	const int stockPerTitle = workload.stockPerMovie * formatCodes.size();
+	for(size_t formatCount = 1; formatCount <= formatCodes.size(); formatCount *= 2) {
+
+		workload.formatCodes = formatCodes.substr(0, formatCount);
+		workload.stockPerMovie = stockPerTitle / formatCount;
+		string prefix = dataDirectory + "/formats" + to_string(formatCount) + "_";
+		WorkloadGenerator generator(workload);
+		ofstream configFile(prefix + "config.txt");
+		for(size_t format = 0; format < formatCount; format++) {
+
+			configFile << "format " << formatCodes[format] << " format" << format << "\n";
+		}
+		configFile.close();
+		if(!generator.writeMovieFile(prefix + "movies.txt") || !generator.writeCustomerFile(prefix + "customers.txt")
+			|| !generator.writeCommandFile(prefix + "commands.txt")) {
+
+			continue;
+		}
+		MovieRentalStore store;
+		store.loadCatalogConfig(prefix + "config.txt");
+		store.scanMovieFile(prefix + "movies.txt");
+		store.scanCustomerFile(prefix + "customers.txt");
+		vector<string> commands = readLines(prefix + "commands.txt");
+		long long borrows = 0;
+		long long returns = 0;
+		double borrowSeconds = 0;
+		double returnSeconds = 0;
+		for(size_t i = 0; i < commands.size(); i++) {
+
+			steady_clock::time_point start = steady_clock::now();
+			store.executeCommand(commands[i]);
+			double seconds = secondsSince(start);
+			if(commands[i][0] == 'B') {
+
+				borrows++;
+				borrowSeconds += seconds;
+			}
+			else if(commands[i][0] == 'R') {
+
+				returns++;
+				returnSeconds += seconds;
+			}
+		}
+		string note = "formats=" + workload.formatCodes + " inventory_bytes=" + to_string(MemoryAccounting::getAccount(MemorySubsystem::Inventory).liveBytes);
+		results.push_back({"formats" + to_string(formatCount) + "_borrow", borrows, borrowSeconds, note});
+		results.push_back({"formats" + to_string(formatCount) + "_return", returns, returnSeconds, ""});
+	}
+}
+
+/**
+  * Measures movie delta files applied to live stores of growing catalogs. Each round applies a
+  * batch retiring and restocking the same number of titles, then a batch adding the retired titles
+  * back, so every catalog is measured with deltas of the same size; the time per delta line is
+  * expected to stay flat as the catalog grows.
+  *
+  * @param workload - The workload settings; the catalogs use its genre mix and seed
+  * @param dataDirectory - The directory the catalogs and delta files are written to
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkDelta(WorkloadSettings workload, string dataDirectory, vector<BenchmarkResult> &results) {
+
+	const int catalogSizes[] = {300, 1200};
+	const size_t titlesPerBatch = 25;
+	const int rounds = 20;
+	workload.customerCount = 0;
+	for(int catalogSize : catalogSizes) {
+
+		workload.movieCount = catalogSize;
+		string prefix = dataDirectory + "/delta" + to_string(catalogSize) + "_";
+		WorkloadGenerator generator(workload);
+		if(!generator.writeMovieFile(prefix + "movies.txt")) {
+
+			continue;
+		}
+		vector<string> movieLines = readLines(prefix + "movies.txt");
+		mt19937_64 random(workload.seed);
+		shuffle(movieLines.begin(), movieLines.end(), random);
+		ofstream retireFile(prefix + "retire.txt");
+		ofstream addFile(prefix + "add.txt");
+		for(size_t i = 0; i < titlesPerBatch && 2 * i + 1 < movieLines.size(); i++) {
+
+			retireFile << "- " << movieLines[2 * i] << "\n" << "= " << movieLines[2 * i + 1] << "\n";
+			addFile << "+ " << movieLines[2 * i] << "\n";
+		}
+		retireFile.close();
+		addFile.close();
+		MovieRentalStore store;
+		store.scanMovieFile(prefix + "movies.txt");
+		int titles = inventorySize(store);
+		steady_clock::time_point start = steady_clock::now();
+		for(int round = 0; round < rounds; round++) {
+
+			store.applyMovieDelta(prefix + "retire.txt");
+			store.applyMovieDelta(prefix + "add.txt");
+		}
+		results.push_back({"delta" + to_string(catalogSize), (long long) rounds * titlesPerBatch * 3, secondsSince(start),
+			"titles=" + to_string(titles) + "->" + to_string(inventorySize(store))});
+	}
+}
+
+/**
+  * Adds the titles of one genre to a title search index.
+  *
+  * @param index - The index
+  * @param movies - The movies of the genre
+  */
+template <typename MovieType>
+void indexTitles(TitleSearchIndex &index, const vector<MovieType> &movies) {
+
+	for(size_t i = 0; i < movies.size(); i++) {
+
+		index.add(getMovieCommand(movies[i]), GenreTraits<MovieType>::getSearchText(movies[i]));
+	}
+}
+
+/**
+  * Gets the sorting criteria of a random movie, as a clerk might mistype it: lowercased, with one
+  * character dropped.
+  *
+  * @param movies - The movies of a genre (not empty)
+  * @param random - The random generator
+  * @param command - The borrow command portion naming the movie, assigned
+  *
+  * @return The mistyped sorting criteria
+  */
+template <typename MovieType>
+string mistypeTitle(const vector<MovieType> &movies, mt19937_64 &random, string &command) {
+
+	const MovieType &movie = movies[random() % movies.size()];
+	command = getMovieCommand(movie);
+	string query = TitleSearchIndex::normalize(movie.getSortingCriteria());
+	query.erase(random() % query.size(), 1);
+	return query;
+}
+
+/**
+  * Measures the title search index: the time and bytes to index every title, and the time of a
+  * search for the closest titles to a mistyped title. Every search doubles as a check that the
+  * mistyped title is among the titles returned ("recall").
+  *
+  * @param comedies - The comedies indexed
+  * @param dramas - The dramas indexed
+  * @param classics - The classics indexed
+  * @param seed - The random seed
+  * @param suffix - Appended to the names of the results
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkTitleSearch(const vector<Comedy> &comedies, const vector<Drama> &dramas, const vector<Classics> &classics, unsigned int seed,
+	string suffix, vector<BenchmarkResult> &results) {
+
+	const int searches = 2000;
+	const size_t count = 5;
+	TitleSearchIndex index;
+	steady_clock::time_point start = steady_clock::now();
+	indexTitles(index, comedies);
+	indexTitles(index, dramas);
+	indexTitles(index, classics);
+	double seconds = secondsSince(start);
+	long long titles = comedies.size() + dramas.size() + classics.size();
+	results.push_back({"titleIndexBuild" + suffix, titles, seconds, "titles=" + to_string(index.getSize()) + " bytes_per_title="
+		+ to_string(titles == 0 ? 0 : index.getBytes() / titles)});
+
+	// the queries are drawn before the timed loop
+	mt19937_64 random(seed);
+	vector<string> queries;
+	vector<string> commands;
+	for(int i = 0; i < searches && titles > 0; i++) {
+
+		string command;
+		size_t pick = random() % titles;
+		if(pick < comedies.size()) {
+
+			queries.push_back(mistypeTitle(comedies, random, command));
+		}
+		else if(pick < comedies.size() + dramas.size()) {
+
+			queries.push_back(mistypeTitle(dramas, random, command));
+		}
+		else {
+
+			queries.push_back(mistypeTitle(classics, random, command));
+		}
+		commands.push_back(command);
+	}
+	long long found = 0;
+	double slowest = 0;
+	start = steady_clock::now();
+	for(size_t i = 0; i < queries.size(); i++) {
+
+		steady_clock::time_point searchStart = steady_clock::now();
+		vector<TitleSearchIndex::Match> matches = index.search(queries[i], count);
+		slowest = max(slowest, secondsSince(searchStart));
+		for(size_t j = 0; j < matches.size(); j++) {
+
+			found += matches[j].command == commands[i];
+		}
+	}
+	results.push_back({"titleSearch" + suffix, (long long) queries.size(), secondsSince(start), "recall=" + to_string(found) + "/"
+		+ to_string(queries.size()) + " slowest_us=" + to_string((long long) (slowest * 1e6))});
+}
+
+/**
+  * Measures lookups by director, release year and major actor on a store loaded with the generated
+  * catalog, answered by scanning the inventories and then by secondary indexes. The lookups draw
+  * their values from the catalog; every indexed lookup doubles as a check that it finds the same
+  * titles as the scan.
+  *
+  * @param movies - The generated catalog
+  * @param movieFile - The movie file of the catalog
+  * @param seed - The random seed
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkSecondaryIndexes(const vector<GeneratedMovie> &movies, string movieFile, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	const int lookups = 2000;
+	const int attributes[] = {SecondaryIndexes::Director, SecondaryIndexes::ReleaseYear, SecondaryIndexes::Actor};
+	MovieRentalStore store;
+	store.scanMovieFile(movieFile);
+	for(int attribute : attributes) {
+
+		// the values looked up are drawn before the timed loops (actors from classics alone)
+		mt19937_64 random(seed + attribute);
+		vector<string> values;
+		for(int i = 0; i < lookups && !movies.empty(); i++) {
+
+			const GeneratedMovie &movie = movies[random() % movies.size()];
+			if(attribute == SecondaryIndexes::Director) {
+
+				values.push_back(movie.director);
+			}
+			else if(attribute == SecondaryIndexes::ReleaseYear) {
+
+				values.push_back(to_string(movie.releaseYear));
+			}
+			else if(movie.majorActor != "") {
+
+				values.push_back(movie.majorActor);
+			}
+		}
+		string name = SecondaryIndexes::getAttributeName(attribute);
+		vector<vector<string>> scanned;
+		steady_clock::time_point start = steady_clock::now();
+		for(size_t i = 0; i < values.size(); i++) {
+
+			scanned.push_back(store.findMovies(attribute, values[i]));
+		}
+		results.push_back({name + "LookupScan", (long long) values.size(), secondsSince(start), ""});
+
+		start = steady_clock::now();
+		store.enableSecondaryIndexes(name);
+		double buildSeconds = secondsSince(start);
+		long long titles = 0;
+		long long mismatches = 0;
+		start = steady_clock::now();
+		for(size_t i = 0; i < values.size(); i++) {
+
+			vector<string> found = store.findMovies(attribute, values[i]);
+			titles += found.size();
+			mismatches += found != scanned[i];
+		}
+		results.push_back({name + "LookupIndex", (long long) values.size(), secondsSince(start), "titles_found=" + to_string(titles)
+			+ " mismatches=" + to_string(mismatches) + " build_us=" + to_string((long long) (buildSeconds * 1e6)) + " index_bytes="
+			+ to_string(store.secondaryIndexes.getBytes(attribute))});
+	}
+}
+
+/**
+  * Measures waitlists of hot titles. First the queues alone: customers join the queues of a few
+  * titles, 10000 per title, then leave them; the order they leave in doubles as a check that the
+  * queues are first come first served. Then a store: every copy of a comedy is borrowed, 10000
+  * borrow-or-wait commands queue customers for it, and the copies are returned one after another,
+  * each return lending its copy to the next customer waiting (who returns it in turn).
+  *
+  * @param movies - The generated catalog
+  * @param movieFile - The movie file of the catalog
+  * @param customerFile - The customer file
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkWaitlists(const vector<GeneratedMovie> &movies, string movieFile, string customerFile, vector<BenchmarkResult> &results) {
+
+	const int hotTitles = 8;
+	const int waitersPerTitle = 10000;
+	Waitlists queues;
+	steady_clock::time_point start = steady_clock::now();
+	for(int i = 0; i < waitersPerTitle; i++) {
+
+		for(int title = 0; title < hotTitles; title++) {
+
+			queues.enqueue("D F Hot Title " + to_string(title) + ", 2000", i);
+		}
+	}
+	double seconds = secondsSince(start);
+	size_t bytes = queues.getBytes();
+	results.push_back({"waitlistEnqueue", (long long) hotTitles * waitersPerTitle, seconds, "titles=" + to_string(queues.getTitleCount())
+		+ " bytes_per_waiter=" + to_string(bytes / queues.getWaiterCount())});
+	long long outOfOrder = 0;
+	start = steady_clock::now();
+	for(int i = 0; i < waitersPerTitle; i++) {
+
+		for(int title = 0; title < hotTitles; title++) {
+
+			outOfOrder += queues.dequeue("D F Hot Title " + to_string(title) + ", 2000") != i;
+		}
+	}
+	results.push_back({"waitlistDequeue", (long long) hotTitles * waitersPerTitle, secondsSince(start), "out_of_order="
+		+ to_string(outOfOrder) + " titles_left=" + to_string(queues.getTitleCount())});
+
+	// a store whose hot comedy is borrowed out, then waited for
+	vector<int> customerIDs;
+	vector<string> customerLines = readLines(customerFile);
+	for(size_t i = 0; i < customerLines.size(); i++) {
+
+		customerIDs.push_back(stoi(customerLines[i]));
+	}
+	vector<Comedy> comedies;
+	vector<Drama> dramas;
+	vector<Classics> classics;
+	buildMovies(movies, comedies, dramas, classics);
+	if(comedies.empty() || customerIDs.empty()) {
+
+		return;
+	}
+	MovieRentalStore store;
+	store.scanMovieFile(movieFile);
+	store.scanCustomerFile(customerFile);
+	string title = getMovieCommand(comedies[0]);
+	vector<int> holders;
+	for(size_t i = 0; i < customerIDs.size() && store.comedyMovieInventory.getStock(comedies[0]) > 0; i++) {
+
+		store.executeCommand("B " + to_string(customerIDs[i]) + " D " + title);
+		holders.push_back(customerIDs[i]);
+	}
+	start = steady_clock::now();
+	for(int i = 0; i < waitersPerTitle; i++) {
+
+		int custID = customerIDs[(holders.size() + i) % customerIDs.size()];
+		store.executeCommand("W " + to_string(custID) + " D " + title);
+	}
+	seconds = secondsSince(start);
+	size_t waiting = store.waitlists.getWaiterCount();
+	results.push_back({"waitlistWait", waitersPerTitle, seconds, "waiting=" + to_string(waiting) + " waitlist_bytes="
+		+ to_string(store.waitlists.getBytes())});
+	start = steady_clock::now();
+	for(int i = 0; i < waitersPerTitle; i++) {
+
+		// the waiter served by return i - holders, who borrowed after the holders, returns the copy
+		int custID = i < (int) holders.size() ? holders[i] : customerIDs[i % customerIDs.size()];
+		store.executeCommand("R " + to_string(custID) + " D " + title);
+	}
+	results.push_back({"waitlistReturn", waitersPerTitle, secondsSince(start), "served=" + to_string(waiting - store.waitlists.getWaiterCount())
+		+ " still_waiting=" + to_string(store.waitlists.getWaiterCount())});
+}
+
+/**
+  * Measures the due dates of 5 million open rentals over 10 days. Every rental is due 3 days after
+  * its borrow and returned 1 to 4.5 days after it (a third of them late), the copy being borrowed
+  * again at once, so 5 million stay open. Every hour the rentals overdue are found twice: by
+  * advancing the due dates to the hour (which looks at the rentals expiring only) and by scanning
+  * every rental open. Both counts must match.
+  *
+  * @param seed - The seed of the borrow and return times
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkDueDates(unsigned int seed, vector<BenchmarkResult> &results) {
+
+	const size_t rentals = 5000000;
+	const int hours = 10 * 24;
+	const long long hour = 3600;
+	const long long loanPeriod = 3 * DueDates::secondsPerDay;
+	const long long startTime = 1000 * DueDates::secondsPerDay;
+	mt19937_64 random(seed);
+
+	// the time a copy borrowed at the time argument is returned
+	auto getReturnTime = [&](long long borrowTime) {
+
+		return borrowTime + DueDates::secondsPerDay + (long long) (random() % (7 * DueDates::secondsPerDay / 2));
+	};
+
+	// the rentals are named by the addresses of a buffer (standing in for borrowed movie records);
+	// the rentals returned in every hour of the run
+	vector<char> copies(rentals);
+	vector<long long> dueTimes(rentals);
+	vector<vector<uint32_t>> returnsByHour(hours);
+	auto scheduleReturn = [&](uint32_t rental, long long returnTime) {
+
+		long long returnHour = (returnTime - startTime) / hour;
+		if(returnHour < hours) {
+
+			returnsByHour[returnHour].push_back(rental);
+		}
+	};
+	DueDates dueDates;
+	steady_clock::time_point start = steady_clock::now();
+	for(size_t i = 0; i < rentals; i++) {
+
+		long long borrowTime = startTime - (long long) (random() % (7 * DueDates::secondsPerDay / 2));
+		dueTimes[i] = borrowTime + loanPeriod;
+		dueDates.add((const Movie*) &copies[i], i % 5000, borrowTime, dueTimes[i]);
+	}
+	results.push_back({"dueDatesOpen", (long long) rentals, secondsSince(start), "bytes_per_rental=" + to_string(dueDates.getBytes() / rentals)});
+	for(size_t i = 0; i < rentals; i++) {
+
+		scheduleReturn(i, max(getReturnTime(dueTimes[i] - loanPeriod), startTime));
+	}
+	double churnSeconds = 0;
+	double advanceSeconds = 0;
+	double scanSeconds = 0;
+	long long returned = 0;
+	long long expired = 0;
+	long long mismatches = 0;
+	DueDates::Rental closed;
+	for(int elapsed = 1; elapsed <= hours; elapsed++) {
+
+		long long now = startTime + elapsed * hour;
+		start = steady_clock::now();
+		for(uint32_t rental : returnsByHour[elapsed - 1]) {
+
+			mismatches += !dueDates.remove((const Movie*) &copies[rental], closed);
+			dueTimes[rental] = now + loanPeriod;
+			dueDates.add((const Movie*) &copies[rental], rental % 5000, now, dueTimes[rental]);
+		}
+		churnSeconds += secondsSince(start);
+		returned += returnsByHour[elapsed - 1].size();
+		for(uint32_t rental : returnsByHour[elapsed - 1]) {
+
+			scheduleReturn(rental, getReturnTime(now));
+		}
+		vector<uint32_t>().swap(returnsByHour[elapsed - 1]);
+		start = steady_clock::now();
+		expired += dueDates.advance(now);
+		advanceSeconds += secondsSince(start);
+		start = steady_clock::now();
+		size_t scanned = 0;
+		for(size_t i = 0; i < rentals; i++) {
+
+			scanned += dueTimes[i] < now;
+		}
+		scanSeconds += secondsSince(start);
+		mismatches += scanned != dueDates.getOverdueCount();
+	}
+	results.push_back({"dueDatesChurn", 2 * returned, churnSeconds, "open=" + to_string(dueDates.getOpenCount())});
+	results.push_back({"dueDatesAdvance", hours, advanceSeconds, "expired=" + to_string(expired) + " overdue=" + to_string(dueDates.getOverdueCount())
+		+ " mismatches=" + to_string(mismatches)});
+	results.push_back({"dueDatesScan", hours, scanSeconds, "rentals_scanned=" + to_string(rentals * hours)});
+}
+
+/**
+  * Measures the store clocks: the cost of reading each, then the command file replayed on a
+  * simulated clock, moved a minute forward every 10 commands by "T"/Time commands and queried for
+  * overdue rentals every 1000. The replay runs twice; both outputs must be identical, and the
+  * simulated time covered is reported beside the time the replay took.
+  *
+  * @param movieFile - The movie file of the catalog
+  * @param customerFile - The customer file
+  * @param commandFile - The command file replayed
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkClocks(string movieFile, string customerFile, string commandFile, vector<BenchmarkResult> &results) {
+
+	const long long reads = 10000000;
+	for(const char *name : {"system", "monotonic", "simulated"}) {
+
+		StoreClock *clock = StoreClock::create(name);
+		long long sum = 0;
+		steady_clock::time_point start = steady_clock::now();
+		for(long long i = 0; i < reads; i++) {
+
+			sum += clock->now();
+		}
+		results.push_back({string("clockRead_") + name, reads, secondsSince(start), "checksum=" + to_string(sum % 1000)});
+		delete clock;
+	}
+	vector<string> commands = readLines(commandFile);
+	vector<string> timedCommands;
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		if(i % 10 == 0) {
+
+			timedCommands.push_back("T +60");
+		}
+		if(i % 1000 == 999) {
+
+			timedCommands.push_back("O");
+		}
+		timedCommands.push_back(commands[i]);
+	}
+	string outputs[2];
+	double seconds = 0;
+	long long simulatedSeconds = 0;
+	for(string &output : outputs) {
+
+		SimulatedClock clock(StoreClock::parseTime("2024-01-01"));
+		MovieRentalStore store;
+		store.setClock(&clock);
+		store.scanMovieFile(movieFile);
+		store.scanCustomerFile(customerFile);
+		ostringstream captured;
+		streambuf *previousOutput = cout.rdbuf(captured.rdbuf());
+		steady_clock::time_point start = steady_clock::now();
+		for(size_t i = 0; i < timedCommands.size(); i++) {
+
+			store.executeCommand(timedCommands[i]);
+		}
+		seconds = secondsSince(start);
+		cout.rdbuf(previousOutput);
+		output = captured.str();
+		simulatedSeconds = clock.now() - StoreClock::parseTime("2024-01-01");
+	}
+	results.push_back({"clockReplay", (long long) timedCommands.size(), seconds, "simulated_seconds=" + to_string(simulatedSeconds) + " identical_output="
+		+ to_string(outputs[0] == outputs[1]) + " output_bytes=" + to_string(outputs[0].size())});
+}
+
+/**
+  * Measures the API of an embedded store: a store constructed empty, loaded through "loadMovies" and
+  * "loadCustomers", executes the command file through "execute". The results are printed back by the
+  * store's text formatter (the commands other than borrow/return by their output) and checked against
+  * the output of the same commands executed by "executeCommand" on a store loaded from the files, then
+  * formatted as JSON lines and binary frames. The heap allocations of the borrows and returns that
+  * succeed are counted through both paths, and those of the formatters.
+  *
+  * @param movieFile - The movie file of the catalog
+  * @param customerFile - The customer file
+  * @param commandFile - The command file
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkEmbeddedApi(string movieFile, string customerFile, string commandFile, vector<BenchmarkResult> &results) {
+
+	vector<string> commands = readLines(commandFile);
+	string expectedOutput;
+	long long succeededBorrowsReturns = 0;
+	long long textAllocations = 0;
+	{
+		MovieRentalStore store;
+		store.scanMovieFile(movieFile);
+		store.scanCustomerFile(customerFile);
+		stringstream commandOutput;
+		streambuf *previousOutput = cout.rdbuf(commandOutput.rdbuf());
+		for(size_t i = 0; i < commands.size(); i++) {
+
+			long long allocations = heapAllocations;
+			bool succeeded = store.executeCommand(commands[i]);
+			if(succeeded && (commands[i][0] == 'B' || commands[i][0] == 'R')) {
+
+				succeededBorrowsReturns++;
+				textAllocations += heapAllocations - allocations;
+			}
+		}
+		cout.rdbuf(previousOutput);
+		expectedOutput = commandOutput.str();
+	}
+	MovieRentalStore store;
+	steady_clock::time_point start = steady_clock::now();
+	bool loaded = store.loadMovies(movieFile) && store.loadCustomers(customerFile);
+	results.push_back({"apiLoad", 1, secondsSince(start), "loaded=" + to_string(loaded)});
+	vector<CommandResult> commandResults(commands.size());
+	long long failed = 0;
+	long long apiAllocations = 0;
+	start = steady_clock::now();
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		long long allocations = heapAllocations;
+		commandResults[i] = store.execute(commands[i]);
+		if(commandResults[i].status == CommandStatus::Ok && (commands[i][0] == 'B' || commands[i][0] == 'R')) {
+
+			apiAllocations += heapAllocations - allocations;
+		}
+		failed += !commandResults[i].succeeded();
+	}
+	double seconds = secondsSince(start);
+
+	// the text of the results, as "executeCommand" prints it
+	stringstream text;
+	streambuf *previousOutput = cout.rdbuf(text.rdbuf());
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		const CommandResult &result = commandResults[i];
+		if(result.action == 'B' || result.action == 'R' || result.action == 'W') {
+
+			store.printCommandResult(result);
+		}
+		cout << result.output;
+		if(!result.succeeded() && result.action != 'H' && result.action != 'I' && result.action != 'Q' && result.action != 'L' && result.action != 'A') {
+
+			cout << "The following command failed: " << commands[i] << "." << endl << endl;
+		}
+	}
+	cout.rdbuf(previousOutput);
+	results.push_back({"apiExecute", (long long) commands.size(), seconds, "failed=" + to_string(failed)
+		+ " identical_text=" + to_string(text.str() == expectedOutput)});
+	results.push_back({"apiResultAllocations", succeededBorrowsReturns, 0, "per_success_execute=" + to_string(apiAllocations / (double) max(1LL, succeededBorrowsReturns))
+		+ " per_success_text=" + to_string(textAllocations / (double) max(1LL, succeededBorrowsReturns))});
+
+	// the results formatted into a buffer, written out (here: dropped) whenever it fills
+	vector<char> buffer(1 << 20);
+	const char *formatNames[] = {"apiFormatJson", "apiFormatBinary"};
+	for(int binary = 0; binary < 2; binary++) {
+
+		long long bytes = 0;
+		size_t used = 0;
+		long long allocations = heapAllocations;
+		start = steady_clock::now();
+		for(size_t i = 0; i < commandResults.size(); i++) {
+
+			size_t written = binary ? formatBinaryFrame(commandResults[i], buffer.data() + used, buffer.size() - used)
+				: formatJsonLine(commandResults[i], buffer.data() + used, buffer.size() - used);
+			if(written == 0) {
+
+				used = 0;
+				written = binary ? formatBinaryFrame(commandResults[i], buffer.data(), buffer.size()) : formatJsonLine(commandResults[i], buffer.data(), buffer.size());
+			}
+			used += written;
+			bytes += written;
+		}
+		seconds = secondsSince(start);
+		results.push_back({formatNames[binary], (long long) commandResults.size(), seconds, "bytes=" + to_string(bytes)
+			+ " allocations=" + to_string(heapAllocations - allocations)});
+	}
+}
+
+/**
+  * Measures streamed command input. The command file is executed with its output written to
+  * /dev/null line by line (every "endl" flushing it, as the command file path does), then piped to a
+  * command stream by a writer thread, the stream writing its output in blocks. Then single history
+  * commands are written to the stream one at a time, each waiting for its output: the time from the
+  * write to the output is the latency a slow producer sees.
+  *
+  * @param movieFile - The movie file of the catalog
+  * @param customerFile - The customer file
+  * @param commandFile - The command file
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkStreaming(string movieFile, string customerFile, string commandFile, vector<BenchmarkResult> &results) {
+
+	vector<string> commands = readLines(commandFile);
+	string commandText;
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		commandText += commands[i] + "\n";
+	}
+	streambuf *previousOutput = cout.rdbuf();
+	{
+		MovieRentalStore store;
+		store.scanMovieFile(movieFile);
+		store.scanCustomerFile(customerFile);
+		ofstream nullOutput("/dev/null");
+		cout.rdbuf(nullOutput.rdbuf());
+		steady_clock::time_point start = steady_clock::now();
+		for(size_t i = 0; i < commands.size(); i++) {
+
+			store.executeCommand(commands[i]);
+		}
+		double seconds = secondsSince(start);
+		cout.rdbuf(previousOutput);
+		results.push_back({"streamLineOutput", (long long) commands.size(), seconds, "output flushed per line"});
+	}
+	{
+		MovieRentalStore store;
+		store.scanMovieFile(movieFile);
+		store.scanCustomerFile(customerFile);
+		int pipeFds[2];
+		int nullFd = open("/dev/null", O_WRONLY);
+		if(pipe(pipeFds) != 0 || nullFd < 0) {
+
+			return;
+		}
+		steady_clock::time_point start = steady_clock::now();
+		thread writer([&]() {
+
+			for(size_t offset = 0; offset < commandText.size(); ) {
+
+				ssize_t written = write(pipeFds[1], commandText.data() + offset, min((size_t) 65536, commandText.size() - offset));
+				if(written <= 0) {
+
+					break;
+				}
+				offset += written;
+			}
+			close(pipeFds[1]);
+		});
+		CommandStream stream(store);
+		bool succeeded = stream.run(pipeFds[0], nullFd);
+		double seconds = secondsSince(start);
+		writer.join();
+		close(pipeFds[0]);
+		close(nullFd);
+		results.push_back({"streamPipe", stream.getCommandCount(), seconds, "bytes=" + to_string(commandText.size()) + " succeeded=" + to_string(succeeded)});
+	}
+	{
+		const int requests = 2000;
+		MovieRentalStore store;
+		store.scanMovieFile(movieFile);
+		store.scanCustomerFile(customerFile);
+		string customer = customerFile == "" ? "" : readLines(customerFile)[0];
+		string request = "H " + customer.substr(0, customer.find(' ')) + "\n";
+		int inputFds[2];
+		int outputFds[2];
+		if(pipe(inputFds) != 0 || pipe(outputFds) != 0) {
+
+			return;
+		}
+		CommandStream stream(store);
+		thread streamer([&]() {
+
+			stream.run(inputFds[0], outputFds[1]);
+			close(outputFds[1]);
+		});
+		vector<long long> latencies;
+		char buffer[65536];
+		for(int i = 0; i < requests; i++) {
+
+			steady_clock::time_point start = steady_clock::now();
+			if(write(inputFds[1], request.data(), request.size()) != (ssize_t) request.size()) {
+
+				break;
+			}
+			pollfd output = {outputFds[0], POLLIN, 0};
+			poll(&output, 1, -1);
+			latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+
+			// the history's output may take more than one write: let it drain before the next request
+			while(poll(&output, 1, 1) > 0 && read(outputFds[0], buffer, sizeof(buffer)) > 0) {
+			}
+		}
+		close(inputFds[1]);
+		while(read(outputFds[0], buffer, sizeof(buffer)) > 0) {
+		}
+		streamer.join();
+		close(inputFds[0]);
+		close(outputFds[0]);
+		sort(latencies.begin(), latencies.end());
+		double seconds = 0;
+		for(long long latency : latencies) {
+
+			seconds += latency / 1e9;
+		}
+		results.push_back({"streamLatency", (long long) latencies.size(), seconds, latencies.empty() ? "" : "p50_us=" + to_string(latencies[latencies.size() / 2] / 1000)
+			+ " p99_us=" + to_string(latencies[latencies.size() * 99 / 100] / 1000) + " max_us=" + to_string(latencies.back() / 1000)});
+	}
+}
+
+/**
+  * Measures the state export and import. The store left by the command file (inventory, customers,
+  * open rentals and transaction histories) is exported as JSON lines and as CSV, several times each;
+  * each export is then imported into an empty store, whose own export must be the same files, byte
+  * for byte (the round trip), or the run fails.
+  *
+  * @param movieFile - The movie file of the catalog
+  * @param customerFile - The customer file
+  * @param commandFile - The command file
+  * @param dataDirectory - The directory the state files are written to
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkStateExport(string movieFile, string customerFile, string commandFile, string dataDirectory, vector<BenchmarkResult> &results) {
+
+	const int rounds = 10;
+	const char *tables[] = {"inventory", "customers", "rentals", "history"};
+	MovieRentalStore store;
+	store.scanMovieFile(movieFile);
+	store.scanCustomerFile(customerFile);
+	store.scanCommandFile(commandFile);
+	for(RecordFormat format : {RecordFormat::JsonLines, RecordFormat::Csv}) {
+
+		string extension = getRecordExtension(format);
+		string directory = dataDirectory + "/state_" + extension;
+		bool written = true;
+		steady_clock::time_point start = steady_clock::now();
+		for(int round = 0; round < rounds; round++) {
+
+			written = store.exportState(directory, format) && written;
+		}
+		double seconds = secondsSince(start);
+
+		// the files written, their records (CSV files have a header row) and bytes
+		vector<string> files;
+		long long records = 0;
+		long long bytes = 0;
+		for(const char *table : tables) {
+
+			ifstream readFile(directory + "/" + table + "." + extension);
+			stringstream text;
+			text << readFile.rdbuf();
+			files.push_back(text.str());
+			records += count(files.back().begin(), files.back().end(), '\n') - (format == RecordFormat::Csv);
+			bytes += files.back().size();
+		}
+		results.push_back({"stateExport_" + extension, rounds * records, seconds, "written=" + to_string(written) + " bytes=" + to_string(bytes)
+			+ " MB_per_s=" + to_string((int) (rounds * bytes / seconds / 1e6))});
+
+		MovieRentalStore imported;
+		start = steady_clock::now();
+		bool read = imported.importState(directory);
+		seconds = secondsSince(start);
+		imported.exportState(directory + "_again", format);
+		bool identical = true;
+		for(size_t i = 0; i < files.size(); i++) {
+
+			ifstream readFile(directory + "_again/" + tables[i] + "." + extension);
+			stringstream text;
+			text << readFile.rdbuf();
+			identical = identical && text.str() == files[i];
+		}
+		results.push_back({"stateImport_" + extension, records, seconds, "imported=" + to_string(read) + " identical_export=" + to_string(identical)
+			+ " MB_per_s=" + to_string((int) (bytes / seconds / 1e6))});
+		check(written && read && identical, "the " + extension + " state export imported and exported again is the same files");
+	}
+}
+
+/**
+  * Checks the delimiter scanner against the iostream parsing it replaces, on random text over an
+  * alphabet dense in delimiters (commas, spaces, newlines, carriage returns and bytes above 127): the
+  * fields "splitFields" splits (and the rest it leaves) against successive "getline" calls on a
+  * stringstream, the positions every scan level finds against the scalar scan, and the lines a
+  * "LineScanner" reads with small blocks against "getline" on the file.
+  *
+  * @param dataDirectory - The directory the random files are written to
+  * @param seed - The seed of the random text
+  *
+  * @return The number of mismatches found
+  */
+long long checkDelimiterScanner(string dataDirectory, unsigned int seed) {
+
+	const char alphabet[] = {'a', 'b', 'c', ',', ',', ' ', ' ', '\n', '\r', '\xe9', '\x80'};
+	const string delimiterSets[] = {",", " ", "\n", ", \n", ", \n\r"};
+	const ScanLevel levels[] = {ScanLevel::Scalar, ScanLevel::Sse2, ScanLevel::Avx2};
+	mt19937_64 random(seed);
+	long long mismatches = 0;
+	for(int round = 0; round < 20000; round++) {
+
+		string text(random() % 200, ' ');
+		for(char &character : text) {
+
+			character = alphabet[random() % sizeof(alphabet)];
+		}
+
+		// the fields split at each delimiter, all of them and the first few with the rest of the text
+		for(char delimiter : {',', ' '}) {
+
+			for(size_t count : {(size_t) 1, (size_t) 3, (size_t) 400}) {
+
+				vector<string_view> fields(count);
+				string_view rest;
+				size_t split = splitFields(text, delimiter, fields.data(), count, &rest);
+				stringstream stream(text);
+				string field;
+				size_t expected = 0;
+				while(expected < count && getline(stream, field, delimiter)) {
+
+					mismatches += expected >= split || fields[expected] != field;
+					expected++;
+				}
+				streamoff restStart = stream.tellg();
+				mismatches += expected != split || rest != (restStart < 0 ? "" : text.substr(restStart));
+			}
+		}
+
+		// the positions found by every level, all of them and the first few
+		for(const string &delimiters : delimiterSets) {
+
+			size_t count = random() % 2 == 0 ? text.size() : random() % 8;
+			vector<uint32_t> expected(text.size() + 1);
+			vector<uint32_t> found(text.size() + 1);
+			size_t expectedCount = findDelimiters(text, delimiters, expected.data(), count, ScanLevel::Scalar);
+			for(ScanLevel level : levels) {
+
+				size_t foundCount = findDelimiters(text, delimiters, found.data(), count, level);
+				mismatches += foundCount != expectedCount || !equal(expected.begin(), expected.begin() + expectedCount, found.begin());
+			}
+		}
+
+		// the lines of the text as a file, read in blocks smaller than its lines
+		if(round % 20 == 0) {
+
+			string path = dataDirectory + "/scanner_fuzz.txt";
+			ofstream(path, ios::binary) << text;
+			vector<string> expected;
+			ifstream readFile(path, ios::binary);
+			string line;
+			while(getline(readFile, line)) {
+
+				expected.push_back(line);
+			}
+			for(size_t blockSize : {1, 7, 64}) {
+
+				LineScanner scanner(blockSize);
+				scanner.open(path);
+				string_view scanned;
+				size_t lines = 0;
+				while(scanner.next(scanned)) {
+
+					mismatches += lines >= expected.size() || scanned != expected[lines];
+					lines++;
+				}
+				mismatches += lines != expected.size();
+			}
+		}
+	}
+	return mismatches;
+}
+
+/**
+  * Measures the bytes per second the command file is tokenized at: read line by line and split into
+  * its space delimited fields by iostream ("getline" on the file, then on a stringstream of each
+  * line), and by "LineScanner" and "splitFields" at every scan level the processor supports. The
+  * newline scan alone is measured over the text in memory. The command file is repeated into a file
+  * of about 64 MB so the store's command archives are represented. The scanner is first checked
+  * against iostream on random text (see "checkDelimiterScanner"); a mismatch there, or a scan level
+  * reading other lines or fields than iostream, fails the run.
+  *
+  * @param commandFile - The command file
+  * @param dataDirectory - The directory the repeated command file is written to
+  * @param seed - The seed of the random text the scanner is checked on
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkDelimiterScanning(string commandFile, string dataDirectory, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	long long mismatches = checkDelimiterScanner(dataDirectory, seed);
+
+	// the command file, repeated
+	const size_t targetBytes = 64 << 20;
+	ifstream commands(commandFile, ios::binary);
+	stringstream commandText;
+	commandText << commands.rdbuf();
+	string text;
+	text.reserve(targetBytes + commandText.str().size());
+	while(text.size() < targetBytes && !commandText.str().empty()) {
+
+		text += commandText.str();
+	}
+	string path = dataDirectory + "/scanner_commands.txt";
+	ofstream(path, ios::binary) << text;
+
+	// the lines and fields read by iostream
+	long long lines = 0;
+	long long fields = 0;
+	steady_clock::time_point start = steady_clock::now();
+	{
+		ifstream readFile(path, ios::binary);
+		string line;
+		string field;
+		while(getline(readFile, line)) {
+
+			stringstream lineFields(line);
+			while(getline(lineFields, field, ' ')) {
+
+				fields++;
+			}
+			lines++;
+		}
+	}
+	double seconds = secondsSince(start);
+	results.push_back({"tokenize_iostream", lines, seconds, "fields=" + to_string(fields) + " MB_per_s=" + to_string((int) (text.size() / seconds / 1e6))
+		+ " mismatches=" + to_string(mismatches)});
+	check(mismatches == 0, "the delimiter scanner splits random text as iostream does (" + to_string(mismatches) + " mismatches)");
+
+	// the lines and fields read by the scanner, and the newlines found in the text, at every level
+	for(ScanLevel level : {ScanLevel::Scalar, ScanLevel::Sse2, ScanLevel::Avx2}) {
+
+		if(level > getSupportedScanLevel()) {
+
+			continue;
+		}
+		setScanLevel(level);
+		long long scannedLines = 0;
+		long long scannedFields = 0;
+		start = steady_clock::now();
+		{
+			LineScanner scanner;
+			scanner.open(path);
+			string_view line;
+			string_view lineFields[16];
+			while(scanner.next(line)) {
+
+				scannedFields += splitFields(line, ' ', lineFields, 16);
+				scannedLines++;
+			}
+		}
+		seconds = secondsSince(start);
+		results.push_back({string("tokenize_") + getScanLevelName(level), scannedLines, seconds, "fields=" + to_string(scannedFields)
+			+ " MB_per_s=" + to_string((int) (text.size() / seconds / 1e6)) + " same_fields=" + to_string(scannedLines == lines && scannedFields == fields)});
+		check(scannedLines == lines && scannedFields == fields, string("the ") + getScanLevelName(level) + " scanner reads the command file's lines and fields");
+
+		vector<uint32_t> newlines(1 << 16);
+		long long found = 0;
+		start = steady_clock::now();
+		for(size_t offset = 0; offset < text.size(); offset += 1 << 20) {
+
+			string_view block = string_view(text).substr(offset, 1 << 20);
+			size_t blockStart = 0;
+			size_t count;
+			while((count = findDelimiters(block.substr(blockStart), "\n", newlines.data(), newlines.size(), level)) > 0) {
+
+				found += count;
+				blockStart += newlines[count - 1] + 1;
+			}
+		}
+		seconds = secondsSince(start);
+		results.push_back({string("scanNewlines_") + getScanLevelName(level), found, seconds, "GB_per_s=" + to_string(text.size() / seconds / 1e9)});
+	}
+	setScanLevel(getSupportedScanLevel());
+	remove(path.c_str());
+	remove((dataDirectory + "/scanner_fuzz.txt").c_str());
+}
+
+/**
+  * Measures the parsing of customer IDs on 10 million customer file rows, 1% of them malformed (letters
+  * among the digits, a sign, no digits, or a value beyond an int): read by "LineScanner", split by
+  * "splitFields", then parsed by "stoi" (on a string of the field, a malformed ID caught as the
+  * exception it throws) and by "parseIntegerField". Each reports the rows per second, the heap
+  * allocations per row and the rows it rejected, against the rows generated malformed ("stoi" takes
+  * the digits leading "12a4" and accepts it). The customer file scan is then checked to skip and count
+  * the malformed rows of 20 thousand, malformed commands to fail as malformed, and the movie file scan
+  * to skip the rows with an empty field.
+  *
+  * @param dataDirectory - The directory the customer files are written to
+  * @param seed - The seed of the rows
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkNumericParsing(string dataDirectory, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	const char *malformedIDs[] = {"12a4", "", "+-7", "-7", "0", "99999999999", "1x000"};
+	mt19937_64 random(seed);
+	long long expectedMalformed = 0;
+	auto writeCustomers = [&](string path, long long rows) {
+
+		ofstream writeFile(path, ios::binary);
+		string text;
+		expectedMalformed = 0;
+		for(long long row = 0; row < rows; row++) {
+
+			if(random() % 100 == 0) {
+
+				text += malformedIDs[random() % (sizeof(malformedIDs) / sizeof(malformedIDs[0]))];
+				expectedMalformed++;
+			}
+			else {
+
+				text += to_string(1000 + random() % 1000000000);
+			}
+			text += " Lee Ann\n";
+			if(text.size() > (1 << 20)) {
+
+				writeFile << text;
+				text.clear();
+			}
+		}
+		writeFile << text;
+	};
+
+	const long long rows = 10000000;
+	string path = dataDirectory + "/numeric_customers.txt";
+	writeCustomers(path, rows);
+	for(bool fromChars : {false, true}) {
+
+		long long parsed = 0;
+		long long rejected = 0;
+		long long idSum = 0;
+		long long allocationsBefore = heapAllocations;
+		steady_clock::time_point start = steady_clock::now();
+		LineScanner scanner;
+		scanner.open(path);
+		string_view line;
+		string_view fields[3];
+		while(scanner.next(line)) {
+
+			splitFields(line, ' ', fields, 3);
+			int custID = 0;
+			bool valid;
+			if(fromChars) {
+
+				valid = parseIntegerField(fields[0], custID) && custID > 0;
+			}
+			else {
+
+				try {
+
+					custID = stoi(string(fields[0]));
+					valid = custID > 0;
+				}
+				catch(exception &e) {
+
+					valid = false;
+				}
+			}
+			parsed++;
+			rejected += !valid;
+			idSum += valid ? custID : 0;
+		}
+		double seconds = secondsSince(start);
+		results.push_back({fromChars ? "parseIDs_fromChars" : "parseIDs_stoi", parsed, seconds, "rejected=" + to_string(rejected) + " malformed="
+			+ to_string(expectedMalformed) + " allocations_per_row=" + to_string((double) (heapAllocations - allocationsBefore) / parsed)
+			+ " rows_per_s=" + to_string((long long) (parsed / seconds))});
+	}
+	remove(path.c_str());
+
+	// the customer file scan skips and counts the malformed rows (IDs repeating in 20 thousand rows are rejected by the table, not skipped)
+	path = dataDirectory + "/numeric_customers_scan.txt";
+	writeCustomers(path, 20000);
+	MovieRentalStore store;
+	steady_clock::time_point start = steady_clock::now();
+	bool read = store.scanCustomerFile(path);
+	double seconds = secondsSince(start);
+	results.push_back({"scanCustomers_malformed", 20000, seconds, "read=" + to_string(read) + " skipped=" + to_string(store.statistics.malformedLines)
+		+ " malformed=" + to_string(expectedMalformed)});
+	check(store.statistics.malformedLines == expectedMalformed, "the customer file scan skips the malformed rows");
+	remove(path.c_str());
+
+	// malformed commands of a known customer fail as malformed and are counted, without ending the run: empty
+	// tokens (two spaces, a leading space), an empty drama title field, and numbers that are not numbers
+	const char *malformedCommands[] = {"B 1000  F Fargo, 1996", " B 1000 D F Fargo, 1996", "R 1000 D  Fargo, 1996", " ", "B 1000 D D ,,", "B 1x00 D F Fargo, 1996",
+		"B 1000 D F Fargo, 19x6", "H 1000x", "H 1000 0"};
+	{
+		ofstream writeFile(path);
+		writeFile << "1000 Lee Ann" << endl;
+	}
+	MovieRentalStore commandStore;
+	commandStore.scanCustomerFile(path);
+	long long failedMalformed = 0;
+	start = steady_clock::now();
+	for(const char *command : malformedCommands) {
+
+		failedMalformed += commandStore.execute(command).status == CommandStatus::MalformedCommand;
+	}
+	seconds = secondsSince(start);
+	long long commandCount = sizeof(malformedCommands) / sizeof(malformedCommands[0]);
+	results.push_back({"commands_malformed", commandCount, seconds, "failed_malformed=" + to_string(failedMalformed) + " counted="
+		+ to_string(commandStore.statistics.malformedLines)});
+	check(failedMalformed == commandCount && commandStore.statistics.malformedLines == commandCount, "malformed commands fail as malformed and are counted");
+
+	// movie file rows with an empty field (two commas) are skipped and counted, and the rows around them added
+	string moviePath = dataDirectory + "/numeric_movies_scan.txt";
+	const char *emptyFieldMovies[] = {"F, 10, Nora Ephron,, 1999", "D, 10,, Good Will Hunting, 2000", "C, 10, Michael Curtiz,, Ingrid Bergman 8 1942"};
+	{
+		ofstream writeFile(moviePath);
+		writeFile << "F, 10, Nora Ephron, You've Got Mail, 1998" << endl;
+		for(const char *row : emptyFieldMovies) {
+
+			writeFile << row << endl;
+		}
+		writeFile << "C, 10, Michael Curtiz, Casablanca, Humphrey Bogart 8 1942" << endl;
+	}
+	MovieRentalStore movieStore;
+	movieStore.scanCustomerFile(path);
+	start = steady_clock::now();
+	bool moviesRead = movieStore.scanMovieFile(moviePath);
+	seconds = secondsSince(start);
+	bool validRowsAdded = movieStore.execute("B 1000 D F You've Got Mail, 1998").status == CommandStatus::Ok
+		&& movieStore.execute("B 1000 D C 8 1942 Humphrey Bogart").status == CommandStatus::Ok;
+	long long emptyFieldRows = sizeof(emptyFieldMovies) / sizeof(emptyFieldMovies[0]);
+	results.push_back({"scanMovies_emptyFields", emptyFieldRows + 2, seconds, "read=" + to_string(moviesRead) + " skipped="
+		+ to_string(movieStore.statistics.malformedLines) + " malformed=" + to_string(emptyFieldRows) + " valid_added=" + to_string(validRowsAdded)});
+	check(moviesRead && movieStore.statistics.malformedLines == emptyFieldRows && validRowsAdded, "the movie file scan skips the rows with an empty field");
+	remove(moviePath.c_str());
+	remove(path.c_str());
+}
+
+/**
+  * Measures the transaction history archive on 100 customers with 10 thousand transactions each,
+  * borrows and returns of random catalog movies: the bytes the histories hold, compressed blocks and
+  * recent transactions, against the same transactions kept as a vector of strings (the history before
+  * it was archived), and the time to add a transaction. The history command is then timed for every
+  * customer printing its whole history (against printing the vector), its newest 10 transactions and
+  * its newest 100, with the blocks each decodes. Every history is checked to read back, oldest first,
+  * the transactions added.
+  *
+  * @param movies - The generated catalog the transactions name movies of
+  * @param dataDirectory - The directory the customer file is written to
+  * @param seed - The seed of the transactions
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkHistoryArchive(const vector<GeneratedMovie> &movies, string dataDirectory, unsigned int seed, vector<BenchmarkResult> &results) {
+
+	const int customerCount = 100;
+	const int transactionsPerCustomer = 10000;
+	const int firstID = 1000;
+	mt19937_64 random(seed);
+	vector<vector<string>> transactions(customerCount);
+	for(int c = 0; c < customerCount; c++) {
+
+		for(int t = 0; t < transactionsPerCustomer; t++) {
+
+			const GeneratedMovie &movie = movies[random() % movies.size()];
+			const char *genre = movie.genre == 'F' ? "comedy" : movie.genre == 'D' ? "drama" : "classics";
+			transactions[c].push_back(string(t % 2 == 0 ? "Borrowed " : "Returned ") + genre + " DVD movie with sorting criteria: " + movie.commandCriteria);
+		}
+	}
+
+	// the histories alone: their bytes against a vector of the transactions, and their adds
+	long long added = 0;
+	size_t vectorBytes = 0;
+	size_t archiveBytes = 0;
+	size_t blockCount = 0;
+	long long mismatches = 0;
+	steady_clock::time_point start = steady_clock::now();
+	vector<TransactionHistory> histories(customerCount);
+	for(int c = 0; c < customerCount; c++) {
+
+		for(const string &transaction : transactions[c]) {
+
+			histories[c].add(transaction);
+			added++;
+		}
+	}
+	double seconds = secondsSince(start);
+	for(int c = 0; c < customerCount; c++) {
+
+		vector<string> kept;
+		for(const string &transaction : transactions[c]) {
+
+			kept.push_back(transaction);
+		}
+		vectorBytes += kept.capacity() * sizeof(string);
+		for(const string &transaction : kept) {
+
+			vectorBytes += MemoryAccounting::stringHeapBytes(transaction);
+		}
+		archiveBytes += histories[c].getBytes();
+		blockCount += histories[c].getBlockCount();
+		size_t t = 0;
+		histories[c].forEachOldestFirst([&](string_view transaction) {
+
+			mismatches += t >= transactions[c].size() || transaction != transactions[c][t];
+			t++;
+		});
+		mismatches += t != transactions[c].size() || histories[c].size() != transactions[c].size();
+	}
+	results.push_back({"historyAdd", added, seconds, "blocks=" + to_string(blockCount) + " vector_bytes=" + to_string(vectorBytes)
+		+ " archive_bytes=" + to_string(archiveBytes) + " reduction=" + to_string((double) vectorBytes / archiveBytes) + " mismatches=" + to_string(mismatches)});
+
+	// the whole history printed from a vector, newest first, as the command did before
+	start = steady_clock::now();
+	for(int c = 0; c < customerCount; c++) {
+
+		for(size_t t = transactions[c].size(); t > 0; t--) {
+
+			cout << transactions[c][t - 1] << endl;
+		}
+	}
+	results.push_back({"historyPrint_vector", customerCount, secondsSince(start), "transactions=" + to_string(transactionsPerCustomer)});
+
+	// the whole history read from the archive, newest first, without printing it
+	size_t textBytes = 0;
+	start = steady_clock::now();
+	for(int c = 0; c < customerCount; c++) {
+
+		histories[c].forEachNewestFirst(SIZE_MAX, [&](string_view transaction) {
+
+			textBytes += transaction.size();
+		});
+	}
+	seconds = secondsSince(start);
+	results.push_back({"historyRead_archive", customerCount, seconds, "text_bytes=" + to_string(textBytes)});
+
+	// the history command of a store holding the histories
+	string customerFile = dataDirectory + "/history_customers.txt";
+	{
+		ofstream writeFile(customerFile);
+		for(int c = 0; c < customerCount; c++) {
+
+			writeFile << firstID + c << " Lee Ann" << endl;
+		}
+	}
+	MovieRentalStore store;
+	store.scanCustomerFile(customerFile);
+	for(int c = 0; c < customerCount; c++) {
+
+		for(const string &transaction : transactions[c]) {
+
+			store.addTransaction(transaction, firstID + c);
+		}
+	}
+	for(string count : {"", " 10", " 100"}) {
+
+		long long decodedBefore = TransactionHistory::getBlocksDecoded();
+		start = steady_clock::now();
+		for(int c = 0; c < customerCount; c++) {
+
+			store.executeCommand("H " + to_string(firstID + c) + count);
+		}
+		seconds = secondsSince(start);
+		results.push_back({count.empty() ? "historyCommand_all" : "historyCommand" + count.substr(1), customerCount, seconds, "blocks_decoded_per_command="
+			+ to_string((double) (TransactionHistory::getBlocksDecoded() - decodedBefore) / customerCount)});
+	}
+	remove(customerFile.c_str());
+}
+
+/**
+  * Measures the movie classes on a large generated catalog, independently of the inventory trees:
+  * the time and bytes per movie to construct every movie (interning its names), the cost of a
+  * comparison between random movies of a genre, and the time to sort each genre.
+  *
+  * @param workload - The workload settings; the catalog uses its genre mix and seed
+  * @param catalogSize - The number of movies in the catalog
+  * @param results - The results the measurements are appended to
+  */
+void benchmarkCatalog(WorkloadSettings workload, int catalogSize, vector<BenchmarkResult> &results) {
+
+	workload.movieCount = catalogSize;
+	workload.customerCount = 0;
+	workload.ordering = CatalogOrdering::Random;
+	vector<Comedy> comedies;
+	vector<Drama> dramas;
+	vector<Classics> classics;
+	size_t stringBytes = StringTable::getBytes();
+	steady_clock::time_point start;
+	double seconds;
+	{
+		WorkloadGenerator generator(workload);
+		start = steady_clock::now();
+		buildMovies(generator.getMovies(), comedies, dramas, classics);
+		seconds = secondsSince(start);
+	}
+	size_t objectBytes = comedies.size() * sizeof(Comedy) + dramas.size() * sizeof(Drama) + classics.size() * sizeof(Classics);
+	size_t internedBytes = StringTable::getBytes() - stringBytes;
+	results.push_back({"catalogBuild", catalogSize, seconds, "bytes_per_movie=" + to_string((objectBytes + internedBytes) / catalogSize)
+		+ " interned_bytes=" + to_string(internedBytes)});
+
+	// comparisons between movies picked at random, the cheap ID equality checks included
+	const long long comparisons = 10000000;
+	mt19937_64 random(workload.seed);
+	long long lesser = 0;
+	start = steady_clock::now();
+	for(long long i = 0; i < comparisons && !dramas.empty(); i++) {
+
+		lesser += dramas[random() % dramas.size()] < dramas[random() % dramas.size()];
+	}
+	results.push_back({"dramaCompare", comparisons, secondsSince(start), "lesser=" + to_string(lesser)});
+	lesser = 0;
+	start = steady_clock::now();
+	for(long long i = 0; i < comparisons && !comedies.empty(); i++) {
+
+		lesser += comedies[random() % comedies.size()] < comedies[random() % comedies.size()];
+	}
+	results.push_back({"comedyCompare", comparisons, secondsSince(start), "lesser=" + to_string(lesser)});
+	lesser = 0;
+	start = steady_clock::now();
+	for(long long i = 0; i < comparisons && !classics.empty(); i++) {
+
+		lesser += classics[random() % classics.size()] < classics[random() % classics.size()];
+	}
+	results.push_back({"classicsCompare", comparisons, secondsSince(start), "lesser=" + to_string(lesser)});
+
+	start = steady_clock::now();
+	sort(dramas.begin(), dramas.end(), [](Drama &a, Drama &b) { return a < b; });
+	results.push_back({"dramaSort", (long long) dramas.size(), secondsSince(start), ""});
+
+	// approximate title search over the whole catalog
+	benchmarkTitleSearch(comedies, dramas, classics, workload.seed, "_catalog", results);
+}
+
+int main(int argc, char *argv[]) {
+
+	WorkloadSettings workload;
+	BenchmarkSettings benchmark;
+	if(!parseArguments(argc, argv, workload, benchmark)) {
+
+		printUsage();
+		return 1;
+	}
+
+	// generate the workload files
+	mkdir(benchmark.dataDirectory.c_str(), 0755);
+	string movieFile = benchmark.dataDirectory + "/movies.txt";
+	string customerFile = benchmark.dataDirectory + "/customers.txt";
+	string commandFile = benchmark.dataDirectory + "/commands.txt";
+	steady_clock::time_point start = steady_clock::now();
+	WorkloadGenerator generator(workload);
+	if(!generator.writeMovieFile(movieFile) || !generator.writeCustomerFile(customerFile) || !generator.writeCommandFile(commandFile)) {
+
+		cout << "Could not write workload files to: " << benchmark.dataDirectory << endl;
+		return 1;
+	}
+	cout << "Generated workload in " << benchmark.dataDirectory << " (" << secondsSince(start) << " s)" << endl;
+
+	// attribute the memory of the loaded store to its subsystems, reported in the loader notes
+	MemoryAccounting::enable();
+	vector<BenchmarkResult> results;
+	DiscardBuffer discard;
+	streambuf *standardOutput = cout.rdbuf(&discard);
+
+	// file loaders, each timed on a store holding only what the earlier loaders added
+	MovieRentalStore *store = new MovieRentalStore();
+	start = steady_clock::now();
+	store->scanMovieFile(movieFile);
+	double seconds = secondsSince(start);
+	results.push_back({"scanMovieFile", workload.movieCount, seconds, "accepted=" + to_string(inventorySize(*store))
+		+ " inventory_bytes=" + to_string(MemoryAccounting::getAccount(MemorySubsystem::Inventory).liveBytes)});
+
+	start = steady_clock::now();
+	store->scanCustomerFile(customerFile);
+	results.push_back({"scanCustomerFile", workload.customerCount, secondsSince(start), "customer_table_bytes="
+		+ to_string(MemoryAccounting::getAccount(MemorySubsystem::CustomerTable).liveBytes)});
+
+	start = steady_clock::now();
+	store->scanCommandFile(commandFile);
+	seconds = secondsSince(start);
+	results.push_back({"scanCommandFile", workload.commandCount, seconds, "ledger_bytes="
+		+ to_string(MemoryAccounting::getAccount(MemorySubsystem::Ledgers).liveBytes) + " history_bytes="
+		+ to_string(MemoryAccounting::getAccount(MemorySubsystem::History).liveBytes)});
+	delete store;
+
+	// individual commands, timed one by one on a freshly loaded store
+	store = new MovieRentalStore();
+	store->scanMovieFile(movieFile);
+	store->scanCustomerFile(customerFile);
+	vector<string> commands = readLines(commandFile);
+	const string commandTypes = "BRHI";
+	vector<long long> commandCounts(commandTypes.size(), 0);
+	vector<double> commandSeconds(commandTypes.size(), 0);
+	for(size_t i = 0; i < commands.size(); i++) {
+
+		size_t type = commandTypes.find(commands[i][0]);
+		start = steady_clock::now();
+		store->executeCommand(commands[i]);
+		seconds = secondsSince(start);
+		if(type != string::npos) {
+
+			commandCounts[type]++;
+			commandSeconds[type] += seconds;
+		}
+	}
+	for(size_t type = 0; type < commandTypes.size(); type++) {
+
+		results.push_back({string("command_") + commandTypes[type], commandCounts[type], commandSeconds[type], ""});
+	}
+
+	// customer hash table lookups
+	const vector<int> &customerIDs = generator.getCustomerIDs();
+	long long lookups = 0;
+	long long found = 0;
+	start = steady_clock::now();
+	for(int round = 0; round < 10; round++) {
+
+		for(size_t i = 0; i < customerIDs.size(); i++) {
+
+			found += store->findCustomer(customerIDs[i]);
+			lookups++;
+		}
+	}
+	results.push_back({"findCustomer", lookups, secondsSince(start), "found=" + to_string(found)});
+
+	// teardown of the loaded store (customer chains, borrow lists and slab pools)
+	long long customerSlabs = store->customerPool.getSlabCount();
+	start = steady_clock::now();
+	delete store;
+	results.push_back({"storeTeardown", workload.customerCount, secondsSince(start), "customer_slabs=" + to_string(customerSlabs)});
+
+	// inventory lookups and stock updates with each storage layout
+	benchmarkInventoryStorage(generator.getMovies(), workload.seed, results);
+
+	// borrow/return overhead of the availability index, and in-stock queries with and without it
+	benchmarkAvailability(generator.getMovies(), workload.seed, results);
+
+	// lookups and memory of an inventory whose titles are retired and replaced
+	benchmarkChurn(generator.getMovies(), workload.seed, results);
+
+	// borrow/return latency with a growing number of media formats
+	benchmarkFormats(workload, benchmark.dataDirectory, results);
+
+	// time of movie delta files against the size of the catalog they apply to
+	benchmarkDelta(workload, benchmark.dataDirectory, results);
+
+	// lookups by non-key attributes, scanned and through secondary indexes
+	benchmarkSecondaryIndexes(generator.getMovies(), movieFile, workload.seed, results);
+
+	// the command file executed through the API of an embedded store
+	benchmarkEmbeddedApi(movieFile, customerFile, commandFile, results);
+
+	// streamed command input: throughput through a pipe, and the latency of single commands
+	benchmarkStreaming(movieFile, customerFile, commandFile, results);
+
+	// the store clocks, and a replay of the command file on a simulated clock
+	benchmarkClocks(movieFile, customerFile, commandFile, results);
+
+	// due dates of 5 million open rentals: hourly overdue queries by expiry and by scan
+	benchmarkDueDates(workload.seed, results);
+
+	// waitlists of hot titles: the queues alone, and customers waiting in a store
+	benchmarkWaitlists(generator.getMovies(), movieFile, customerFile, results);
+
+	// the state left by the command file exported and imported, as JSON lines and CSV
+	benchmarkStateExport(movieFile, customerFile, commandFile, benchmark.dataDirectory, results);
+
+	// the command file tokenized by iostream and by the delimiter scanner at each scan level
+	benchmarkDelimiterScanning(commandFile, benchmark.dataDirectory, workload.seed, results);
+
+	// customer IDs of 10 million customer rows parsed by stoi and by from_chars, malformed rows skipped
+	benchmarkNumericParsing(benchmark.dataDirectory, workload.seed, results);
+
+	// histories of 10 thousand transactions: their bytes archived against a vector, and the history command
+	benchmarkHistoryArchive(generator.getMovies(), benchmark.dataDirectory, workload.seed, results);
+
+	// approximate title search over the generated catalog
+	{
+		vector<Comedy> comedies;
+		vector<Drama> dramas;
+		vector<Classics> classics;
+		buildMovies(generator.getMovies(), comedies, dramas, classics);
+		benchmarkTitleSearch(comedies, dramas, classics, workload.seed, "", results);
+	}
+	cout.rdbuf(standardOutput);
+
+	if(benchmark.catalogSize > 0) {
+
+		cout << "Measuring a catalog of " << benchmark.catalogSize << " movies" << endl;
+		benchmarkCatalog(workload, benchmark.catalogSize, results);
+	}
+
+	// summary
+	cout << left << setw(20) << "benchmark" << right << setw(12) << "items" << setw(14) << "seconds" << setw(14) << "ns/item" << "  note" << endl;
+	for(size_t i = 0; i < results.size(); i++) {
+
+		double nsPerItem = results[i].items > 0 ? results[i].seconds * 1e9 / results[i].items : 0;
+		cout << left << setw(20) << results[i].name << right << setw(12) << results[i].items << setw(14) << fixed << setprecision(6)
+			<< results[i].seconds << setw(14) << setprecision(1) << nsPerItem << "  " << results[i].note << endl;
+	}
+	if(!writeResults(results, workload, benchmark)) {
+
+		cout << "Could not write results to: " << benchmark.outputFile << endl;
+		return 1;
+	}
+	cout << "Results appended to " << benchmark.outputFile << endl;
+	if(failedChecks > 0) {
+
+		cout << failedChecks << " check(s) failed (see standard error)" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,241 @@
+#include "StoreClock.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+using namespace std::chrono;
+
+/**
+  * Default destructor.
+  */
+StoreClock::~StoreClock() {}
+
+/**
+  * Sets the current time: only simulated clocks can be set.
+  *
+  * @param time - The time, in seconds since the epoch
+  *
+  * @return Whether the clock was set
+  */
+bool StoreClock::setTime(long long time) {
+
+	(void) time;
+	return false;
+}
+
+/**
+  * Evaluates whether the clock is moved by commands only.
+  *
+  * @return Whether the clock is simulated
+  */
+bool StoreClock::isSimulated() const {
+
+	return false;
+}
+
+/**
+  * Creates a clock from its name: "system", "monotonic", "simulated" (starting at the epoch) or
+  * "simulated:<time>", e.g. "simulated:2024-03-01".
+  *
+  * @param name - The name of the clock
+  *
+  * @return The clock (owned by the caller), nullptr if the name is not a clock's
+  */
+StoreClock *StoreClock::create(const string &name) {
+
+	if(name == "system") {
+
+		return new SystemClock();
+	}
+	if(name == "monotonic") {
+
+		return new MonotonicClock();
+	}
+	if(name == "simulated") {
+
+		return new SimulatedClock();
+	}
+	if(name.compare(0, 10, "simulated:") == 0) {
+
+		long long startTime = parseTime(name.substr(10));
+		return startTime < 0 ? nullptr : new SimulatedClock(startTime);
+	}
+	return nullptr;
+}
+
+/**
+  * Parses a time: seconds since the epoch, or a UTC date and optional time of day.
+  *
+  * @param text - The time, e.g. "1709317800", "2024-03-01" or "2024-03-01 18:30"
+  *
+  * @return The time in seconds since the epoch, -1 if the text is not a time
+  */
+long long StoreClock::parseTime(const string &text) {
+
+	if(text != "" && text.find_first_not_of("0123456789") == string::npos) {
+
+		return text.size() <= 18 ? stoll(text) : -1;
+	}
+	int year, month, day, hour = 0, minute = 0, second = 0;
+	int length;
+	const char *remaining = text.c_str();
+	if(sscanf(remaining, "%d-%d-%d%n", &year, &month, &day, &length) != 3) {
+
+		return -1;
+	}
+	remaining += length;
+	if(*remaining == ' ') {
+
+		if(sscanf(remaining, " %d:%d%n", &hour, &minute, &length) != 2) {
+
+			return -1;
+		}
+		remaining += length;
+		if(*remaining == ':') {
+
+			if(sscanf(remaining, ":%d%n", &second, &length) != 1) {
+
+				return -1;
+			}
+			remaining += length;
+		}
+	}
+	if(*remaining != '\0' || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+
+		return -1;
+	}
+	tm calendarTime = {};
+	calendarTime.tm_year = year - 1900;
+	calendarTime.tm_mon = month - 1;
+	calendarTime.tm_mday = day;
+	calendarTime.tm_hour = hour;
+	calendarTime.tm_min = minute;
+	calendarTime.tm_sec = second;
+	return timegm(&calendarTime);
+}
+
+/**
+  * Formats a time as its date and time (UTC).
+  *
+  * @param time - The time, in seconds since the epoch
+  *
+  * @return The date and time, e.g. "2024-03-01 18:30"
+  */
+string StoreClock::formatTime(long long time) {
+
+	time_t clockTime = time;
+	tm calendarTime;
+	gmtime_r(&clockTime, &calendarTime);
+	ostringstream formatted;
+	formatted << put_time(&calendarTime, "%Y-%m-%d %H:%M");
+	return formatted.str();
+}
+
+/**
+  * Gets the wall clock time.
+  *
+  * @return The time, in seconds since the epoch
+  */
+long long SystemClock::now() {
+
+	return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+}
+
+/**
+  * Gets the name of the clock.
+  *
+  * @return "system"
+  */
+const char *SystemClock::getName() const {
+
+	return "system";
+}
+
+/**
+  * MonotonicClock constructor - reads the wall clock once, later times follow the steady clock.
+  */
+MonotonicClock::MonotonicClock() {
+
+	startTime = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+	startTicks = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+  * Gets the wall clock time of the clock's creation, advanced by the steady clock since.
+  *
+  * @return The time, in seconds since the epoch
+  */
+long long MonotonicClock::now() {
+
+	return startTime + (duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - startTicks) / 1000000000;
+}
+
+/**
+  * Gets the name of the clock.
+  *
+  * @return "monotonic"
+  */
+const char *MonotonicClock::getName() const {
+
+	return "monotonic";
+}
+
+/**
+  * SimulatedClock constructor - the clock stands still at the starting time until set.
+  *
+  * @param startTime - The starting time, in seconds since the epoch
+  */
+SimulatedClock::SimulatedClock(long long startTime) {
+
+	currentTime = startTime;
+}
+
+/**
+  * Gets the time the clock was last set to.
+  *
+  * @return The time, in seconds since the epoch
+  */
+long long SimulatedClock::now() {
+
+	return currentTime;
+}
+
+/**
+  * Moves the clock forward (or leaves it) to a time.
+  *
+  * @param time - The time, in seconds since the epoch
+  *
+  * @return Whether the clock was set (false if the time is before its current time)
+  */
+bool SimulatedClock::setTime(long long time) {
+
+	if(time < currentTime) {
+
+		return false;
+	}
+	currentTime = time;
+	return true;
+}
+
+/**
+  * Evaluates whether the clock is moved by commands only.
+  *
+  * @return true
+  */
+bool SimulatedClock::isSimulated() const {
+
+	return true;
+}
+
+/**
+  * Gets the name of the clock.
+  *
+  * @return "simulated"
+  */
+const char *SimulatedClock::getName() const {
+
+	return "simulated";
+}
@@ -0,0 +1,105 @@
+#ifndef STORECLOCK_H
+#define STORECLOCK_H
+
+#include <string>
+
+using namespace std;
+
+// the source of the time the store stamps borrows and due dates with, in seconds since the epoch.
+// the store reads the system clock unless another is installed (not owned by the store):
+//   SystemClock     the system's wall clock (the default)
+//   MonotonicClock  the wall clock at its creation, advanced by the steady clock: never goes back
+//                   when the wall clock is set
+//   SimulatedClock  a clock only "T"/Time commands move (and journal replays, which record them):
+//                   a command file then runs the same way at any speed, as often as it is run
+class StoreClock {
+
+public:
+
+	// StoreClock destructor
+	virtual ~StoreClock();
+
+	// gets the current time, in seconds since the epoch
+	virtual long long now() = 0;
+
+	// sets the current time (seconds since the epoch) of a simulated clock; false if the clock
+	// cannot be set, or the time is before its current time
+	virtual bool setTime(long long);
+
+	// evaluates whether the clock is moved by commands only
+	virtual bool isSimulated() const;
+
+	// gets the name of the clock ("system", "monotonic" or "simulated")
+	virtual const char *getName() const = 0;
+
+	// creates the clock of the name argument, "simulated" optionally followed by ":" and its starting
+	// time (see "parseTime"); nullptr if the name is not a clock's
+	static StoreClock *create(const string &);
+
+	// parses a time: seconds since the epoch, or a UTC date "YYYY-MM-DD" optionally followed by a
+	// space and "HH:MM" or "HH:MM:SS"; -1 if the text is neither
+	static long long parseTime(const string &);
+
+	// formats a time as its UTC date and time, e.g. "2024-03-01 18:30"
+	static string formatTime(long long);
+};
+
+// the system's wall clock
+class SystemClock: public StoreClock {
+
+public:
+
+	// gets the wall clock time
+	long long now();
+
+	// gets "system"
+	const char *getName() const;
+};
+
+// the wall clock at the clock's creation, advanced by the steady clock
+class MonotonicClock: public StoreClock {
+
+private:
+
+	// the wall clock time and steady clock reading (nanoseconds) at the clock's creation
+	long long startTime;
+	long long startTicks;
+
+public:
+
+	// MonotonicClock constructor - reads the wall clock
+	MonotonicClock();
+
+	// gets the wall clock time at creation, advanced by the steady clock
+	long long now();
+
+	// gets "monotonic"
+	const char *getName() const;
+};
+
+// a clock moved forward by "setTime" only
+class SimulatedClock: public StoreClock {
+
+private:
+
+	long long currentTime;
+
+public:
+
+	// SimulatedClock constructor - the argument is the starting time
+	explicit SimulatedClock(long long = 0);
+
+	// gets the time last set
+	long long now();
+
+	// moves the clock forward to the time argument
+	bool setTime(long long);
+
+	// gets true
+	bool isSimulated() const;
+
+	// gets "simulated"
+	const char *getName() const;
+};
+
+#endif
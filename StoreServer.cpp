@@ -0,0 +1,546 @@
+#include "StoreServer.h"
+
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+const string StoreServer::responseTerminator = ".";
+
+// set by the signal handler when SIGINT or SIGTERM is received, checked by the event loop
+static volatile sig_atomic_t shutdownRequested = 0;
+
+/**
+  * Signal handler requesting a graceful shutdown of the event loop.
+  *
+  * @param signalNumber - The signal received
+  */
+static void requestShutdown(int signalNumber) {
+
+	(void) signalNumber;
+	shutdownRequested = 1;
+}
+
+/**
+  * Puts the file descriptor argument in non-blocking mode.
+  *
+  * @param fd - The file descriptor to be modified
+  *
+  * @return The success status of the mode change
+  */
+static bool setNonBlocking(int fd) {
+
+	int flags = fcntl(fd, F_GETFL, 0);
+	if(flags == -1) {
+
+		return false;
+	}
+	return fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+/**
+  * Constructor stores the store commands are executed against and raises the open file limit
+  * to the hard limit, so that thousands of clients can be connected at once.
+  *
+  * @param store - The store commands are executed against
+  */
+StoreServer::StoreServer(MovieRentalStore &store) : store(store) {
+
+	struct rlimit fileLimit;
+	if(getrlimit(RLIMIT_NOFILE, &fileLimit) == 0 && fileLimit.rlim_cur < fileLimit.rlim_max) {
+
+		fileLimit.rlim_cur = fileLimit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &fileLimit);
+	}
+}
+
+/**
+  * Destructor closes every open connection, the listening socket and the epoll instance. The
+  * Unix domain socket file is removed if one was bound.
+  */
+StoreServer::~StoreServer() {
+
+	while(!connections.empty()) {
+
+		closeConnection(connections.begin()->second);
+	}
+	if(listenFd != -1) {
+
+		close(listenFd);
+	}
+	if(epollFd != -1) {
+
+		close(epollFd);
+	}
+	if(socketPath != "") {
+
+		unlink(socketPath.c_str());
+	}
+}
+
+/**
+  * Binds and listens on a Unix domain socket. A stale socket file at the path is replaced.
+  *
+  * @param path - The file system path of the socket
+  *
+  * @return The success status of the bind
+  */
+bool StoreServer::listenUnixSocket(string path) {
+
+	struct sockaddr_un address;
+	if(path.length() >= sizeof(address.sun_path)) {
+
+		cout << "Socket path is too long: " << path << endl;
+		return false;
+	}
+	listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listenFd == -1) {
+
+		cout << "Could not create socket: " << strerror(errno) << endl;
+		return false;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	unlink(path.c_str());
+	if(bind(listenFd, (struct sockaddr *) &address, sizeof(address)) == -1 || listen(listenFd, SOMAXCONN) == -1) {
+
+		cout << "Could not listen on socket " << path << ": " << strerror(errno) << endl;
+		return false;
+	}
+	socketPath = path;
+	cout << "Listening on Unix domain socket: " << path << endl;
+	return setUpEventLoop();
+}
+
+/**
+  * Binds and listens on a TCP port of the loopback interface (127.0.0.1).
+  *
+  * @param port - The TCP port to listen on
+  *
+  * @return The success status of the bind
+  */
+bool StoreServer::listenLoopbackPort(int port) {
+
+	struct sockaddr_in address;
+	int reuse = 1;
+	listenFd = socket(AF_INET, SOCK_STREAM, 0);
+	if(listenFd == -1) {
+
+		cout << "Could not create socket: " << strerror(errno) << endl;
+		return false;
+	}
+	setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if(bind(listenFd, (struct sockaddr *) &address, sizeof(address)) == -1 || listen(listenFd, SOMAXCONN) == -1) {
+
+		cout << "Could not listen on port " << port << ": " << strerror(errno) << endl;
+		return false;
+	}
+	cout << "Listening on 127.0.0.1:" << port << endl;
+	return setUpEventLoop();
+}
+
+/**
+  * Creates the epoll instance and registers the (non-blocking) listening socket for reads.
+  *
+  * @return The success status of the event loop setup
+  */
+bool StoreServer::setUpEventLoop() {
+
+	if(!setNonBlocking(listenFd)) {
+
+		return false;
+	}
+	epollFd = epoll_create1(0);
+	if(epollFd == -1) {
+
+		cout << "Could not create epoll instance: " << strerror(errno) << endl;
+		return false;
+	}
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = listenFd;
+	return epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) == 0;
+}
+
+/**
+  * Runs the event loop. Each wakeup accepts new clients, reads and executes commands from readable
+  * clients, releases responses whose journal records became durable, and flushes pending responses
+  * to writable clients. Returns when "stop" is called or
+  * SIGINT/SIGTERM is received.
+  *
+  * @return Whether the loop exited cleanly
+  */
+bool StoreServer::run() {
+
+	if(epollFd == -1) {
+
+		cout << "Server is not listening." << endl;
+		return false;
+	}
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, requestShutdown);
+	signal(SIGTERM, requestShutdown);
+	if(store.journal != nullptr) {
+
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = store.journal->getNotificationFd();
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, event.data.fd, &event);
+	}
+	vector<struct epoll_event> events(maxEventsPerWait);
+	running = true;
+	while(running && !shutdownRequested) {
+
+		int readyCount = epoll_wait(epollFd, events.data(), maxEventsPerWait, -1);
+		if(readyCount == -1) {
+
+			if(errno == EINTR) {
+
+				continue;
+			}
+			cout << "epoll_wait failed: " << strerror(errno) << endl;
+			return false;
+		}
+		for(int i = 0; i < readyCount; i++) {
+
+			if(events[i].data.fd == listenFd) {
+
+				acceptConnections();
+				continue;
+			}
+			if(store.journal != nullptr && events[i].data.fd == store.journal->getNotificationFd()) {
+
+				store.journal->runCompletedContinuations();
+				continue;
+			}
+			map<int, ClientConnection*>::iterator it = connections.find(events[i].data.fd);
+			if(it == connections.end()) {
+
+				continue;
+			}
+			ClientConnection *connection = it->second;
+			bool open = true;
+			if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+
+				open = readFromConnection(connection);
+			}
+			if(open && (events[i].events & EPOLLOUT)) {
+
+				open = writeToConnection(connection);
+			}
+			if(!open) {
+
+				closeConnection(connection);
+			}
+		}
+	}
+	cout << "Server shutting down." << endl;
+	return true;
+}
+
+/**
+  * Requests the event loop to exit.
+  */
+void StoreServer::stop() {
+
+	running = false;
+}
+
+/**
+  * Accepts every connection pending on the listening socket and registers it with the event loop.
+  */
+void StoreServer::acceptConnections() {
+
+	while(true) {
+
+		int clientFd = accept(listenFd, nullptr, nullptr);
+		if(clientFd == -1) {
+
+			if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+
+				cout << "accept failed: " << strerror(errno) << endl;
+			}
+			return;
+		}
+		setNonBlocking(clientFd);
+		if(socketPath == "") {
+
+			int noDelay = 1;
+			setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = clientFd;
+		if(epoll_ctl(epollFd, EPOLL_CTL_ADD, clientFd, &event) == -1) {
+
+			close(clientFd);
+			continue;
+		}
+		connections[clientFd] = new ClientConnection(clientFd);
+	}
+}
+
+/**
+  * Reads everything available from the client, executes every complete command line and tries to
+  * send the responses right away. Reading pauses while the client has too much unsent output, or
+  * once "maxPendingInput" bytes are buffered (the lines among them are executed first); a client
+  * whose partial line reaches that size is dropped. A client that closed its end is drained: its
+  * responses are still sent, by later writability and journal events, without blocking the loop.
+  *
+  * @param connection - The client being read
+  *
+  * @return Whether the connection is still open
+  */
+bool StoreServer::readFromConnection(ClientConnection *connection) {
+
+	// a draining client is no longer watched for reads: an event now means its socket hung up or failed
+	if(connection->draining) {
+
+		return false;
+	}
+	char buffer[64 * 1024];
+	bool open = true;
+	while(connection->outputBuffer.size() - connection->outputOffset < maxPendingOutput && connection->inputBuffer.size() < maxPendingInput) {
+
+		ssize_t bytesRead = recv(connection->fd, buffer, sizeof(buffer), 0);
+		if(bytesRead > 0) {
+
+			connection->inputBuffer.append(buffer, bytesRead);
+			continue;
+		}
+		if(bytesRead == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+
+			break;
+		}
+		if(bytesRead == -1 && errno == EINTR) {
+
+			continue;
+		}
+
+		// peer closed its end (or the socket failed): still answer what was received
+		open = false;
+		break;
+	}
+	processBufferedCommands(connection);
+
+	// what is left is a partial line: one this long is not a command line
+	if(connection->inputBuffer.size() >= maxPendingInput) {
+
+		cout << "Dropped a client sending " << connection->inputBuffer.size() << " bytes without a newline." << endl;
+		return false;
+	}
+
+	// peer closed its end (or the socket failed): the responses parked or unsent are still sent
+	if(!open) {
+
+		connection->draining = true;
+	}
+	return writeToConnection(connection);
+}
+
+/**
+  * Executes every complete command line in the input buffer of the client. The output each
+  * command prints to cout is captured and appended, followed by the terminator line, to the
+  * client's output buffer.
+  *
+  * @param connection - The client whose buffered commands are executed
+  */
+void StoreServer::processBufferedCommands(ClientConnection *connection) {
+
+	size_t lineStart = 0;
+	size_t lineEnd;
+	streambuf *standardOutput = cout.rdbuf(commandOutput.rdbuf());
+	while((lineEnd = connection->inputBuffer.find('\n', lineStart)) != string::npos) {
+
+		string line = connection->inputBuffer.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		if(line != "" && line[line.length() - 1] == '\r') {
+
+			line.erase(line.length() - 1);
+		}
+		try {
+
+			store.executeCommand(line);
+		}
+		catch(exception &e) {
+
+			// executing a command never throws by design, so this is a store bug: it is answered with its
+			// cause, reported on the server's output and counted, rather than passed off as a failed command
+			cout << "The following command failed: " << line << " (" << e.what() << ")." << endl;
+			ostream(standardOutput) << "Command \"" << line << "\" threw: " << e.what() << endl;
+			store.statistics.commandExceptions++;
+		}
+		commandOutput << responseTerminator << '\n';
+
+		// answer right away unless the response depends on a journal record that is not durable
+		unsigned long long requiredSequence = store.lastJournalSequence;
+		if(store.journal == nullptr || (connection->parkedResponses.empty() && requiredSequence <= store.journal->getDurableSequence())) {
+
+			connection->outputBuffer += commandOutput.str();
+		}
+		else {
+
+			if(connection->parkedResponses.empty()) {
+
+				int fd = connection->fd;
+				store.journal->onDurable(requiredSequence, [this, fd] { releaseParkedResponses(fd); });
+			}
+			connection->parkedResponses.push_back(make_pair(requiredSequence, commandOutput.str()));
+		}
+		commandOutput.str("");
+		commandOutput.clear();
+	}
+	cout.rdbuf(standardOutput);
+	connection->inputBuffer.erase(0, lineStart);
+}
+
+/**
+  * Continuation run once the journal record the oldest parked response of a client waits for is
+  * durable. Moves every parked response that is now durable to the client's output and sends it,
+  * then waits again for the next parked response, if any. Once the journal has failed the rest will
+  * never be durable: each is answered with the failure instead of its output.
+  *
+  * @param fd - The socket descriptor of the client
+  */
+void StoreServer::releaseParkedResponses(int fd) {
+
+	map<int, ClientConnection*>::iterator it = connections.find(fd);
+	if(it == connections.end()) {
+
+		return;
+	}
+	ClientConnection *connection = it->second;
+	unsigned long long durableSequence = store.journal->getDurableSequence();
+	while(!connection->parkedResponses.empty() && connection->parkedResponses.front().first <= durableSequence) {
+
+		connection->outputBuffer += connection->parkedResponses.front().second;
+		connection->parkedResponses.pop_front();
+	}
+	if(!connection->parkedResponses.empty() && store.journal->hasFailed()) {
+
+		string failure = "The journal failed (" + store.journal->getFailure() + "): the commands this response follows are not durable.\n"
+			+ responseTerminator + "\n";
+		while(!connection->parkedResponses.empty()) {
+
+			connection->outputBuffer += failure;
+			connection->parkedResponses.pop_front();
+		}
+	}
+	if(!connection->parkedResponses.empty()) {
+
+		store.journal->onDurable(connection->parkedResponses.front().first, [this, fd] { releaseParkedResponses(fd); });
+	}
+	if(!writeToConnection(connection)) {
+
+		closeConnection(connection);
+	}
+}
+
+/**
+  * Sends as much pending output to the client as the socket accepts without blocking.
+  *
+  * @param connection - The client being written to
+  *
+  * @return Whether the connection is still open
+  */
+bool StoreServer::writeToConnection(ClientConnection *connection) {
+
+	while(connection->outputOffset < connection->outputBuffer.size()) {
+
+		ssize_t bytesSent = send(connection->fd, connection->outputBuffer.data() + connection->outputOffset,
+				connection->outputBuffer.size() - connection->outputOffset, MSG_NOSIGNAL);
+		if(bytesSent > 0) {
+
+			connection->outputOffset += bytesSent;
+			continue;
+		}
+		if(bytesSent == -1 && errno == EINTR) {
+
+			continue;
+		}
+		if(bytesSent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+
+			break;
+		}
+		return false;
+	}
+	if(connection->outputOffset == connection->outputBuffer.size()) {
+
+		connection->outputBuffer.clear();
+		connection->outputOffset = 0;
+
+		// a draining client is closed once its last response is sent
+		if(connection->draining && connection->parkedResponses.empty()) {
+
+			return false;
+		}
+	}
+	updateEventInterest(connection);
+
+	// reads were paused while output was backed up; resume any commands still waiting
+	if(connection->inputBuffer.find('\n') != string::npos && connection->outputBuffer.size() - connection->outputOffset < maxPendingOutput) {
+
+		processBufferedCommands(connection);
+		return writeToConnection(connection);
+	}
+	return true;
+}
+
+/**
+  * Watches the client for writability only while it has unsent output, and for readability only
+  * while its unsent output is below "maxPendingOutput" and it has not closed its end.
+  *
+  * @param connection - The client whose registration is updated
+  */
+void StoreServer::updateEventInterest(ClientConnection *connection) {
+
+	size_t pendingOutput = connection->outputBuffer.size() - connection->outputOffset;
+	uint32_t events = 0;
+	if(pendingOutput < maxPendingOutput && !connection->draining) {
+
+		events |= EPOLLIN;
+	}
+	if(pendingOutput > 0) {
+
+		events |= EPOLLOUT;
+	}
+	if(events == connection->watchedEvents) {
+
+		return;
+	}
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = events;
+	event.data.fd = connection->fd;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+	connection->watchedEvents = events;
+}
+
+/**
+  * Unregisters and closes the client socket and deletes the connection.
+  *
+  * @param connection - The client to be closed
+  */
+void StoreServer::closeConnection(ClientConnection *connection) {
+
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+	close(connection->fd);
+	connections.erase(connection->fd);
+	delete(connection);
+}
@@ -0,0 +1,127 @@
+#ifndef STORESERVER_H
+#define STORESERVER_H
+
+#include "MovieRentalStore.h"
+
+#include <sys/epoll.h>
+
+using namespace std;
+
+// a client connected to the store server. holds the bytes read from the client that do not yet
+// form a complete command line, as well as the responses that have not yet been written back.
+struct ClientConnection {
+
+	// socket descriptor of the client
+	int fd;
+
+	// bytes received from the client that have not been processed as commands yet
+	string inputBuffer;
+
+	// response bytes waiting to be sent to the client
+	string outputBuffer;
+
+	// number of bytes of "outputBuffer" already sent to the client
+	size_t outputOffset = 0;
+
+	// responses waiting for the journal record (sequence number) they depend on to become durable,
+	// oldest first. kept in order so a client always receives its responses in command order
+	deque<pair<unsigned long long, string>> parkedResponses;
+
+	// the epoll events the connection is currently registered for
+	uint32_t watchedEvents = EPOLLIN;
+
+	// whether the client closed its end: it is no longer read, and the connection is closed once its
+	// parked and unsent responses have been sent (as the journal and the socket allow)
+	bool draining = false;
+
+	ClientConnection(int fd) : fd(fd) {}
+};
+
+// a long running request server for a movie rental store. accepts the line protocol of the command
+// file (B, R, H and I commands) over a Unix domain socket or a loopback TCP port. connections are
+// multiplexed by a single epoll event loop and any number of commands may be pipelined per connection.
+// every response is the output of the command followed by a line holding only the terminator ".".
+// when the store has a journal, a response is held back until every borrow/return executed before
+// it is durable, while commands from other clients keep being executed.
+class StoreServer {
+
+private:
+
+	// the store commands are executed against
+	MovieRentalStore &store;
+
+	// listening socket and epoll instance descriptors
+	int listenFd = -1;
+	int epollFd = -1;
+
+	// path of the bound Unix domain socket (empty for TCP), unlinked at shutdown
+	string socketPath;
+
+	// all open client connections, keyed by socket descriptor
+	map<int, ClientConnection*> connections;
+
+	// event loop continues while true
+	bool running = false;
+
+	// collects the output a command prints to cout so it can be sent to the client
+	stringstream commandOutput;
+
+	// the maximum number of epoll events handled per wakeup
+	const int maxEventsPerWait = 1024;
+
+	// the maximum number of bytes buffered for a client before reads from it are paused
+	const size_t maxPendingOutput = 4 * 1024 * 1024;
+
+	// the maximum number of bytes read from a client without a complete command line among them; a
+	// client sending more is dropped
+	const size_t maxPendingInput = 1024 * 1024;
+
+	// creates the epoll instance and registers the listening socket
+	bool setUpEventLoop();
+
+	// accepts all pending connections on the listening socket
+	void acceptConnections();
+
+	// reads all available bytes from client and executes every complete command line received
+	bool readFromConnection(ClientConnection *);
+
+	// writes as much of the pending output of client as the socket accepts
+	bool writeToConnection(ClientConnection *);
+
+	// executes every complete command line in the input buffer of client
+	void processBufferedCommands(ClientConnection *);
+
+	// moves the parked responses of client (by descriptor) that became durable to its output
+	void releaseParkedResponses(int);
+
+	// registers the client for reads and/or writes depending on its pending output
+	void updateEventInterest(ClientConnection *);
+
+	// closes the client socket and releases the connection
+	void closeConnection(ClientConnection *);
+
+public:
+
+	// the line sent after the output of each command to mark the end of its response
+	static const string responseTerminator;
+
+	// StoreServer constructor - commands are executed against the store argument
+	StoreServer(MovieRentalStore &);
+
+	// StoreServer destructor - closes every open connection and the listening socket
+	~StoreServer();
+
+	// binds and listens on a Unix domain socket at the given path
+	bool listenUnixSocket(string);
+
+	// binds and listens on the given TCP port of the loopback interface
+	bool listenLoopbackPort(int);
+
+	// runs the event loop until "stop" is called or an unrecoverable error occurs
+	bool run();
+
+	// requests the event loop to exit after the current iteration
+	void stop();
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "StoreStatistics.h"
+
+#include <iomanip>
+
+/**
+  * Gets the bucket a value is counted in. Values below "subBucketCount" get a bucket each; larger
+  * values are bucketed by their power of two range and by the "subBucketBits" bits below the top bit.
+  *
+  * @param value - The value (nanoseconds)
+  *
+  * @return The bucket index
+  */
+int LatencyHistogram::bucketIndex(long long value) {
+
+	if(value < subBucketCount) {
+
+		return value < 0 ? 0 : (int) value;
+	}
+	int topBit = 63 - __builtin_clzll((unsigned long long) value);
+	int range = topBit - subBucketBits + 1;
+	if(range > rangeCount) {
+
+		return (rangeCount + 1) * subBucketCount - 1;
+	}
+	int subBucket = (int) ((value >> (topBit - subBucketBits)) & (subBucketCount - 1));
+	return range * subBucketCount + subBucket;
+}
+
+/**
+  * Gets the largest value counted in a bucket.
+  *
+  * @param index - The bucket index
+  *
+  * @return The bucket's upper bound (nanoseconds)
+  */
+long long LatencyHistogram::bucketUpperBound(int index) {
+
+	int range = index / subBucketCount;
+	long long subBucket = index % subBucketCount;
+	if(range == 0) {
+
+		return subBucket;
+	}
+	int shift = range - 1;
+	return ((subBucketCount + subBucket + 1) << shift) - 1;
+}
+
+/**
+  * Records a value.
+  *
+  * @param value - The value (nanoseconds)
+  */
+void LatencyHistogram::record(long long value) {
+
+	counts[bucketIndex(value)]++;
+	if(totalCount == 0 || value < minimumValue) {
+
+		minimumValue = value;
+	}
+	if(value > maximumValue) {
+
+		maximumValue = value;
+	}
+	totalCount++;
+	sum += value;
+}
+
+/**
+  * Gets the number of values recorded.
+  *
+  * @return The number of values recorded
+  */
+long long LatencyHistogram::getCount() const {
+
+	return totalCount;
+}
+
+/**
+  * Gets the value below which a given percentage of the recorded values fall, within the
+  * precision of the buckets.
+  *
+  * @param percentile - The percentile (0-100)
+  *
+  * @return The percentile value (nanoseconds), 0 if nothing was recorded
+  */
+long long LatencyHistogram::getPercentile(double percentile) const {
+
+	if(totalCount == 0) {
+
+		return 0;
+	}
+	long long target = (long long) (percentile / 100.0 * totalCount + 0.5);
+	if(target < 1) {
+
+		target = 1;
+	}
+	long long seen = 0;
+	for(int i = 0; i < (rangeCount + 1) * subBucketCount; i++) {
+
+		seen += counts[i];
+		if(seen >= target) {
+
+			long long bound = bucketUpperBound(i);
+			return bound < maximumValue ? bound : maximumValue;
+		}
+	}
+	return maximumValue;
+}
+
+/**
+  * Gets the mean of the recorded values.
+  *
+  * @return The mean (nanoseconds), 0 if nothing was recorded
+  */
+double LatencyHistogram::getMean() const {
+
+	return totalCount == 0 ? 0 : sum / totalCount;
+}
+
+/**
+  * Gets the largest recorded value.
+  *
+  * @return The maximum (nanoseconds)
+  */
+long long LatencyHistogram::getMaximum() const {
+
+	return maximumValue;
+}
+
+/**
+  * Prints a one line summary of the histogram, in microseconds.
+  *
+  * @param out - The stream printed to
+  * @param name - The name the line is labeled with
+  */
+void LatencyHistogram::print(ostream &out, string name) const {
+
+	ios::fmtflags flags = out.flags();
+	out << left << setw(12) << name << right << " count=" << setw(9) << totalCount << fixed << setprecision(2)
+		<< "  mean=" << getMean() / 1000.0 << "  p50=" << getPercentile(50) / 1000.0
+		<< "  p90=" << getPercentile(90) / 1000.0 << "  p99=" << getPercentile(99) / 1000.0
+		<< "  p999=" << getPercentile(99.9) / 1000.0 << "  max=" << maximumValue / 1000.0 << " (us)" << endl;
+	out.flags(flags);
+}
+
+/**
+  * Prints one inventory's counters.
+  *
+  * @param out - The stream printed to
+  * @param name - The genre name
+  * @param counters - The inventory counters
+  */
+static void printInventoryCounters(ostream &out, string name, const InventoryCounters &counters) {
+
+	double probesPerSearch = counters.searches == 0 ? 0 : (double) counters.probes / counters.searches;
+	out << "  " << left << setw(10) << name << right << " searches=" << counters.searches << " probes=" << counters.probes
+		<< " (" << fixed << setprecision(2) << probesPerSearch << "/search) out of stock=" << counters.outOfStock
+		<< " at max stock=" << counters.stockAtMaximum << " not found=" << counters.notFound << endl;
+}
+
+/**
+  * Prints every histogram and counter.
+  *
+  * @param out - The stream printed to
+  */
+void StoreStatistics::print(ostream &out) const {
+
+	ios::fmtflags flags = out.flags();
+	out << "----------Command Latency----------" << endl;
+	borrowLatency.print(out, "Borrow");
+	returnLatency.print(out, "Return");
+	historyLatency.print(out, "History");
+	inventoryLatency.print(out, "Inventory");
+	out << "----------Borrow/Return Latency By Genre----------" << endl;
+	comedyLatency.print(out, "Comedy");
+	dramaLatency.print(out, "Drama");
+	classicsLatency.print(out, "Classics");
+	out << "----------Inventory----------" << endl;
+	printInventoryCounters(out, "Comedy", comedyInventory);
+	printInventoryCounters(out, "Drama", dramaInventory);
+	printInventoryCounters(out, "Classics", classicsInventory);
+	double probesPerLookup = customerLookups == 0 ? 0 : (double) customerProbes / customerLookups;
+	out << "----------Customers----------" << endl;
+	out << "  lookups=" << customerLookups << " probes=" << customerProbes << " (" << fixed << setprecision(2)
+		<< probesPerLookup << "/lookup)" << endl;
+	out << "----------Allocations----------" << endl;
+	out << "  customer records=" << customerAllocations << " borrow lists=" << borrowListAllocations
+		<< " movie records=" << movieRecordAllocations << endl;
+	out << "----------Failures----------" << endl;
+	out << "  unknown customer=" << unknownCustomer << " borrow limit reached=" << borrowLimitReached
+		<< " not borrowed=" << notBorrowed << " invalid media code=" << invalidMediaCode
+		<< " invalid genre code=" << invalidGenreCode << " invalid command=" << invalidCommand << " malformed lines=" << malformedLines
+		<< " command exceptions=" << commandExceptions << endl;
+	out.flags(flags);
+}
@@ -0,0 +1,125 @@
+#ifndef STORESTATISTICS_H
+#define STORESTATISTICS_H
+
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// a latency histogram with HDR-style log-linear buckets: every power of two range of values is split
+// into "subBucketCount" equal sub-buckets, so any recorded value is reported within ~3% of its true
+// value while the histogram stays a fixed size array. recording is a few instructions and never allocates.
+class LatencyHistogram {
+
+private:
+
+	// number of linear sub-buckets per power of two (must be a power of two)
+	static const int subBucketBits = 5;
+	static const int subBucketCount = 1 << subBucketBits;
+
+	// number of power of two ranges covered (values up to 2^(rangeCount + subBucketBits) ns, ~9 minutes)
+	static const int rangeCount = 35;
+
+	// recorded value counts per bucket
+	long long counts[(rangeCount + 1) * subBucketCount] = {};
+
+	long long totalCount = 0;
+	long long minimumValue = 0;
+	long long maximumValue = 0;
+	double sum = 0;
+
+	// gets the bucket a value is counted in
+	static int bucketIndex(long long);
+
+	// gets the largest value counted in a bucket
+	static long long bucketUpperBound(int);
+
+public:
+
+	// records a value (nanoseconds)
+	void record(long long);
+
+	// gets the number of values recorded
+	long long getCount() const;
+
+	// gets the value (nanoseconds) below which the percentile argument (0-100) of values fall
+	long long getPercentile(double) const;
+
+	// gets the mean of the values recorded
+	double getMean() const;
+
+	// gets the largest value recorded
+	long long getMaximum() const;
+
+	// prints count, mean, p50, p90, p99, p999 and max on one line (microseconds)
+	void print(ostream &, string) const;
+};
+
+// counters maintained by an inventory (ArrayBasedBSTree) while statistics are enabled
+struct InventoryCounters {
+
+	// number of searches of the tree, and of nodes compared during those searches
+	long long searches = 0;
+	long long probes = 0;
+
+	// stock changes that failed because the movie was out of stock, already fully stocked, or not found
+	long long outOfStock = 0;
+	long long stockAtMaximum = 0;
+	long long notFound = 0;
+};
+
+// runtime statistics of a movie rental store: latency histograms per command type and per genre,
+// inventory and customer table probe counters, allocation counts and command failure reasons.
+// collection is off by default; while off every hook is a single predictable branch.
+struct StoreStatistics {
+
+	// whether statistics are being collected
+	bool enabled = false;
+
+	// latency of commands by type: borrow, return, history and inventory
+	LatencyHistogram borrowLatency;
+	LatencyHistogram returnLatency;
+	LatencyHistogram historyLatency;
+	LatencyHistogram inventoryLatency;
+
+	// latency of borrow/return commands by genre
+	LatencyHistogram comedyLatency;
+	LatencyHistogram dramaLatency;
+	LatencyHistogram classicsLatency;
+
+	// inventory counters by genre
+	InventoryCounters comedyInventory;
+	InventoryCounters dramaInventory;
+	InventoryCounters classicsInventory;
+
+	// customer hash table lookups, and customers compared during those lookups
+	long long customerLookups = 0;
+	long long customerProbes = 0;
+
+	// heap allocations made by the command path: customer records, borrow lists and movie records
+	long long customerAllocations = 0;
+	long long borrowListAllocations = 0;
+	long long movieRecordAllocations = 0;
+
+	// command failure reasons
+	long long unknownCustomer = 0;
+	long long borrowLimitReached = 0;
+	long long notBorrowed = 0;
+	long long invalidMediaCode = 0;
+	long long invalidGenreCode = 0;
+	long long invalidCommand = 0;
+
+	// lines of the movie, customer and command files skipped for a malformed number (a customer ID,
+	// stock, release year or month); counted whether or not statistics are enabled, so the file scans
+	// can report them
+	long long malformedLines = 0;
+
+	// commands the server answered as failed because executing them threw (a store bug, not a bad
+	// command); counted whether or not statistics are enabled
+	long long commandExceptions = 0;
+
+	// prints every histogram and counter
+	void print(ostream &) const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "StringTable.h"
+
+#include <cstring>
+
+/**
+  * Constructor interns the empty string at index 0.
+  */
+StringTable::StringTable() {
+
+	strings.push_back(string_view());
+	indexes.emplace(string_view(), 0);
+}
+
+/**
+  * Gets the table, constructed on first use so it can be used during static initialization.
+  *
+  * @return The string table
+  */
+StringTable &StringTable::instance() {
+
+	static StringTable table;
+	return table;
+}
+
+/**
+  * Copies the characters of a string into the current chunk, starting a new chunk when it does
+  * not fit. Strings longer than a chunk get a chunk of their own.
+  *
+  * @param text - The string
+  *
+  * @return A view of the stored copy
+  */
+string_view StringTable::store(string_view text) {
+
+	if(text.size() > chunkSize) {
+
+		chunks.push_back(unique_ptr<char[]>(new char[text.size()]));
+		chunkBytes += text.size();
+		memcpy(chunks.back().get(), text.data(), text.size());
+		return string_view(chunks.back().get(), text.size());
+	}
+	if(text.size() > chunkSize - chunkUsed) {
+
+		chunks.push_back(unique_ptr<char[]>(new char[chunkSize]));
+		chunkBytes += chunkSize;
+		currentChunk = chunks.back().get();
+		chunkUsed = 0;
+	}
+	char *characters = currentChunk + chunkUsed;
+	memcpy(characters, text.data(), text.size());
+	chunkUsed += text.size();
+	return string_view(characters, text.size());
+}
+
+/**
+  * Gets the index of a string, interning it first if it is not in the table.
+  *
+  * @param text - The string
+  *
+  * @return The string's index
+  */
+uint32_t StringTable::intern(string_view text) {
+
+	StringTable &table = instance();
+	unordered_map<string_view, uint32_t>::iterator it = table.indexes.find(text);
+	if(it != table.indexes.end()) {
+
+		return it->second;
+	}
+	string_view stored = table.store(text);
+	uint32_t index = table.strings.size();
+	table.strings.push_back(stored);
+	table.indexes.emplace(stored, index);
+	return index;
+}
+
+/**
+  * Gets the index of a string already in the table. Unlike "intern", a string not in the table is
+  * not added: a probe for a name nothing holds (e.g. a borrow of a title not carried) leaves the
+  * table as it was.
+  *
+  * @param text - The string
+  * @param index - The string's index, assigned if it is in the table
+  *
+  * @return Whether the string is in the table
+  */
+bool StringTable::find(string_view text, uint32_t &index) {
+
+	StringTable &table = instance();
+	unordered_map<string_view, uint32_t>::iterator it = table.indexes.find(text);
+	if(it == table.indexes.end()) {
+
+		return false;
+	}
+	index = it->second;
+	return true;
+}
+
+/**
+  * Gets the string at an index.
+  *
+  * @param index - The index, as returned by "intern"
+  *
+  * @return The string
+  */
+string_view StringTable::lookup(uint32_t index) {
+
+	return instance().strings[index];
+}
+
+/**
+  * Gets the number of strings interned, the empty string included.
+  *
+  * @return The number of strings
+  */
+size_t StringTable::getCount() {
+
+	return instance().strings.size();
+}
+
+/**
+  * Gets the bytes held by the table: the character chunks, the vector of views and an estimate of
+  * the hash map (bucket array plus one node per string).
+  *
+  * @return The table's bytes
+  */
+size_t StringTable::getBytes() {
+
+	StringTable &table = instance();
+	size_t nodeBytes = sizeof(void*) + sizeof(pair<const string_view, uint32_t>) + sizeof(size_t);
+	return table.chunkBytes + table.strings.capacity() * sizeof(string_view) + table.indexes.bucket_count() * sizeof(void*)
+		+ table.indexes.size() * nodeBytes;
+}
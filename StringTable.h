@@ -0,0 +1,128 @@
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// the process wide table of interned strings. every distinct string is stored once, in large
+// character chunks that are never moved or freed, and is identified by its index in the table.
+// index 0 is the empty string. the table is not synchronized: strings are interned by the thread
+// executing store commands.
+class StringTable {
+
+private:
+
+	// size of a character chunk (longer strings get a chunk of their own)
+	static const size_t chunkSize = 64 * 1024;
+
+	// the characters of every interned string
+	vector<unique_ptr<char[]>> chunks;
+
+	// the chunk strings are being copied into, and the number of its bytes used
+	char *currentChunk = nullptr;
+	size_t chunkUsed = chunkSize;
+
+	// the bytes of every chunk
+	size_t chunkBytes = 0;
+
+	// the interned strings by index, and the index of every interned string
+	vector<string_view> strings;
+	unordered_map<string_view, uint32_t> indexes;
+
+	StringTable();
+
+	// gets the table
+	static StringTable &instance();
+
+	// copies the characters of a string into a chunk
+	string_view store(string_view);
+
+public:
+
+	// gets the index of the string argument, interning it if it is not in the table yet
+	static uint32_t intern(string_view);
+
+	// gets the index of the string argument into the second argument, without interning it; false if
+	// it is not in the table
+	static bool find(string_view, uint32_t &);
+
+	// gets the string at the index argument
+	static string_view lookup(uint32_t);
+
+	// gets the number of strings interned
+	static size_t getCount();
+
+	// gets the bytes held by the table (characters, index vector and hash map)
+	static size_t getBytes();
+};
+
+// a string stored once in the string table. copying, equality and emptiness checks only touch the
+// 4 byte index; ordering compares the characters (unless the indexes are equal).
+class InternedString {
+
+private:
+
+	uint32_t index = 0;
+
+public:
+
+	// InternedString default constructor - the empty string
+	InternedString() {}
+
+	// InternedString constructors intern the string argument
+	InternedString(const string &text) : index(StringTable::intern(text)) {}
+	InternedString(string_view text) : index(StringTable::intern(text)) {}
+
+	// gets the characters of the string
+	string_view view() const {
+
+		return StringTable::lookup(index);
+	}
+
+	// gets the index of the string in the string table
+	uint32_t getIndex() const {
+
+		return index;
+	}
+
+	// evaluates whether the string is empty
+	bool empty() const {
+
+		return index == 0;
+	}
+
+	bool operator==(const InternedString &other) const {
+
+		return index == other.index;
+	}
+
+	bool operator!=(const InternedString &other) const {
+
+		return index != other.index;
+	}
+
+	bool operator<(const InternedString &other) const {
+
+		return index != other.index && view() < other.view();
+	}
+
+	bool operator>(const InternedString &other) const {
+
+		return index != other.index && view() > other.view();
+	}
+
+	// stream insertion operator writes the characters of the string
+	friend ostream &operator<<(ostream &out, const InternedString &text) {
+
+		return out << text.view();
+	}
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "TitleSearchIndex.h"
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+#include <cctype>
+
+/**
+  * Normalizes text for indexing and searching: letters are lowercased, letters and digits (and the
+  * bytes of multibyte characters) are kept, and every run of other characters becomes one space.
+  *
+  * @param text - The text
+  *
+  * @return The normalized text, without leading or trailing spaces
+  */
+string TitleSearchIndex::normalize(string_view text) {
+
+	string normalized;
+	normalized.reserve(text.size());
+	for(size_t i = 0; i < text.size(); i++) {
+
+		unsigned char c = text[i];
+		if(isalnum(c) || c >= 128) {
+
+			normalized += (char) tolower(c);
+		}
+		else if(!normalized.empty() && normalized.back() != ' ') {
+
+			normalized += ' ';
+		}
+	}
+	if(!normalized.empty() && normalized.back() == ' ') {
+
+		normalized.pop_back();
+	}
+	return normalized;
+}
+
+/**
+  * Gets the distinct trigrams of normalized text. The text is padded with a space on either side,
+  * so the first and last characters of the text anchor trigrams of their own.
+  *
+  * @param normalized - The normalized text
+  *
+  * @return The trigrams (three characters packed in the low bytes), sorted
+  */
+vector<uint32_t> TitleSearchIndex::getTrigrams(const string &normalized) {
+
+	vector<uint32_t> trigrams;
+	string padded = " " + normalized + " ";
+	for(size_t i = 0; i + 3 <= padded.size(); i++) {
+
+		trigrams.push_back((unsigned char) padded[i] << 16 | (unsigned char) padded[i + 1] << 8 | (unsigned char) padded[i + 2]);
+	}
+	sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+	return trigrams;
+}
+
+/**
+  * Counts the trigrams of a sorted list an entry holds, by merging the list with its trigrams.
+  *
+  * @param list - A sorted list of distinct trigrams
+  * @param entry - The index of the entry
+  *
+  * @return The number of trigrams of the list the entry holds
+  */
+size_t TitleSearchIndex::countShared(const vector<uint32_t> &list, uint32_t entry) const {
+
+	const uint32_t *held = trigrams.data() + entries[entry].firstTrigram;
+	const uint32_t *heldEnd = held + entries[entry].trigramCount;
+	size_t shared = 0;
+	size_t i = 0;
+	// branch free: the lists share few trigrams, so which one advances is unpredictable
+	while(i < list.size() && held != heldEnd) {
+
+		uint32_t listed = list[i];
+		uint32_t heldTrigram = *held;
+		shared += listed == heldTrigram;
+		i += listed <= heldTrigram;
+		held += heldTrigram <= listed;
+	}
+	return shared;
+}
+
+/**
+  * Indexes a title. A title already indexed under the same command is replaced.
+  *
+  * @param command - The movie portion of the title's borrow command, genre code first
+  * @param description - The text the title is searched by: its title, release date, director and major actor
+  */
+void TitleSearchIndex::add(const string &command, const string &description) {
+
+	remove(command);
+	uint32_t entry = entries.size();
+	vector<uint32_t> titleTrigrams = getTrigrams(normalize(description));
+	titleTrigrams.resize(min(titleTrigrams.size(), (size_t) UINT16_MAX));
+	for(size_t i = 0; i < titleTrigrams.size(); i++) {
+
+		postings[titleTrigrams[i]].push_back(entry);
+	}
+	entries.push_back({command, description, (uint32_t) trigrams.size(), (uint16_t) titleTrigrams.size(), true});
+	trigrams.insert(trigrams.end(), titleTrigrams.begin(), titleTrigrams.end());
+	commandEntries[command] = entry;
+	normalizedCommands[normalize(command)].push_back(entry);
+	liveCount++;
+}
+
+/**
+  * Retires a title. Its postings stay, and are skipped by searches.
+  *
+  * @param command - The movie portion of the title's borrow command, genre code first
+  *
+  * @return Whether the title was indexed
+  */
+bool TitleSearchIndex::remove(const string &command) {
+
+	unordered_map<string, uint32_t>::iterator found = commandEntries.find(command);
+	if(found == commandEntries.end()) {
+
+		return false;
+	}
+	uint32_t entry = found->second;
+	entries[entry].live = false;
+	commandEntries.erase(found);
+	unordered_map<string, vector<uint32_t>>::iterator sameCommands = normalizedCommands.find(normalize(command));
+	sameCommands->second.erase(std::remove(sameCommands->second.begin(), sameCommands->second.end(), entry), sameCommands->second.end());
+	if(sameCommands->second.empty()) {
+
+		normalizedCommands.erase(sameCommands);
+	}
+	liveCount--;
+	return true;
+}
+
+/**
+  * Searches the titles closest to a query. The score of a title is the share of the query's
+  * trigrams it holds, so a query naming part of a title (its director, say) scores as high as the
+  * full title would; between titles scoring the same, the titles with fewer trigrams come first.
+  * Candidates are the titles holding one of the rarest quarter of the query's trigrams (a title
+  * holding none of them scores below three quarters, and is only found through the others), and
+  * only the candidates holding the most of them are scored against every trigram, by merging the
+  * query's trigrams with their own. A search therefore reads the shortest postings alone and never
+  * scans the titles.
+  *
+  * @param query - The text searched, e.g. a title with a typo
+  * @param count - The largest number of titles returned
+  * @param genre - The genre code of the titles returned (0 for any genre)
+  * @param minimumScore - The lowest score of the titles returned
+  *
+  * @return The titles found, best first
+  */
+vector<TitleSearchIndex::Match> TitleSearchIndex::search(const string &query, size_t count, char genre, double minimumScore) {
+
+	vector<Match> matches;
+	vector<uint32_t> queryTrigrams = getTrigrams(normalize(query));
+	if(queryTrigrams.empty() || count == 0) {
+
+		return matches;
+	}
+
+	// the postings of the query's trigrams, shortest first (trigrams no title holds have none)
+	vector<const vector<uint32_t>*> lists;
+	for(size_t i = 0; i < queryTrigrams.size(); i++) {
+
+		unordered_map<uint32_t, vector<uint32_t>>::const_iterator posting = postings.find(queryTrigrams[i]);
+		if(posting != postings.end()) {
+
+			lists.push_back(&posting->second);
+		}
+	}
+	sort(lists.begin(), lists.end(), [](const vector<uint32_t> *first, const vector<uint32_t> *second) {
+
+		return first->size() < second->size();
+	});
+	size_t rarest = min(lists.size(), min(queryTrigrams.size() / 4, maxMissingTrigrams) + 1);
+
+	// count the rarest trigrams every title holds
+	hits.resize(entries.size());
+	for(size_t i = 0; i < rarest; i++) {
+
+		for(uint32_t entry : *lists[i]) {
+
+			if(hits[entry]++ == 0) {
+
+				touched.push_back(entry);
+			}
+		}
+	}
+	vector<uint32_t> candidates;
+	for(uint32_t entry : touched) {
+
+		if(entries[entry].live && (genre == 0 || entries[entry].command[0] == genre)) {
+
+			candidates.push_back(entry);
+		}
+	}
+	size_t candidateCount = min(candidates.size(), count * candidatesPerResult);
+	partial_sort(candidates.begin(), candidates.begin() + candidateCount, candidates.end(), [&](uint32_t first, uint32_t second) {
+
+		return hits[first] > hits[second] || (hits[first] == hits[second] && first < second);
+	});
+
+	// score the best candidates against every trigram of the query
+	vector<pair<size_t, uint32_t>> scored;
+	for(size_t i = 0; i < candidateCount; i++) {
+
+		size_t shared = countShared(queryTrigrams, candidates[i]);
+		if(shared >= minimumScore * queryTrigrams.size()) {
+
+			scored.push_back({shared, candidates[i]});
+		}
+	}
+	for(uint32_t entry : touched) {
+
+		hits[entry] = 0;
+	}
+	touched.clear();
+
+	// best score first, then fewest trigrams, then command
+	size_t resultCount = min(scored.size(), count);
+	partial_sort(scored.begin(), scored.begin() + resultCount, scored.end(), [&](const pair<size_t, uint32_t> &first, const pair<size_t, uint32_t> &second) {
+
+		if(first.first != second.first) {
+
+			return first.first > second.first;
+		}
+		if(entries[first.second].trigramCount != entries[second.second].trigramCount) {
+
+			return entries[first.second].trigramCount < entries[second.second].trigramCount;
+		}
+		return entries[first.second].command < entries[second.second].command;
+	});
+	for(size_t i = 0; i < resultCount; i++) {
+
+		const Entry &entry = entries[scored[i].second];
+		matches.push_back({entry.command, entry.description, (double) scored[i].first / queryTrigrams.size()});
+	}
+	return matches;
+}
+
+/**
+  * Finds the titles whose command equals a command once both are normalized, e.g. "f you've got
+  * MAIL 1998" finds "F You've Got Mail, 1998".
+  *
+  * @param command - The movie portion of a borrow command, genre code first
+  *
+  * @return The titles found (a score of 1 each)
+  */
+vector<TitleSearchIndex::Match> TitleSearchIndex::findNormalized(const string &command) const {
+
+	vector<Match> matches;
+	unordered_map<string, vector<uint32_t>>::const_iterator found = normalizedCommands.find(normalize(command));
+	if(found != normalizedCommands.end()) {
+
+		for(uint32_t entry : found->second) {
+
+			matches.push_back({entries[entry].command, entries[entry].description, 1});
+		}
+	}
+	return matches;
+}
+
+/**
+  * Gets the number of titles indexed, retired titles excluded.
+  *
+  * @return The number of titles
+  */
+size_t TitleSearchIndex::getSize() const {
+
+	return liveCount;
+}
+
+/**
+  * Gets the bytes held by the index: its entries, their strings and trigrams, the posting lists, the command
+  * maps (nodes and buckets, approximately) and the scratch of searches.
+  *
+  * @return The bytes held
+  */
+size_t TitleSearchIndex::getBytes() const {
+
+	size_t bytes = entries.capacity() * sizeof(Entry) + trigrams.capacity() * sizeof(uint32_t) + hits.capacity() * sizeof(uint16_t) + touched.capacity() * sizeof(uint32_t);
+	for(const Entry &entry : entries) {
+
+		bytes += MemoryAccounting::stringHeapBytes(entry.command) + MemoryAccounting::stringHeapBytes(entry.description);
+	}
+	const size_t nodeOverhead = 2 * sizeof(void*);
+	bytes += postings.bucket_count() * sizeof(void*) + commandEntries.bucket_count() * sizeof(void*) + normalizedCommands.bucket_count() * sizeof(void*);
+	for(const pair<const uint32_t, vector<uint32_t>> &posting : postings) {
+
+		bytes += sizeof(posting) + nodeOverhead + posting.second.capacity() * sizeof(uint32_t);
+	}
+	for(const pair<const string, uint32_t> &command : commandEntries) {
+
+		bytes += sizeof(command) + nodeOverhead + MemoryAccounting::stringHeapBytes(command.first);
+	}
+	for(const pair<const string, vector<uint32_t>> &command : normalizedCommands) {
+
+		bytes += sizeof(command) + nodeOverhead + MemoryAccounting::stringHeapBytes(command.first) + command.second.capacity() * sizeof(uint32_t);
+	}
+	return bytes;
+}
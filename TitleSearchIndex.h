@@ -0,0 +1,107 @@
+#ifndef TITLESEARCHINDEX_H
+#define TITLESEARCHINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// an approximate ("did you mean") and case insensitive index over the titles of the catalog, kept
+// beside the genre inventories and never consulted by borrow/return commands that find their movie.
+// every title is indexed under the movie portion of its borrow command (e.g. "F You've Got Mail,
+// 1998") and searched by the trigrams of its title, release date, director and major actor. text is normalized
+// before indexing and searching: lowercased, every run of other characters than letters and digits
+// reduced to one space. titles retired are only marked, their postings are skipped by searches.
+class TitleSearchIndex {
+
+public:
+
+	// a title found by a search
+	struct Match {
+
+		// the movie portion of the title's borrow command, genre code first
+		string command;
+
+		// the title, release date, director and major actor of the title
+		string description;
+
+		// the share of the query's trigrams the title holds (1 when it holds every one)
+		double score;
+	};
+
+private:
+
+	// a title indexed
+	struct Entry {
+
+		string command;
+		string description;
+
+		// the distinct trigrams of the description, in "trigrams" from the first index on
+		uint32_t firstTrigram;
+		uint16_t trigramCount;
+		bool live;
+	};
+
+	// the most trigrams of a query a title may miss (a typo misses up to four) and still always be
+	// found; titles missing more are found only through the rarer trigrams they do hold
+	static constexpr size_t maxMissingTrigrams = 4;
+
+	// the number of candidates scored against every trigram of a query, per result requested
+	static constexpr size_t candidatesPerResult = 8;
+
+	vector<Entry> entries;
+
+	// the sorted trigrams of every entry, one run per entry
+	vector<uint32_t> trigrams;
+
+	// the entries holding every trigram, in ascending order
+	unordered_map<uint32_t, vector<uint32_t>> postings;
+
+	// the live entry of every command, and the live entries of every normalized command
+	unordered_map<string, uint32_t> commandEntries;
+	unordered_map<string, vector<uint32_t>> normalizedCommands;
+
+	// number of live entries
+	size_t liveCount = 0;
+
+	// scratch of searches: trigrams shared by every entry touched, and the entries touched
+	vector<uint16_t> hits;
+	vector<uint32_t> touched;
+
+	// gets the distinct trigrams of normalized text, sorted
+	static vector<uint32_t> getTrigrams(const string &);
+
+	// counts the trigrams of the sorted list argument the entry at the index argument holds
+	size_t countShared(const vector<uint32_t> &, uint32_t) const;
+
+public:
+
+	// normalizes text: lowercase letters and digits, words separated by single spaces
+	static string normalize(string_view);
+
+	// indexes a title: its command (genre code first) and its description (title, release date,
+	// director, actor)
+	void add(const string &, const string &);
+
+	// retires the title of the command argument
+	bool remove(const string &);
+
+	// gets the titles closest to the query (first argument), at most the count argument, of the genre
+	// code argument (0 for any genre) and scoring at least the last argument; best first
+	vector<Match> search(const string &, size_t, char = 0, double = 0);
+
+	// gets the titles whose command equals the argument once both are normalized
+	vector<Match> findNormalized(const string &) const;
+
+	// gets the number of titles indexed (retired titles excluded)
+	size_t getSize() const;
+
+	// gets the bytes held by the index
+	size_t getBytes() const;
+};
+
+#endif
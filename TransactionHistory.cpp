@@ -0,0 +1,298 @@
+#include "TransactionHistory.h"
+#include "MemoryAccounting.h"
+
+#include <cstring>
+
+long long TransactionHistory::blocksDecoded = 0;
+
+// the shortest copy encoded (a shorter one costs more than its literals), the number of earlier
+// positions with the same leading bytes searched for the longest copy, and the size of the table
+// finding them
+static const size_t minimumMatch = 4;
+static const int matchCandidates = 16;
+static const size_t hashBits = 12;
+
+/**
+  * Appends an unsigned integer as a varint: 7 bits per byte, least significant first, the high bit
+  * set on every byte but the last.
+  *
+  * @param output - The string appended to
+  * @param value - The integer
+  */
+static void appendVarint(string &output, size_t value) {
+
+	while(value >= 0x80) {
+
+		output += (char) (value | 0x80);
+		value >>= 7;
+	}
+	output += (char) value;
+}
+
+/**
+  * Reads a varint.
+  *
+  * @param input - The bytes read
+  * @param position - The position of the varint, moved past it
+  *
+  * @return The integer (0 if the bytes end first)
+  */
+static size_t readVarint(string_view input, size_t &position) {
+
+	size_t value = 0;
+	for(int shift = 0; position < input.size(); shift += 7) {
+
+		unsigned char byte = input[position++];
+		value |= (size_t) (byte & 0x7f) << shift;
+		if(byte < 0x80) {
+
+			break;
+		}
+	}
+	return value;
+}
+
+/**
+  * Hashes the leading bytes of a position, to find earlier positions starting with the same bytes.
+  *
+  * @param bytes - The bytes (at least "minimumMatch" of them)
+  *
+  * @return The hash, "hashBits" wide
+  */
+static uint32_t hashPosition(const char *bytes) {
+
+	uint32_t leading;
+	memcpy(&leading, bytes, sizeof(leading));
+	return (leading * 2654435761u) >> (32 - hashBits);
+}
+
+/**
+  * Gets the length of the bytes two positions have in common, compared 8 at a time.
+  *
+  * @param earlier - The bytes at the earlier position
+  * @param later - The bytes at the later position
+  * @param most - The most bytes compared (those left after the later position)
+  *
+  * @return The length of the match
+  */
+static size_t matchLength(const char *earlier, const char *later, size_t most) {
+
+	size_t length = 0;
+	while(length + 8 <= most) {
+
+		uint64_t first;
+		uint64_t second;
+		memcpy(&first, earlier + length, sizeof(first));
+		memcpy(&second, later + length, sizeof(second));
+		if(first != second) {
+
+			return length + __builtin_ctzll(first ^ second) / 8;
+		}
+		length += 8;
+	}
+	while(length < most && earlier[length] == later[length]) {
+
+		length++;
+	}
+	return length;
+}
+
+/**
+  * Compresses bytes LZ style into their length (a varint) followed by a sequence of tokens, each a run of literal bytes (its length as a
+  * varint, then the bytes) followed, unless the input ends, by a copy of earlier output (the distance
+  * back and the length, as varints). Copies are found greedily: at each position the earlier
+  * positions with the same leading bytes, the most recent first, are compared for the longest match.
+  *
+  * @param input - The bytes
+  *
+  * @return The compressed bytes
+  */
+string TransactionHistory::compress(string_view input) {
+
+	string output;
+	output.reserve(input.size() / 2 + 16);
+	appendVarint(output, input.size());
+	vector<int> heads(1 << hashBits, -1);
+	vector<int> previous(input.size(), -1);
+	size_t literalStart = 0;
+	size_t position = 0;
+	while(position + minimumMatch <= input.size()) {
+
+		uint32_t hash = hashPosition(input.data() + position);
+		size_t bestLength = 0;
+		size_t bestDistance = 0;
+		int candidate = heads[hash];
+		for(int searched = 0; candidate >= 0 && searched < matchCandidates; searched++, candidate = previous[candidate]) {
+
+			// a candidate differing at the byte after the best match's length cannot beat it
+			if(bestLength > 0 && (position + bestLength >= input.size() || input[candidate + bestLength] != input[position + bestLength])) {
+
+				continue;
+			}
+			size_t length = matchLength(input.data() + candidate, input.data() + position, input.size() - position);
+			if(length > bestLength) {
+
+				bestLength = length;
+				bestDistance = position - candidate;
+			}
+		}
+		previous[position] = heads[hash];
+		heads[hash] = position;
+		if(bestLength < minimumMatch) {
+
+			position++;
+			continue;
+		}
+		appendVarint(output, position - literalStart);
+		output.append(input.data() + literalStart, position - literalStart);
+		appendVarint(output, bestDistance);
+		appendVarint(output, bestLength);
+
+		// the positions the copy covers can start later copies
+		for(size_t end = position + bestLength, next = position + 1; next < end; next++) {
+
+			if(next + minimumMatch <= input.size()) {
+
+				uint32_t nextHash = hashPosition(input.data() + next);
+				previous[next] = heads[nextHash];
+				heads[nextHash] = next;
+			}
+		}
+		position += bestLength;
+		literalStart = position;
+	}
+	appendVarint(output, input.size() - literalStart);
+	output.append(input.data() + literalStart, input.size() - literalStart);
+	return output;
+}
+
+/**
+  * Restores bytes compressed by "compress": the bytes are sized from the length leading them, then
+  * written token by token. Tokens reaching past that length or copying from before the first byte
+  * end the bytes early.
+  *
+  * @param input - The compressed bytes
+  * @param output - The bytes restored, assigned
+  */
+void TransactionHistory::decompress(string_view input, string &output) {
+
+	size_t position = 0;
+	output.resize(readVarint(input, position));
+	char *bytes = &output[0];
+	size_t to = 0;
+	while(position < input.size()) {
+
+		size_t literals = readVarint(input, position);
+		if(literals > input.size() - position || literals > output.size() - to) {
+
+			break;
+		}
+		memcpy(bytes + to, input.data() + position, literals);
+		to += literals;
+		position += literals;
+		if(position >= input.size()) {
+
+			break;
+		}
+		size_t distance = readVarint(input, position);
+		size_t length = readVarint(input, position);
+		if(distance == 0 || distance > to || length > output.size() - to) {
+
+			break;
+		}
+
+		// a copy overlapping the bytes it writes (a run repeating) is copied byte by byte
+		if(distance >= length) {
+
+			memcpy(bytes + to, bytes + to - distance, length);
+		}
+		else {
+
+			for(size_t i = 0; i < length; i++) {
+
+				bytes[to + i] = bytes[to - distance + i];
+			}
+		}
+		to += length;
+	}
+	output.resize(to);
+}
+
+/**
+  * Adds a transaction to the recent tier, compressing the oldest recent transactions into a block
+  * once the tier holds a block's worth more than it keeps.
+  *
+  * @param transaction - The transaction
+  */
+void TransactionHistory::add(string transaction) {
+
+	recent.push_back(move(transaction));
+	if(recent.size() >= recentRecords + blockRecords) {
+
+		compressOldest();
+	}
+}
+
+/**
+  * Compresses the oldest "blockRecords" recent transactions into a block: their lengths, then their
+  * text, compressed together.
+  */
+void TransactionHistory::compressOldest() {
+
+	string block;
+	for(size_t i = 0; i < blockRecords; i++) {
+
+		appendVarint(block, recent[i].size());
+	}
+	for(size_t i = 0; i < blockRecords; i++) {
+
+		block += recent[i];
+	}
+	blocks.push_back(compress(block));
+	blocks.back().shrink_to_fit();
+	recent.erase(recent.begin(), recent.begin() + blockRecords);
+}
+
+/**
+  * Decodes a block: its bytes are restored, and its transactions found from the lengths leading them.
+  *
+  * @param index - The index of the block (0 the oldest)
+  * @param block - The bytes of the block, assigned
+  * @param positions - The position of each transaction in the bytes, followed by the end of the last, assigned
+  */
+void TransactionHistory::decodeBlock(size_t index, string &block, vector<size_t> &positions) const {
+
+	blocksDecoded++;
+	decompress(blocks[index], block);
+	size_t position = 0;
+	size_t lengths[blockRecords];
+	for(size_t i = 0; i < blockRecords; i++) {
+
+		lengths[i] = readVarint(block, position);
+	}
+	positions.assign(1, position);
+	for(size_t i = 0; i < blockRecords; i++) {
+
+		positions.push_back(min(positions.back() + lengths[i], block.size()));
+	}
+}
+
+/**
+  * Gets the heap bytes held by the history: the buffers of both tiers' vectors, the heap buffers of
+  * the recent transactions and the compressed blocks.
+  *
+  * @return The heap bytes of the history
+  */
+size_t TransactionHistory::getBytes() const {
+
+	size_t bytes = recent.capacity() * sizeof(string) + blocks.capacity() * sizeof(string);
+	for(const string &transaction : recent) {
+
+		bytes += MemoryAccounting::stringHeapBytes(transaction);
+	}
+	for(const string &block : blocks) {
+
+		bytes += MemoryAccounting::stringHeapBytes(block);
+	}
+	return bytes;
+}
@@ -0,0 +1,132 @@
+#ifndef TRANSACTIONHISTORY_H
+#define TRANSACTIONHISTORY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// the transaction history of a customer, in two tiers: the most recent transactions are kept as
+// strings, and older ones are compressed into blocks of "blockRecords" transactions once the recent
+// tier holds "recentRecords + blockRecords" of them. a block holds the lengths of its transactions
+// (varints) followed by their text, compressed LZ style: runs of literal bytes and copies of bytes
+// found earlier in the block (the same phrases and titles recur throughout a customer's history).
+// reading the history newest first decodes a block only once every transaction after it has been
+// read, so reading the newest few decodes none.
+class TransactionHistory {
+
+private:
+
+	// the transactions not yet compressed, oldest first
+	vector<string> recent;
+
+	// the compressed blocks, oldest first, each holding "blockRecords" transactions
+	vector<string> blocks;
+
+	// the blocks decoded since the program started (see "getBlocksDecoded")
+	static long long blocksDecoded;
+
+	// compresses the oldest "blockRecords" recent transactions into a block
+	void compressOldest();
+
+	// decodes a block (argument, its index) into the buffer argument, and the position each of its
+	// transactions starts at in the buffer (followed by the end of the last) into the positions argument
+	void decodeBlock(size_t, string &, vector<size_t> &) const;
+
+public:
+
+	// the transactions kept uncompressed (at least), and the transactions of a block
+	static const size_t recentRecords = 32;
+	static const size_t blockRecords = 64;
+
+	// adds a transaction, the newest
+	void add(string);
+
+	// gets the number of transactions
+	size_t size() const {
+
+		return blocks.size() * blockRecords + recent.size();
+	}
+
+	// visits (visitor argument) the newest transactions, up to the count argument, newest first;
+	// only the blocks holding them are decoded
+	template <typename Visitor>
+	void forEachNewestFirst(size_t count, Visitor visitor) const;
+
+	// visits (visitor argument) every transaction, oldest first
+	template <typename Visitor>
+	void forEachOldestFirst(Visitor visitor) const;
+
+	// gets the heap bytes held: the recent transactions and the compressed blocks
+	size_t getBytes() const;
+
+	// gets the number of compressed blocks
+	size_t getBlockCount() const {
+
+		return blocks.size();
+	}
+
+	// gets the number of blocks decoded by every history since the program started
+	static long long getBlocksDecoded() {
+
+		return blocksDecoded;
+	}
+
+	// compresses the bytes argument (LZ style, see the class) into a string, and restores them
+	static string compress(string_view);
+	static void decompress(string_view, string &);
+};
+
+/**
+ * Visits the newest transactions, newest first: the recent ones, then the blocks from the newest,
+ * each decoded only when the count is not yet reached.
+ *
+ * @param count - The most transactions visited
+ * @param visitor - Called with each transaction (a string_view, valid during the call)
+ */
+template <typename Visitor>
+void TransactionHistory::forEachNewestFirst(size_t count, Visitor visitor) const {
+
+	size_t visited = 0;
+	for(size_t i = recent.size(); i > 0 && visited < count; i--, visited++) {
+
+		visitor(string_view(recent[i - 1]));
+	}
+	string block;
+	vector<size_t> positions;
+	for(size_t b = blocks.size(); b > 0 && visited < count; b--) {
+
+		decodeBlock(b - 1, block, positions);
+		for(size_t i = positions.size() - 1; i > 0 && visited < count; i--, visited++) {
+
+			visitor(string_view(block).substr(positions[i - 1], positions[i] - positions[i - 1]));
+		}
+	}
+}
+
+/**
+ * Visits every transaction, oldest first: the blocks from the oldest, then the recent ones.
+ *
+ * @param visitor - Called with each transaction (a string_view, valid during the call)
+ */
+template <typename Visitor>
+void TransactionHistory::forEachOldestFirst(Visitor visitor) const {
+
+	string block;
+	vector<size_t> positions;
+	for(size_t b = 0; b < blocks.size(); b++) {
+
+		decodeBlock(b, block, positions);
+		for(size_t i = 0; i + 1 < positions.size(); i++) {
+
+			visitor(string_view(block).substr(positions[i], positions[i + 1] - positions[i]));
+		}
+	}
+	for(const string &transaction : recent) {
+
+		visitor(string_view(transaction));
+	}
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "Waitlists.h"
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+
+/**
+  * Adds a customer to the end of the queue of a title, allocating the queue if nobody waits for the
+  * title yet. A customer added twice is served twice.
+  *
+  * @param title - The format code and movie portion of the borrow command, e.g. "D F You've Got Mail, 1998"
+  * @param custID - The ID of the customer
+  *
+  * @return The customer's position in the queue (1 for the first)
+  */
+size_t Waitlists::enqueue(const string &title, int custID) {
+
+	Queue &queue = queues[title];
+	if(queue.count == queue.customers.size()) {
+
+		// full: copy the queue, in order, to a buffer twice as large
+		vector<int> grown(max(minimumCapacity, 2 * queue.customers.size()));
+		for(size_t i = 0; i < queue.count; i++) {
+
+			grown[i] = queue.customers[(queue.first + i) % queue.customers.size()];
+		}
+		queue.customers.swap(grown);
+		queue.first = 0;
+	}
+	queue.customers[(queue.first + queue.count) % queue.customers.size()] = custID;
+	queue.count++;
+	waiterCount++;
+	return queue.count;
+}
+
+/**
+  * Removes the first customer of the queue of a title. The queue is released once empty.
+  *
+  * @param title - The format code and movie portion of the borrow command
+  *
+  * @return The ID of the customer, -1 if nobody waits for the title
+  */
+int Waitlists::dequeue(const string &title) {
+
+	unordered_map<string, Queue>::iterator found = queues.find(title);
+	if(found == queues.end()) {
+
+		return -1;
+	}
+	Queue &queue = found->second;
+	int custID = queue.customers[queue.first];
+	queue.first = (queue.first + 1) % queue.customers.size();
+	queue.count--;
+	waiterCount--;
+	if(queue.count == 0) {
+
+		queues.erase(found);
+	}
+	return custID;
+}
+
+/**
+  * Gets the number of customers waiting for a title.
+  *
+  * @param title - The format code and movie portion of the borrow command
+  *
+  * @return The number of customers waiting
+  */
+size_t Waitlists::getWaiting(const string &title) const {
+
+	unordered_map<string, Queue>::const_iterator found = queues.find(title);
+	return found == queues.end() ? 0 : found->second.count;
+}
+
+/**
+  * Gets the number of titles customers wait for.
+  *
+  * @return The number of titles
+  */
+size_t Waitlists::getTitleCount() const {
+
+	return queues.size();
+}
+
+/**
+  * Gets the number of customers waiting, over every title.
+  *
+  * @return The number of customers
+  */
+size_t Waitlists::getWaiterCount() const {
+
+	return waiterCount;
+}
+
+/**
+  * Gets the bytes held by the queues: the hash map (nodes and buckets, approximately), the titles
+  * and the ring buffers.
+  *
+  * @return The bytes held
+  */
+size_t Waitlists::getBytes() const {
+
+	const size_t nodeOverhead = 2 * sizeof(void*);
+	size_t bytes = queues.bucket_count() * sizeof(void*);
+	for(const pair<const string, Queue> &queue : queues) {
+
+		bytes += sizeof(queue) + nodeOverhead + MemoryAccounting::stringHeapBytes(queue.first) + queue.second.customers.capacity() * sizeof(int);
+	}
+	return bytes;
+}
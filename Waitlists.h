@@ -0,0 +1,56 @@
+#ifndef WAITLISTS_H
+#define WAITLISTS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// the customers waiting for titles out of stock, first come first served. every title waited for
+// has its own queue, named by the format code and the movie portion of the borrow command (e.g.
+// "D F You've Got Mail, 1998"); a queue is allocated when its first customer waits and released once
+// its last customer is served, so titles nobody waits for cost nothing.
+class Waitlists {
+
+private:
+
+	// the customer IDs waiting for a title: a ring buffer, doubled when full, so a customer joins
+	// and leaves the queue in constant time
+	struct Queue {
+
+		vector<int> customers;
+		size_t first = 0;
+		size_t count = 0;
+	};
+
+	// the smallest capacity of a queue
+	static constexpr size_t minimumCapacity = 4;
+
+	unordered_map<string, Queue> queues;
+
+	// number of customers waiting, over every title
+	size_t waiterCount = 0;
+
+public:
+
+	// adds a customer (second argument) to the queue of a title; gets their position (1 for first)
+	size_t enqueue(const string &, int);
+
+	// removes the first customer of the queue of a title, and gets their ID (-1 if nobody waits)
+	int dequeue(const string &);
+
+	// gets the number of customers waiting for a title
+	size_t getWaiting(const string &) const;
+
+	// gets the number of titles waited for
+	size_t getTitleCount() const;
+
+	// gets the number of customers waiting, over every title
+	size_t getWaiterCount() const;
+
+	// gets the bytes held by the queues
+	size_t getBytes() const;
+};
+
+#endif
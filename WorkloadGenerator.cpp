@@ -0,0 +1,366 @@
+#include "WorkloadGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+// word lists the generated names and titles are built from
+static const vector<string> firstNames = {"Ada", "Barry", "Cary", "Diane", "Ethan", "Fiona", "Grace", "Harold", "Ingrid",
+	"Jonathan", "Katherine", "Lauren", "Malcolm", "Nora", "Orson", "Penny", "Quentin", "Ruth", "Steven", "Tilda", "Umberto",
+	"Vivien", "Walter", "Xavier", "Yvonne", "Zachary"};
+static const vector<string> lastNames = {"Allen", "Bergman", "Curtiz", "Demme", "Ephron", "Fleming", "Garland", "Hepburn",
+	"Irving", "Jarmusch", "Kubrick", "Levinson", "McDowell", "Nichols", "Olivier", "Preminger", "Quinn", "Reiner", "Savoca",
+	"Tarkovsky", "Ullmann", "Verhoeven", "Wilder", "Yates", "Zemeckis"};
+static const vector<string> titleAdjectives = {"Silent", "Crimson", "Lonely", "Last", "Hidden", "Golden", "Broken", "Wild",
+	"Quiet", "Midnight", "Lost", "Endless", "Bright", "Hollow", "Frozen", "Restless", "Secret", "Distant"};
+static const vector<string> titleNouns = {"River", "Summer", "Harbor", "Kingdom", "Garden", "Letter", "Station", "Promise",
+	"Mountain", "Stranger", "Orchard", "Highway", "Carnival", "Lighthouse", "Parade", "Weekend", "Empire", "Shadow"};
+static const vector<string> titlePlaces = {"Seattle", "Paris", "Vietnam", "Casablanca", "Tokyo", "Brooklyn", "Oz", "Rome",
+	"Havana", "Memphis", "Vienna", "Dublin", "Lisbon", "Nairobi", "Oslo", "Bombay"};
+
+/**
+  * Constructor generates the catalog and customer list for the settings argument. Files are only
+  * written by the "write" functions.
+  *
+  * @param settings - The workload settings
+  */
+WorkloadGenerator::WorkloadGenerator(WorkloadSettings settings) : settings(settings), random(settings.seed) {
+
+	generateMovies();
+	orderMovies();
+	generateCustomers();
+}
+
+/**
+  * Picks a uniformly random element of a word list.
+  *
+  * @param words - The word list
+  *
+  * @return The picked word
+  */
+const string &WorkloadGenerator::pick(const vector<string> &words) {
+
+	return words[random() % words.size()];
+}
+
+/**
+  * Generates unique movies until the catalog holds the configured number of movies. The genre of
+  * each movie is drawn from the configured genre mix; uniqueness is by the genre's sorting criteria.
+  */
+void WorkloadGenerator::generateMovies() {
+
+	discrete_distribution<int> genreDistribution({settings.comedyWeight, settings.dramaWeight, settings.classicsWeight});
+	const char genres[] = {'F', 'D', 'C'};
+	unordered_set<string> usedKeys;
+	char buffer[64];
+	while((int) movies.size() < settings.movieCount) {
+
+		GeneratedMovie movie;
+		movie.genre = genres[genreDistribution(random)];
+		movie.director = pick(firstNames) + " " + pick(lastNames);
+		movie.title = "The " + pick(titleAdjectives) + " " + pick(titleNouns);
+		if(random() % 2 == 0) {
+
+			movie.title += " of " + pick(titlePlaces);
+		}
+
+		// long catalogs need more distinct titles than the word lists combine into
+		if(movies.size() > 10000) {
+
+			movie.title += " " + to_string(random() % (settings.movieCount / 100 + 1));
+		}
+		movie.majorActor = pick(firstNames) + " " + pick(lastNames);
+		movie.releaseMonth = random() % 12 + 1;
+		if(movie.genre == 'C') {
+
+			movie.releaseYear = 1920 + random() % 50;
+			snprintf(buffer, sizeof(buffer), "%04d %02d ", movie.releaseYear, movie.releaseMonth);
+			movie.sortKey = string(buffer) + movie.majorActor;
+			movie.commandCriteria = to_string(movie.releaseMonth) + " " + to_string(movie.releaseYear) + " " + movie.majorActor;
+		}
+		else if(movie.genre == 'D') {
+
+			movie.releaseYear = 1950 + random() % 75;
+			movie.sortKey = movie.director + '\x01' + movie.title;
+			movie.commandCriteria = movie.director + ", " + movie.title + ",";
+		}
+		else {
+
+			movie.releaseYear = 1950 + random() % 75;
+			movie.sortKey = movie.title + '\x01' + to_string(movie.releaseYear);
+			movie.commandCriteria = movie.title + ", " + to_string(movie.releaseYear);
+		}
+		if(usedKeys.insert(string(1, movie.genre) + movie.sortKey).second) {
+
+			movies.push_back(movie);
+		}
+	}
+}
+
+/**
+  * Generates unique random customer IDs.
+  */
+void WorkloadGenerator::generateCustomers() {
+
+	unordered_set<int> usedIDs;
+	int range = settings.customerCount * 10 + 1000;
+	while((int) customerIDs.size() < settings.customerCount) {
+
+		int custID = 1000 + random() % range;
+		if(usedIDs.insert(custID).second) {
+
+			customerIDs.push_back(custID);
+		}
+	}
+}
+
+/**
+  * Reorders the catalog. Random ordering shuffles it; sorted and balanced ordering group the movies
+  * by genre, sort each genre by its sorting criteria, and (balanced) emit every genre median-first.
+  */
+void WorkloadGenerator::orderMovies() {
+
+	if(settings.ordering == CatalogOrdering::Random) {
+
+		shuffle(movies.begin(), movies.end(), random);
+		return;
+	}
+	vector<GeneratedMovie> ordered;
+	const char genres[] = {'F', 'D', 'C'};
+	for(char genre : genres) {
+
+		vector<GeneratedMovie> genreMovies;
+		for(size_t i = 0; i < movies.size(); i++) {
+
+			if(movies[i].genre == genre) {
+
+				genreMovies.push_back(movies[i]);
+			}
+		}
+		sort(genreMovies.begin(), genreMovies.end(), [](const GeneratedMovie &a, const GeneratedMovie &b) { return a.sortKey < b.sortKey; });
+		if(settings.ordering == CatalogOrdering::Sorted) {
+
+			ordered.insert(ordered.end(), genreMovies.begin(), genreMovies.end());
+		}
+		else {
+
+			// breadth-first over the implicit tree of medians, so every level is complete before the next
+			vector<pair<size_t, size_t>> ranges;
+			ranges.push_back(make_pair(0, genreMovies.size()));
+			for(size_t next = 0; next < ranges.size(); next++) {
+
+				size_t first = ranges[next].first;
+				size_t last = ranges[next].second;
+				if(first >= last) {
+
+					continue;
+				}
+				size_t middle = first + (last - first) / 2;
+				ordered.push_back(genreMovies[middle]);
+				ranges.push_back(make_pair(first, middle));
+				ranges.push_back(make_pair(middle + 1, last));
+			}
+		}
+	}
+	movies.swap(ordered);
+}
+
+/**
+  * Writes the catalog as a movie file (see README for the line structure of each genre).
+  *
+  * @param path - The directory of the movie file to be written
+  *
+  * @return Whether the file was written
+  */
+bool WorkloadGenerator::writeMovieFile(string path) {
+
+	ofstream writeFile(path);
+	if(!writeFile) {
+
+		return false;
+	}
+	for(size_t i = 0; i < movies.size(); i++) {
+
+		GeneratedMovie &movie = movies[i];
+		writeFile << movie.genre << ", ";
+		if(settings.formatCodes.size() > 1) {
+
+			for(size_t format = 0; format < settings.formatCodes.size(); format++) {
+
+				writeFile << (format > 0 ? " " : "") << settings.formatCodes[format] << ":" << settings.stockPerMovie;
+			}
+		}
+		else {
+
+			writeFile << settings.stockPerMovie;
+		}
+		writeFile << ", " << movie.director << ", " << movie.title << ", ";
+		if(movie.genre == 'C') {
+
+			writeFile << movie.majorActor << " " << movie.releaseMonth << " " << movie.releaseYear << "\n";
+		}
+		else {
+
+			writeFile << movie.releaseYear << "\n";
+		}
+	}
+	return (bool) writeFile;
+}
+
+/**
+  * Writes the customer list as a customer file ([Customer ID] [Last Name] [First Name] per line).
+  *
+  * @param path - The directory of the customer file to be written
+  *
+  * @return Whether the file was written
+  */
+bool WorkloadGenerator::writeCustomerFile(string path) {
+
+	ofstream writeFile(path);
+	if(!writeFile) {
+
+		return false;
+	}
+	for(size_t i = 0; i < customerIDs.size(); i++) {
+
+		writeFile << customerIDs[i] << " " << pick(lastNames) << " " << pick(firstNames) << "\n";
+	}
+	return (bool) writeFile;
+}
+
+// a rental opened by a generated borrow command and not returned yet
+struct OpenRental {
+
+	int custID;
+	size_t movieIndex;
+	char format;
+};
+
+/**
+  * Writes a command file. Borrowed titles follow a Zipfian popularity distribution over a random
+  * popularity ranking of the catalog; returns are drawn from the rentals the stream has opened so far.
+  *
+  * @param path - The directory of the command file to be written
+  *
+  * @return Whether the file was written
+  */
+bool WorkloadGenerator::writeCommandFile(string path) {
+
+	ofstream writeFile(path);
+	if(!writeFile || movies.empty() || customerIDs.empty()) {
+
+		return false;
+	}
+
+	// cumulative Zipfian weights over popularity ranks, and the movie holding each rank
+	vector<double> cumulativeWeights(movies.size());
+	double total = 0;
+	for(size_t rank = 0; rank < movies.size(); rank++) {
+
+		total += 1.0 / pow((double) (rank + 1), settings.zipfExponent);
+		cumulativeWeights[rank] = total;
+	}
+	vector<size_t> movieByRank(movies.size());
+	for(size_t i = 0; i < movieByRank.size(); i++) {
+
+		movieByRank[i] = i;
+	}
+	shuffle(movieByRank.begin(), movieByRank.end(), random);
+
+	discrete_distribution<int> commandDistribution({settings.borrowWeight, settings.returnWeight, settings.historyWeight, settings.inventoryWeight});
+	uniform_real_distribution<double> unit(0.0, total);
+	vector<OpenRental> openRentals;
+
+	// formats are drawn from a generator of their own, so the same settings with more formats only
+	// change the format codes of the command stream
+	mt19937_64 formatRandom(settings.seed);
+	for(int i = 0; i < settings.commandCount; i++) {
+
+		int command = commandDistribution(random);
+		if(command == 1 && openRentals.empty()) {
+
+			command = 0;
+		}
+		if(command == 0) {
+
+			size_t rank = lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), unit(random)) - cumulativeWeights.begin();
+			size_t movieIndex = movieByRank[min(rank, movies.size() - 1)];
+			int custID = customerIDs[random() % customerIDs.size()];
+			char format = settings.formatCodes[0];
+			if(settings.formatCodes.size() > 1) {
+
+				format = settings.formatCodes[formatRandom() % settings.formatCodes.size()];
+			}
+			writeFile << "B " << custID << " " << format << " " << movies[movieIndex].genre << " " << movies[movieIndex].commandCriteria << "\n";
+			openRentals.push_back({custID, movieIndex, format});
+		}
+		else if(command == 1) {
+
+			size_t rental = random() % openRentals.size();
+			GeneratedMovie &movie = movies[openRentals[rental].movieIndex];
+			writeFile << "R " << openRentals[rental].custID << " " << openRentals[rental].format << " " << movie.genre << " " << movie.commandCriteria << "\n";
+			openRentals[rental] = openRentals.back();
+			openRentals.pop_back();
+		}
+		else if(command == 2) {
+
+			writeFile << "H " << customerIDs[random() % customerIDs.size()] << "\n";
+		}
+		else {
+
+			writeFile << "I\n";
+		}
+	}
+	return (bool) writeFile;
+}
+
+/**
+  * Gets the generated catalog in file order.
+  *
+  * @return The generated movies
+  */
+const vector<GeneratedMovie> &WorkloadGenerator::getMovies() {
+
+	return movies;
+}
+
+/**
+  * Gets the generated customer IDs in file order.
+  *
+  * @return The generated customer IDs
+  */
+const vector<int> &WorkloadGenerator::getCustomerIDs() {
+
+	return customerIDs;
+}
+
+/**
+  * Parses the name of a catalog ordering.
+  *
+  * @param name - The ordering name: "random", "sorted" or "balanced"
+  * @param ordering - Receives the parsed ordering
+  *
+  * @return Whether the name was recognized
+  */
+bool WorkloadGenerator::parseOrdering(string name, CatalogOrdering &ordering) {
+
+	if(name == "random") {
+
+		ordering = CatalogOrdering::Random;
+	}
+	else if(name == "sorted") {
+
+		ordering = CatalogOrdering::Sorted;
+	}
+	else if(name == "balanced") {
+
+		ordering = CatalogOrdering::Balanced;
+	}
+	else {
+
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,127 @@
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the order movies are written to a generated movie file
+enum class CatalogOrdering {
+
+	// shuffled order
+	Random,
+
+	// ascending sorting criteria order within each genre (worst case for the inventory BST)
+	Sorted,
+
+	// median-first order within each genre, which fills the inventory BST level by level
+	Balanced
+};
+
+// settings of a generated store workload
+struct WorkloadSettings {
+
+	// number of movies in the catalog, customers in the customer file and lines in the command file
+	int movieCount = 1500;
+	int customerCount = 1000;
+	int commandCount = 100000;
+
+	// relative weights of the Comedy, Drama and Classics genres in the catalog
+	double comedyWeight = 0.4;
+	double dramaWeight = 0.4;
+	double classicsWeight = 0.2;
+
+	// order of the movies in the movie file
+	CatalogOrdering ordering = CatalogOrdering::Balanced;
+
+	// exponent of the Zipfian distribution of title popularity in borrow commands (0 is uniform)
+	double zipfExponent = 1.0;
+
+	// relative weights of the command types in the command file. returns are only generated
+	// for movies currently borrowed by the customer
+	double borrowWeight = 0.5;
+	double returnWeight = 0.4;
+	double historyWeight = 0.099;
+	double inventoryWeight = 0.001;
+
+	// initial stock of every movie (in every media format)
+	int stockPerMovie = 10;
+
+	// codes of the media formats carried. with more than one, the movie file lists the stock of
+	// every format and each rental is of a random format
+	string formatCodes = "D";
+
+	// random seed; the same settings and seed always generate the same files
+	unsigned int seed = 42;
+};
+
+// a generated movie, as needed to write its movie file line and its borrow/return sorting criteria
+struct GeneratedMovie {
+
+	char genre;
+	string director;
+	string title;
+	string majorActor;
+	int releaseMonth;
+	int releaseYear;
+
+	// text identifying the movie in a borrow/return command (after the genre code)
+	string commandCriteria;
+
+	// key the genre's inventory is ordered by
+	string sortKey;
+};
+
+// generates synthetic movie, customer and command files for benchmarking the store. titles are
+// drawn from word lists, popularity in the command stream follows a Zipfian distribution, and the
+// genre mix and file ordering are configurable.
+class WorkloadGenerator {
+
+private:
+
+	WorkloadSettings settings;
+	mt19937_64 random;
+
+	// the generated catalog and customer IDs, in file order
+	vector<GeneratedMovie> movies;
+	vector<int> customerIDs;
+
+	// builds a catalog of unique movies of the configured size and genre mix
+	void generateMovies();
+
+	// builds the list of unique customer IDs
+	void generateCustomers();
+
+	// reorders the catalog according to the configured ordering
+	void orderMovies();
+
+	// picks a random element of a word list
+	const string &pick(const vector<string> &);
+
+public:
+
+	// WorkloadGenerator constructor - generates the catalog and customers for the settings argument
+	WorkloadGenerator(WorkloadSettings);
+
+	// writes the movie file to the path argument
+	bool writeMovieFile(string);
+
+	// writes the customer file to the path argument
+	bool writeCustomerFile(string);
+
+	// writes the command file to the path argument
+	bool writeCommandFile(string);
+
+	// gets the generated catalog, in file order
+	const vector<GeneratedMovie> &getMovies();
+
+	// gets the generated customer IDs, in file order
+	const vector<int> &getCustomerIDs();
+
+	// parses an ordering name (random, sorted, balanced) - returns false if not recognized
+	static bool parseOrdering(string, CatalogOrdering &);
+};
+
+#endif
@@ -1 +1,5 @@
-g++ -g -o MovieRentalStore -Wall -Wextra MovieRentalStore.cpp Movie.cpp Customer.cpp
\ No newline at end of file
+g++ -O2 -g -c -Wall -Wextra -pthread MovieRentalStore.cpp StoreStatistics.cpp MemoryAccounting.cpp StringTable.cpp CatalogConfig.cpp TitleSearchIndex.cpp SecondaryIndexes.cpp Waitlists.cpp DueDates.cpp StoreClock.cpp Movie.cpp Customer.cpp StoreServer.cpp CommandStream.cpp CommandResult.cpp RecordFormat.cpp DelimiterScanner.cpp TransactionHistory.cpp DurableLog.cpp
+ar rcs libmoviestore.a MovieRentalStore.o StoreStatistics.o MemoryAccounting.o StringTable.o CatalogConfig.o TitleSearchIndex.o SecondaryIndexes.o Waitlists.o DueDates.o StoreClock.o Movie.o Customer.o StoreServer.o CommandStream.o CommandResult.o RecordFormat.o DelimiterScanner.o TransactionHistory.o DurableLog.o
+g++ -g -o MovieRentalStore -Wall -Wextra -pthread MovieRentalStoreMain.cpp libmoviestore.a
+g++ -O2 -o LoadGenerator -Wall -Wextra LoadGenerator.cpp
+g++ -O2 -o StoreBenchmark -Wall -Wextra -pthread StoreBenchmark.cpp WorkloadGenerator.cpp libmoviestore.a